@@ -42,6 +42,7 @@ BuildRequires:	pkgconfig(zlib)
 Recommends:     texlive-scheme-basic
 Recommends:     texlive-dvipng
 Recommends:     texlive-standalone
+Recommends:     qpdf
 Requires:       hicolor-icon-theme
 Requires:       %{name}-plugins = %{version}-%{release}
 Requires:       %{name}-ui = %{version}-%{release}
@@ -0,0 +1,311 @@
+#include "BatchConverter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <system_error>
+#include <thread>
+
+#include <gio/gio.h>
+
+#include "control/jobs/ImageExport.h"
+#include "control/jobs/ProgressListener.h"
+#include "control/xojfile/LoadHandler.h"
+#include "pdf/base/XojPdfExport.h"
+#include "pdf/base/XojPdfExportFactory.h"
+#include "util/PageRange.h"
+#include "util/i18n.h"
+#include "util/serdesstream.h"
+
+namespace {
+auto isDocument(const fs::path& file) -> bool { return file.extension() == ".xopp" || file.extension() == ".xoj"; }
+
+auto defaultOutput(const fs::path& input) -> fs::path {
+    fs::path output = input;
+    output.replace_extension(".pdf");
+    return output;
+}
+}  // namespace
+
+auto BatchConverter::formatResult(const Result& result) -> std::string {
+    std::string error = result.error;
+    std::replace_if(
+            error.begin(), error.end(), [](char c) { return c == '\n' || c == '\r'; }, ' ');
+    return std::to_string(result.pages) + "\t" + std::to_string(result.time.count()) + "\t" + error;
+}
+
+auto BatchConverter::parseResult(const std::string& line, Result& result) -> bool {
+    auto fields = serdes_stream<std::istringstream>(line);
+    long long time = 0;
+    if (!(fields >> result.pages >> time) || fields.get() != '\t') {
+        return false;
+    }
+    result.time = std::chrono::milliseconds(time);
+    std::getline(fields, result.error);
+    return true;
+}
+
+BatchConverter::BatchConverter(Options options): options(options) {}
+
+auto BatchConverter::addSource(const fs::path& source) -> bool {
+    std::error_code ec;
+    if (fs::is_directory(source, ec)) {
+        std::vector<fs::path> inputs;
+        for (const auto& entry: fs::directory_iterator(source, ec)) {
+            if (entry.is_regular_file(ec) && isDocument(entry.path())) {
+                inputs.push_back(entry.path());
+            }
+        }
+        std::sort(inputs.begin(), inputs.end());
+        for (const fs::path& input: inputs) { this->files.emplace_back(input, defaultOutput(input)); }
+        return !ec;
+    }
+
+    std::ifstream manifest(source);
+    if (!manifest) {
+        return false;
+    }
+
+    fs::path base = source.parent_path();
+    std::string line;
+    while (std::getline(manifest, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        auto tab = line.find('\t');
+        fs::path input = base / fs::u8path(line.substr(0, tab));
+        fs::path output = tab == std::string::npos ? defaultOutput(input) : base / fs::u8path(line.substr(tab + 1));
+        this->files.emplace_back(input, output);
+    }
+    return true;
+}
+
+auto BatchConverter::getFiles() const -> const std::vector<std::pair<fs::path, fs::path>>& { return this->files; }
+
+auto BatchConverter::convert(const fs::path& input, const fs::path& output) const -> Result {
+    auto start = std::chrono::steady_clock::now();
+    Result result;
+
+    // The document is released together with the loader as soon as it is exported
+    LoadHandler loader;
+    Document* doc = loader.loadDocument(input);
+    if (doc == nullptr) {
+        result.error = loader.getLastError();
+        return result;
+    }
+    result.pages = doc->getPageCount();
+
+    if (output.extension() == ".png" || output.extension() == ".svg") {
+        ExportGraphicsFormat format = output.extension() == ".svg" ? EXPORT_GRAPHICS_SVG : EXPORT_GRAPHICS_PNG;
+        PageRangeVector exportRange;
+        exportRange.push_back(new PageRangeEntry(0, static_cast<int>(result.pages) - 1));
+
+        ImageExport imgExport(doc, output, format, this->options.exportBackground, exportRange);
+        if (format == EXPORT_GRAPHICS_PNG) {
+            if (this->options.pngDpi > 0) {
+                imgExport.setQualityParameter(EXPORT_QUALITY_DPI, this->options.pngDpi);
+            } else if (this->options.pngWidth > 0) {
+                imgExport.setQualityParameter(EXPORT_QUALITY_WIDTH, this->options.pngWidth);
+            } else if (this->options.pngHeight > 0) {
+                imgExport.setQualityParameter(EXPORT_QUALITY_HEIGHT, this->options.pngHeight);
+            }
+        }
+
+        DummyProgressListener progress;
+        imgExport.exportGraphics(&progress);
+
+        for (PageRangeEntry* e: exportRange) { delete e; }
+        result.error = imgExport.getLastErrorMsg();
+    } else {
+        std::unique_ptr<XojPdfExport> pdfe(XojPdfExportFactory::createExport(doc, nullptr));
+        pdfe->setExportBackground(this->options.exportBackground);
+        pdfe->setReuseBackgroundPdf(this->options.reuseBackgroundPdf);
+
+        if (!pdfe->createPdf(output, this->options.progressiveMode)) {
+            result.error = pdfe->getLastError();
+            if (result.error.empty()) {
+                result.error = _("Unknown error");
+            }
+        }
+    }
+
+    result.time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    return result;
+}
+
+auto BatchConverter::getWorkerCommand(const fs::path& manifest, const fs::path& resultFile) const
+        -> std::vector<std::string> {
+    std::vector<std::string> command = {this->options.executable.u8string(), "--export-batch=" + manifest.u8string(),
+                                        "--export-batch-worker=" + resultFile.u8string()};
+    if (this->options.exportBackground == EXPORT_BACKGROUND_NONE) {
+        command.emplace_back("--export-no-background");
+    } else if (this->options.exportBackground == EXPORT_BACKGROUND_UNRULED) {
+        command.emplace_back("--export-no-ruling");
+    }
+    if (this->options.progressiveMode) {
+        command.emplace_back("--export-layers-progressively");
+    }
+    if (this->options.reuseBackgroundPdf) {
+        command.emplace_back("--export-reuse-background-pdf");
+    }
+    if (this->options.pngDpi > 0) {
+        command.push_back("--export-png-dpi=" + std::to_string(this->options.pngDpi));
+    }
+    if (this->options.pngWidth > 0) {
+        command.push_back("--export-png-width=" + std::to_string(this->options.pngWidth));
+    }
+    if (this->options.pngHeight > 0) {
+        command.push_back("--export-png-height=" + std::to_string(this->options.pngHeight));
+    }
+    return command;
+}
+
+void BatchConverter::runWorker(size_t first, size_t step, const fs::path& folder,
+                               const std::function<void(size_t, const Result&)>& report) const {
+    std::vector<size_t> indices;
+    fs::path manifest = folder / ("worker-" + std::to_string(first) + ".txt");
+    fs::path resultFile = folder / ("worker-" + std::to_string(first) + "-results.txt");
+    {
+        std::ofstream out(manifest);
+        for (size_t i = first; i < this->files.size(); i += step) {
+            indices.push_back(i);
+            out << fs::absolute(this->files[i].first).u8string() << "\t"
+                << fs::absolute(this->files[i].second).u8string() << "\n";
+        }
+    }
+
+    std::vector<std::string> command = getWorkerCommand(manifest, resultFile);
+    std::vector<const gchar*> argv;
+    for (const std::string& arg: command) { argv.push_back(arg.c_str()); }
+    argv.push_back(nullptr);
+
+    std::string workerError;
+    size_t done = 0;
+
+    GError* error = nullptr;
+    // The output of the worker is passed through, so messages of the export are shown
+    GSubprocess* proc = g_subprocess_newv(argv.data(), G_SUBPROCESS_FLAGS_NONE, &error);
+    if (proc == nullptr) {
+        workerError = FS(_F("Could not start the worker process: {1}") % error->message);
+        g_error_free(error);
+    } else {
+        g_subprocess_wait(proc, nullptr, nullptr);
+        g_object_unref(proc);
+
+        // The results of the documents exported before a crash are written anyway
+        std::ifstream in(resultFile);
+        std::string line;
+        while (done < indices.size() && std::getline(in, line)) {
+            Result result;
+            if (parseResult(line, result)) {
+                report(indices[done++], result);
+            }
+        }
+
+        if (done < indices.size()) {
+            workerError = _("The worker process exited unexpectedly");
+        }
+    }
+
+    Result failed;
+    failed.error = workerError;
+    for (; done < indices.size(); done++) { report(indices[done], failed); }
+}
+
+auto BatchConverter::run() -> size_t {
+    size_t workers = this->options.jobs > 0 ? static_cast<size_t>(this->options.jobs) :
+                                              std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    workers = std::min(workers, std::max<size_t>(this->files.size(), 1));
+    bool worker = !this->options.resultFile.empty();
+    if (worker || this->options.executable.empty()) {
+        workers = 1;
+    }
+
+    std::ofstream results;
+    if (worker) {
+        results.open(this->options.resultFile);
+        if (!results) {
+            std::cerr << FS(_F("Could not write the results to {1}") % this->options.resultFile.u8string())
+                      << std::endl;
+            return this->files.size();
+        }
+    }
+
+    size_t failed = 0;
+    size_t totalPages = 0;
+    std::mutex outputMutex;
+
+    auto report = [&](size_t i, const Result& result) {
+        const auto& [input, output] = this->files[i];
+
+        std::lock_guard lock(outputMutex);
+        if (!result.error.empty()) {
+            failed++;
+        }
+        totalPages += result.pages;
+
+        if (worker) {
+            // Flushed for every document, so the results are kept if a later document crashes the worker
+            results << formatResult(result) << std::endl;
+        } else if (result.error.empty()) {
+            std::chrono::duration<double> elapsed = result.time;
+            std::cout << "OK     " << input.u8string() << " -> " << output.u8string() << " (" << result.pages << " "
+                      << _("pages") << ", " << elapsed.count() << " s)" << std::endl;
+        } else {
+            std::cerr << "FAILED " << input.u8string() << ": " << result.error << std::endl;
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+
+    if (workers == 1) {
+        for (size_t i = 0; i < this->files.size(); i++) {
+            report(i, convert(this->files[i].first, this->files[i].second));
+        }
+    } else {
+        GError* error = nullptr;
+        gchar* tmp = g_dir_make_tmp("xournalpp-batch-XXXXXX", &error);
+        if (tmp == nullptr) {
+            std::cerr << FS(_F("Could not create a temporary folder: {1}") % error->message) << std::endl;
+            g_error_free(error);
+            return this->files.size();
+        }
+        fs::path folder = fs::u8path(tmp);
+        g_free(tmp);
+
+        // The threads only wait for the worker processes and report their results
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < workers; i++) {
+            threads.emplace_back([this, i, workers, &folder, &report]() { runWorker(i, workers, folder, report); });
+        }
+        for (std::thread& t: threads) { t.join(); }
+
+        std::error_code ec;
+        fs::remove_all(folder, ec);
+    }
+
+    if (worker) {
+        return failed;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double seconds = std::max(elapsed.count(), 1e-9);
+
+    std::cout << FS(_F("{1} of {2} documents exported, {3} failed, {4} pages") % (this->files.size() - failed) %
+                    this->files.size() % failed % totalPages)
+              << std::endl;
+    std::cout << FS(_F("{1} s with {2} workers: {3} documents/s, {4} pages/s") %
+                    std::to_string(elapsed.count()) % workers % std::to_string(this->files.size() / seconds) %
+                    std::to_string(totalPages / seconds))
+              << std::endl;
+
+    return failed;
+}
@@ -0,0 +1,123 @@
+/*
+ * Xournal++
+ *
+ * Converts many documents in one process
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "control/jobs/BaseExportJob.h"
+
+#include "filesystem.h"
+
+/**
+ * Exports a list of documents to PDF or image files. The documents are loaded, exported and released one after another
+ * by a pool of worker processes, so the startup of the application is only paid once per worker. Processes are used
+ * instead of threads, as loading and exporting documents is not thread safe.
+ *
+ * The list is read from a manifest file with one document per line ("input" or "input<TAB>output", relative paths are
+ * relative to the manifest, lines starting with '#' are ignored), or all .xopp and .xoj files of a directory are
+ * exported. Without an output, a PDF with the name of the document is written next to it. The format of the output
+ * is chosen by its extension (.pdf, .png or .svg).
+ */
+class BatchConverter {
+public:
+    struct Options {
+        ExportBackgroundType exportBackground = EXPORT_BACKGROUND_ALL;
+        bool progressiveMode = false;
+        bool reuseBackgroundPdf = false;
+        int pngDpi = -1;
+        int pngWidth = -1;
+        int pngHeight = -1;
+
+        /**
+         * Number of worker processes, 0 for one per processor
+         */
+        int jobs = 0;
+
+        /**
+         * The application, which is started for every worker process. Without it, all documents are exported by the
+         * current process.
+         */
+        fs::path executable;
+
+        /**
+         * Set for a worker process: export all documents in the current process and write a result line per document
+         * to this file, which is read by the process which started the worker. The results are not written to stdout,
+         * where the export itself may print messages.
+         */
+        fs::path resultFile;
+    };
+
+    BatchConverter(Options options);
+
+public:
+    /**
+     * Reads the documents to export
+     *
+     * @param source A manifest file or a directory
+     * @return false if the source cannot be read
+     */
+    bool addSource(const fs::path& source);
+
+    const std::vector<std::pair<fs::path, fs::path>>& getFiles() const;
+
+    /**
+     * Exports all documents, reports every file and the overall throughput to stdout
+     *
+     * @return The number of documents which could not be exported
+     */
+    size_t run();
+
+private:
+    struct Result {
+        size_t pages = 0;
+        std::chrono::milliseconds time{0};
+
+        /**
+         * The error message, empty on success
+         */
+        std::string error;
+    };
+
+    Result convert(const fs::path& input, const fs::path& output) const;
+
+    /**
+     * A result line of a worker: "<pages>\t<milliseconds>\t<error>"
+     */
+    static std::string formatResult(const Result& result);
+    static bool parseResult(const std::string& line, Result& result);
+
+    /**
+     * Exports the documents with the indices `first`, `first + step`, ... in a worker process
+     *
+     * @param folder Folder for the manifest and the result file of the worker
+     * @param report Called with the index and the result of every document
+     */
+    void runWorker(size_t first, size_t step, const fs::path& folder,
+                   const std::function<void(size_t, const Result&)>& report) const;
+
+    /**
+     * @return The command line of a worker process which exports the documents listed in `manifest`
+     */
+    std::vector<std::string> getWorkerCommand(const fs::path& manifest, const fs::path& resultFile) const;
+
+private:
+    Options options;
+
+    /**
+     * Input and output of every document
+     */
+    std::vector<std::pair<fs::path, fs::path>> files;
+};
@@ -1,5 +1,6 @@
 #include "ClipboardHandler.h"
 
+#include <memory>
 #include <set>
 #include <utility>
 
@@ -12,6 +13,7 @@
 #include "util/serializing/ObjectInputStream.h"
 #include "util/serializing/ObjectOutputStream.h"
 #include "view/DocumentView.h"
+#include "view/ElementContainer.h"
 
 #include "Control.h"
 
@@ -72,21 +74,42 @@ auto ElementCompareFunc(Element* a, Element* b) -> bool {
 static GdkAtom atomSvg1 = gdk_atom_intern_static_string("image/svg");
 static GdkAtom atomSvg2 = gdk_atom_intern_static_string("image/svg+xml");
 
-// The contents of the clipboard
-class ClipboardContents {
-public:
-    ClipboardContents(string text, GdkPixbuf* image, string svg, GString* str) {
-        this->text = std::move(text);
-        this->image = image;
-        this->svg = std::move(svg);
-        this->str = str;
-    }
+static auto svgWriteFunction(GString* string, const unsigned char* data, unsigned int length) -> cairo_status_t {
+    g_string_append_len(string, reinterpret_cast<const gchar*>(data), length);
+    return CAIRO_STATUS_SUCCESS;
+}
 
-    ~ClipboardContents() {
-        g_object_unref(this->image);
-        g_string_free(this->str, true);
+/**
+ * The contents of the clipboard
+ *
+ * Only the text and the bounds of the selection are created on copy, together with a copy of the selected elements.
+ * The native format and the images are created from this copy when a consumer requests them, and then kept for
+ * further requests.
+ */
+class ClipboardContents: public ElementContainer {
+public:
+    /**
+     * @param out The native format, with everything but the elements
+     */
+    ClipboardContents(string text, std::unique_ptr<ObjectOutputStream> out, std::vector<Element*> elements, double x,
+                      double y, double width, double height):
+            text(std::move(text)),
+            out(std::move(out)),
+            elements(std::move(elements)),
+            x(x),
+            y(y),
+            width(width),
+            height(height) {}
+
+    ~ClipboardContents() override {
+        for (Element* e: this->elements) { delete e; }
+        if (this->image) {
+            g_object_unref(this->image);
+        }
+        g_string_free(this->out ? this->out->getStr() : this->str, true);
     }
 
+    auto getElements() -> std::vector<Element*>* override { return &this->elements; }
 
     static void getFunction(GtkClipboard* clipboard, GtkSelectionData* selection, guint info,
                             ClipboardContents* contents) {
@@ -97,30 +120,110 @@ public:
         } else if (target == gdk_atom_intern_static_string("image/png") ||
                    target == gdk_atom_intern_static_string("image/jpeg") ||
                    target == gdk_atom_intern_static_string("image/gif")) {
-            gtk_selection_data_set_pixbuf(selection, contents->image);
+            gtk_selection_data_set_pixbuf(selection, contents->getImage());
         } else if (atomSvg1 == target || atomSvg2 == target) {
-            gtk_selection_data_set(selection, target, 8, reinterpret_cast<guchar const*>(contents->svg.c_str()),
-                                   static_cast<gint>(contents->svg.length()));
+            const string& svg = contents->getSvg();
+            gtk_selection_data_set(selection, target, 8, reinterpret_cast<guchar const*>(svg.c_str()),
+                                   static_cast<gint>(svg.length()));
         } else if (atomXournal == target) {
-            gtk_selection_data_set(selection, target, 8, reinterpret_cast<guchar*>(contents->str->str),
-                                   static_cast<gint>(contents->str->len));
+            GString* str = contents->getNative();
+            gtk_selection_data_set(selection, target, 8, reinterpret_cast<guchar*>(str->str),
+                                   static_cast<gint>(str->len));
         }
     }
 
     static void clearFunction(GtkClipboard* clipboard, ClipboardContents* contents) { delete contents; }
 
+private:
+    /**
+     * @return The native format, completed on the first request
+     */
+    auto getNative() -> GString* {
+        if (this->out) {
+            EditSelection::serializeElements(*this->out, this->elements);
+            this->str = this->out->getStr();
+            this->out.reset();
+        }
+        return this->str;
+    }
+
+    /**
+     * @return The PNG image (300 DPI), rendered on the first request
+     */
+    auto getImage() -> GdkPixbuf* {
+        if (this->image) {
+            return this->image;
+        }
+
+        DocumentView view;
+        double dpiFactor = 1.0 / Util::DPI_NORMALIZATION_FACTOR * 300.0;
+
+        int imgWidth = static_cast<int>(this->width * dpiFactor);
+        int imgHeight = static_cast<int>(this->height * dpiFactor);
+        cairo_surface_t* surfacePng = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, imgWidth, imgHeight);
+        cairo_t* crPng = cairo_create(surfacePng);
+        cairo_scale(crPng, dpiFactor, dpiFactor);
+
+        cairo_translate(crPng, -this->x, -this->y);
+        view.drawSelection(crPng, this);
+
+        cairo_destroy(crPng);
+
+        this->image = xoj_pixbuf_get_from_surface(surfacePng, 0, 0, imgWidth, imgHeight);
+
+        cairo_surface_destroy(surfacePng);
+        return this->image;
+    }
+
+    /**
+     * @return The SVG image, rendered on the first request
+     */
+    auto getSvg() -> const string& {
+        if (this->svgRendered) {
+            return this->svg;
+        }
+
+        DocumentView view;
+        GString* svgString = g_string_new(nullptr);
+
+        cairo_surface_t* surfaceSVG = cairo_svg_surface_create_for_stream(
+                reinterpret_cast<cairo_write_func_t>(svgWriteFunction), svgString, this->width, this->height);
+        cairo_t* crSVG = cairo_create(surfaceSVG);
+
+        view.drawSelection(crSVG, this);
+
+        cairo_surface_destroy(surfaceSVG);
+        cairo_destroy(crSVG);
+
+        this->svg.assign(svgString->str, svgString->len);
+        this->svgRendered = true;
+        g_string_free(svgString, true);
+        return this->svg;
+    }
+
 private:
     string text;
-    GdkPixbuf* image;
+
+    /**
+     * The native format while its elements are not written yet, then `str`
+     */
+    std::unique_ptr<ObjectOutputStream> out;
+    GString* str = nullptr;
+
+    /**
+     * Copy of the selected elements, for rendering the images
+     */
+    std::vector<Element*> elements;
+    double x;
+    double y;
+    double width;
+    double height;
+
+    GdkPixbuf* image = nullptr;
     string svg;
-    GString* str;
+    bool svgRendered = false;
 };
 
-static auto svgWriteFunction(GString* string, const unsigned char* data, unsigned int length) -> cairo_status_t {
-    g_string_append_len(string, reinterpret_cast<const gchar*>(data), length);
-    return CAIRO_STATUS_SUCCESS;
-}
-
 auto ClipboardHandler::copy() -> bool {
     if (!this->selection) {
         return false;
@@ -130,11 +233,12 @@ auto ClipboardHandler::copy() -> bool {
     // prepare xournal contents
     /////////////////////////////////////////////////////////////////
 
-    ObjectOutputStream out(new BinObjectEncoding());
+    // The elements are written from their copy when the native format is requested
+    auto out = std::make_unique<ObjectOutputStream>(new BinObjectEncoding());
 
-    out.writeString(PROJECT_STRING);
+    out->writeString(PROJECT_STRING);
 
-    this->selection->serialize(out);
+    this->selection->serializeBounds(*out);
 
     /////////////////////////////////////////////////////////////////
     // prepare text contents
@@ -157,43 +261,12 @@ auto ClipboardHandler::copy() -> bool {
     }
 
     /////////////////////////////////////////////////////////////////
-    // prepare image contents: PNG
-    /////////////////////////////////////////////////////////////////
-
-    DocumentView view;
-
-    double dpiFactor = 1.0 / Util::DPI_NORMALIZATION_FACTOR * 300.0;
-
-    int width = static_cast<int>(selection->getWidth() * dpiFactor);
-    int height = static_cast<int>(selection->getHeight() * dpiFactor);
-    cairo_surface_t* surfacePng = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
-    cairo_t* crPng = cairo_create(surfacePng);
-    cairo_scale(crPng, dpiFactor, dpiFactor);
-
-    cairo_translate(crPng, -selection->getXOnView(), -selection->getYOnView());
-    view.drawSelection(crPng, this->selection);
-
-    cairo_destroy(crPng);
-
-    GdkPixbuf* image = xoj_pixbuf_get_from_surface(surfacePng, 0, 0, width, height);
-
-    cairo_surface_destroy(surfacePng);
-
-    /////////////////////////////////////////////////////////////////
-    // prepare image contents: SVG
+    // native and image contents: created when requested, from a copy of the elements
     /////////////////////////////////////////////////////////////////
 
-    GString* svgString = g_string_sized_new(1048576);  // 1MB
-
-    cairo_surface_t* surfaceSVG =
-            cairo_svg_surface_create_for_stream(reinterpret_cast<cairo_write_func_t>(svgWriteFunction), svgString,
-                                                selection->getWidth(), selection->getHeight());
-    cairo_t* crSVG = cairo_create(surfaceSVG);
-
-    view.drawSelection(crSVG, this->selection);
-
-    cairo_surface_destroy(surfaceSVG);
-    cairo_destroy(crSVG);
+    std::vector<Element*> elements;
+    elements.reserve(this->selection->getElements()->size());
+    for (Element* e: *this->selection->getElements()) { elements.push_back(e->clone()); }
 
     /////////////////////////////////////////////////////////////////
     // copy to clipboard
@@ -215,7 +288,9 @@ auto ClipboardHandler::copy() -> bool {
 
     targets = gtk_target_table_new_from_list(list, &n_targets);
 
-    auto* contents = new ClipboardContents(text, image, svgString->str, out.getStr());
+    auto* contents =
+            new ClipboardContents(std::move(text), std::move(out), std::move(elements), selection->getXOnView(),
+                                  selection->getYOnView(), selection->getWidth(), selection->getHeight());
 
     gtk_clipboard_set_with_data(this->clipboard, targets, static_cast<guint>(n_targets),
                                 reinterpret_cast<GtkClipboardGetFunc>(ClipboardContents::getFunction),
@@ -225,8 +300,6 @@ auto ClipboardHandler::copy() -> bool {
     gtk_target_table_free(targets, n_targets);
     gtk_target_list_unref(list);
 
-    g_string_free(svgString, true);
-
     return true;
 }
 
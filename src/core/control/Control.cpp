@@ -36,6 +36,7 @@
 #include "undo/InsertDeletePageUndoAction.h"
 #include "undo/InsertUndoAction.h"
 #include "util/PathUtil.h"
+#include "util/RasterCache.h"
 #include "util/Stacktrace.h"
 #include "util/StringUtils.h"
 #include "util/Util.h"
@@ -78,6 +79,7 @@ Control::Control(GApplication* gtkApp, GladeSearchpath* gladeSearchPath): gtkApp
     this->applyPreferredLanguage();
 
     TextView::setDpi(settings->getDisplayDpi());
+    RasterBudget::getInstance().setMemoryLimit(static_cast<size_t>(settings->getRasterCacheSize()) * 1024 * 1024);
 
     this->pageTypes = new PageTypeHandler(gladeSearchPath);
     this->newPageType = std::make_unique<PageTypeMenu>(this->pageTypes, settings, true, true);
@@ -2113,7 +2115,7 @@ void Control::fileLoaded(int scrollToPage) {
     this->doc->unlock();
 
     if (!filepath.empty()) {
-        MetadataEntry md = MetadataManager::getForFile(filepath);
+        MetadataEntry md = this->metadata->getForFile(filepath);
         if (!md.valid) {
             md.zoom = -1;
             md.page = 0;
@@ -2202,7 +2204,7 @@ auto Control::annotatePdf(fs::path filepath, bool /*attachPdf*/, bool attachToDo
         this->doc->lock();
         auto filepath = this->doc->getEvMetadataFilename();
         this->doc->unlock();
-        MetadataEntry md = MetadataManager::getForFile(filepath);
+        MetadataEntry md = this->metadata->getForFile(filepath);
         loadMetadata(md);
     } else {
         this->doc->lock();
@@ -2242,6 +2244,7 @@ void Control::block(const string& name) {
     this->pgState = GTK_PROGRESS_BAR(this->win->get("pgState"));
 
     gtk_label_set_text(this->lbState, name.c_str());
+    gtk_progress_bar_set_show_text(this->pgState, false);
     gtk_widget_show(this->statusbar);
 
     this->maxState = 100;
@@ -2268,6 +2271,13 @@ void Control::setCurrentState(int state) {
     Util::execInUiThread([=]() { gtk_progress_bar_set_fraction(this->pgState, gdouble(state) / this->maxState); });
 }
 
+void Control::setStatusText(const string& text) {
+    Util::execInUiThread([=]() {
+        gtk_progress_bar_set_text(this->pgState, text.c_str());
+        gtk_progress_bar_set_show_text(this->pgState, true);
+    });
+}
+
 auto Control::save(bool synchron) -> bool {
     // clear selection before saving
     clearSelectionEndText();
@@ -2442,6 +2452,7 @@ void Control::quit(bool allowCancel) {
     this->scheduler->stop();  // Finish current task. Must be called to finish pending saves.
     this->closeDocument();    // Must be done after all jobs has finished (Segfault on save/export)
     settings->save();
+    settings->flush();
     g_application_quit(G_APPLICATION(gtkApp));
 }
 
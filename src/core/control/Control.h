@@ -273,6 +273,7 @@ public:
     // ProgressListener interface
     void setMaximumState(int max);
     void setCurrentState(int state);
+    void setStatusText(const std::string& text) override;
 
 public:
     // ClipboardListener interface
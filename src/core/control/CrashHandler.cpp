@@ -31,6 +31,8 @@ void emergencySave() {
     auto const& filepath = Util::getConfigFile("emergencysave.xopp");
 
     SaveHandler handler;
+    // Do not start threads in the crash handler
+    handler.setCompression(Z_DEFAULT_COMPRESSION, 1);
     handler.prepareSave(document);
     handler.saveTo(filepath);
 
@@ -22,20 +22,24 @@
 
 using std::string;
 
+/**
+ * Delay between the last change of the formula and the start of the preview compilation
+ */
+constexpr guint PREVIEW_DELAY_MS = 300;
+
 LatexController::LatexController(Control* control):
         control(control),
         settings(control->getSettings()->latexSettings),
         dlg(control->getGladeSearchPath()),
         doc(control->getDocument()),
         texTmpDir(Util::getTmpDirSubfolder("tex")),
-        generator(settings) {
+        compiler(settings, texTmpDir) {
     Util::ensureFolderExists(this->texTmpDir);
 }
 
 LatexController::~LatexController() {
-    if (updating_cancellable) {
-        g_cancellable_cancel(updating_cancellable);
-        g_object_unref(updating_cancellable);
+    if (this->previewTimeout) {
+        g_source_remove(this->previewTimeout);
     }
 
     this->control = nullptr;
@@ -144,22 +148,21 @@ auto LatexController::showTexEditDialog() -> string {
     return result;
 }
 
+auto LatexController::instantiateTemplate(const string& texString) -> string {
+    return LatexGenerator::templateSub(texString, this->latexTemplate,
+                                       this->control->getToolHandler()->getTool(TOOL_TEXT).getColor());
+}
+
 void LatexController::triggerImageUpdate(const string& texString) {
-    if (this->isUpdating()) {
+    if (this->updating) {
         return;
     }
 
     this->lastPreviewedTex = texString;
-    const std::string texContents = LatexGenerator::templateSub(
-            texString, this->latexTemplate, this->control->getToolHandler()->getTool(TOOL_TEXT).getColor());
-    auto result = generator.asyncRun(this->texTmpDir, texContents);
-    if (auto* err = std::get_if<LatexGenerator::GenError>(&result)) {
-        XojMsgBox::showErrorToUser(this->control->getGtkWindow(), err->message);
-    } else if (auto** proc = std::get_if<GSubprocess*>(&result)) {
-        updating_cancellable = g_cancellable_new();
-        g_subprocess_wait_check_async(*proc, updating_cancellable,
-                                      reinterpret_cast<GAsyncReadyCallback>(onPdfRenderComplete), this);
-    }
+    this->updating = true;
+    // The callback is called immediately if the formula is cached
+    this->compiler.compile(instantiateTemplate(texString),
+                           [this](const LatexCompiler::Result& result) { onPdfRenderComplete(result); });
 
     updateStatus();
 }
@@ -173,52 +176,53 @@ void LatexController::triggerImageUpdate(const string& texString) {
  * text asynchronously.
  */
 void LatexController::handleTexChanged(GtkTextBuffer* buffer, LatexController* self) {
-    self->triggerImageUpdate(self->dlg.getBufferContents());
-}
+    if (self->previewTimeout) {
+        g_source_remove(self->previewTimeout);
+        self->previewTimeout = 0;
+    }
+
+    const string currentTex = self->dlg.getBufferContents();
+    if (!self->updating && self->compiler.isCached(self->instantiateTemplate(currentTex))) {
+        self->triggerImageUpdate(currentTex);
+        return;
+    }
 
-void LatexController::onPdfRenderComplete(GObject* procObj, GAsyncResult* res, LatexController* self) {
-    GError* err = nullptr;
-    GSubprocess* proc = G_SUBPROCESS(procObj);
-    g_subprocess_wait_check_finish(proc, res, &err);
+    // Do not start a LaTeX run for every key stroke
+    self->previewTimeout = g_timeout_add(
+            PREVIEW_DELAY_MS,
+            [](gpointer data) -> gboolean {
+                auto* self = static_cast<LatexController*>(data);
+                self->previewTimeout = 0;
+                self->triggerImageUpdate(self->dlg.getBufferContents());
+                return G_SOURCE_REMOVE;
+            },
+            self);
+    self->updateStatus();
+}
 
-    if (err != nullptr) {
-        if (g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
-            // the render was canceled
-            g_error_free(err);
-            return;
-        } else if (!g_error_matches(err, G_SPAWN_EXIT_ERROR, 1)) {
-            // The error was not caused by invalid LaTeX.
-            string message =
-                    FS(_F("Latex generation encountered an error: {1} (exit code: {2})") % err->message % err->code);
-            g_warning("latex: %s", message.c_str());
-            XojMsgBox::showErrorToUser(self->control->getGtkWindow(), message);
-        }
-        self->isValidTex = false;
-        fs::path pdfPath = self->texTmpDir / "tex.pdf";
-        fs::remove(pdfPath);
-        g_error_free(err);
+void LatexController::onPdfRenderComplete(const LatexCompiler::Result& result) {
+    if (result.status == LatexCompiler::Status::Failed) {
+        XojMsgBox::showErrorToUser(this->control->getGtkWindow(), result.message);
     }
 
-    const string currentTex = self->dlg.getBufferContents();
-    bool shouldUpdate = self->lastPreviewedTex != currentTex;
-    if (err == nullptr) {
-        self->isValidTex = true;
-        self->temporaryRender = self->loadRendered(currentTex);
-        if (self->temporaryRender != nullptr) {
-            self->dlg.setTempRender(self->temporaryRender->getPdf());
+    this->isValidTex = result.status == LatexCompiler::Status::Ok;
+    if (this->isValidTex) {
+        this->temporaryRender = this->loadRendered(this->lastPreviewedTex, result.pdf);
+        if (this->temporaryRender != nullptr) {
+            this->dlg.setTempRender(this->temporaryRender->getPdf());
         }
     }
 
-    g_clear_object(&self->updating_cancellable);
-    g_clear_object(&proc);
+    this->updating = false;
+    this->updateStatus();
 
-    self->updateStatus();
-    if (shouldUpdate) {
-        self->triggerImageUpdate(currentTex);
+    const string currentTex = this->dlg.getBufferContents();
+    if (this->lastPreviewedTex != currentTex && !this->previewTimeout) {
+        this->triggerImageUpdate(currentTex);
     }
 }
 
-bool LatexController::isUpdating() { return updating_cancellable; }
+bool LatexController::isUpdating() { return this->updating || this->previewTimeout; }
 
 void LatexController::updateStatus() {
     GtkWidget* okButton = this->dlg.get("texokbutton");
@@ -248,20 +252,14 @@ void LatexController::deleteOldImage() {
     }
 }
 
-auto LatexController::loadRendered(string renderedTex) -> std::unique_ptr<TexImage> {
+auto LatexController::loadRendered(string renderedTex, string pdf) -> std::unique_ptr<TexImage> {
     if (!this->isValidTex) {
         return nullptr;
     }
 
-    fs::path pdfPath = texTmpDir / "tex.pdf";
-    auto contents = Util::readString(pdfPath, true);
-    if (!contents) {
-        return nullptr;
-    }
-
     auto img = std::make_unique<TexImage>();
     GError* err{};
-    bool loaded = img->loadData(std::move(*contents), &err);
+    bool loaded = img->loadData(std::move(pdf), &err);
 
     if (err != nullptr) {
         string message = FS(_F("Could not load LaTeX PDF file: {1}") % err->message);
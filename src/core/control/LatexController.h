@@ -20,7 +20,7 @@
 
 #include <poppler.h>
 
-#include "control/latex/LatexGenerator.h"
+#include "control/latex/LatexCompiler.h"
 #include "control/settings/LatexSettings.h"
 #include "gui/dialog/LatexDialog.h"
 #include "model/PageRef.h"
@@ -84,6 +84,11 @@ private:
      */
     void triggerImageUpdate(const std::string& texString);
 
+    /**
+     * Instantiate the LaTeX template with the formula and the current text color.
+     */
+    std::string instantiateTemplate(const std::string& texString);
+
     /**
      * Show the LaTex Editor dialog, returning the final formula input by the
      * user. If the input was cancelled, the resulting string will be the same
@@ -93,7 +98,8 @@ private:
 
     /**
      * Signal handler, updates the rendered image when the text in the editor
-     * changes.
+     * changes. Cached formulas are shown immediately, all others once the user
+     * stopped typing for PREVIEW_DELAY_MS.
      */
     static void handleTexChanged(GtkTextBuffer* buffer, LatexController* self);
 
@@ -103,15 +109,15 @@ private:
      * If the Latex text has changed since the last update, triggerPreviewUpdate
      * will be called again.
      */
-    static void onPdfRenderComplete(GObject* procObj, GAsyncResult* res, LatexController* self);
+    void onPdfRenderComplete(const LatexCompiler::Result& result);
 
     void updateStatus();
     bool isUpdating();
 
     /**
-     * Load the preview PDF from disk and create a TexImage object.
+     * Create a TexImage object from the generated PDF.
      */
-    std::unique_ptr<TexImage> loadRendered(std::string renderedTex);
+    std::unique_ptr<TexImage> loadRendered(std::string renderedTex, std::string pdf);
 
     /**
      * Insert the generated preview TexImage into the current page.
@@ -151,7 +157,12 @@ private:
     /**
      * Whether a preview is currently being generated.
      */
-    GCancellable* updating_cancellable = nullptr;
+    bool updating = false;
+
+    /**
+     * Pending delayed preview update, 0 if none
+     */
+    guint previewTimeout = 0;
 
     /**
      * Whether the current TeX string is valid.
@@ -215,5 +226,8 @@ private:
      */
     std::unique_ptr<TexImage> temporaryRender;
 
-    LatexGenerator generator;
+    /**
+     * Compiles the previews, with a cache shared by all formulas
+     */
+    LatexCompiler compiler;
 };
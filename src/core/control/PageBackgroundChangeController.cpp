@@ -152,9 +152,8 @@ auto PageBackgroundChangeController::applyImageBackground(PageRef page) -> bool
     }
 
     // Apply correct page size
-    GdkPixbuf* pixbuf = page->getBackgroundImage().getPixbuf();
-    if (pixbuf) {
-        page->setSize(gdk_pixbuf_get_width(pixbuf), gdk_pixbuf_get_height(pixbuf));
+    if (page->getBackgroundImage().getSurface()) {
+        page->setSize(page->getBackgroundImage().getWidth(), page->getBackgroundImage().getHeight());
 
         size_t pageNr = doc->indexOf(page);
         if (pageNr != npos) {
@@ -74,52 +74,84 @@ PdfCacheEntry* PdfCache::cache(XojPdfPageSPtr popplerPage, cairo_surface_t* img,
     return ne;
 }
 
-void PdfCache::render(cairo_t* cr, const XojPdfPageSPtr& popplerPage, double zoom) {
-    this->renderMutex.lock();
+auto PdfCache::getRendered(const XojPdfPageSPtr& popplerPage, double zoom, double& renderedZoom) -> cairo_surface_t* {
+    int pageId = popplerPage->getPageId();
+    {
+        std::unique_lock lock(this->renderMutex);
+
+        // Another thread renders the page, its result may be good enough
+        this->renderDone.wait(lock, [&]() { return this->rendering.count(pageId) == 0; });
+
+        this->setZoom(zoom);
 
-    this->setZoom(zoom);
+        PdfCacheEntry* cacheResult = lookup(popplerPage);
+        bool needsRefresh{cacheResult == nullptr};
 
-    PdfCacheEntry* cacheResult = lookup(popplerPage);
-    bool needsRefresh{cacheResult == nullptr};
+        if (cacheResult != nullptr) {
+            double averagedZoom = (zoom + cacheResult->zoom) / 2.0;
+            double percentZoomChange = std::abs(cacheResult->zoom - zoom) * 100.0 / averagedZoom;
 
-    if (cacheResult != nullptr) {
-        double averagedZoom = (this->zoom + cacheResult->zoom) / 2.0;
-        double percentZoomChange = std::abs(cacheResult->zoom - this->zoom) * 100.0 / averagedZoom;
+            // If we do have a cached result, is its rendering quality
+            // acceptable for our current zoom?
+            needsRefresh = zoom > 1.0 && percentZoomChange > this->zoomRefreshThreshold
 
-        // If we do have a cached result, is its rendering quality
-        // acceptable for our current zoom?
-        needsRefresh = this->zoom > 1.0 && percentZoomChange > this->zoomRefreshThreshold
+                           // Has the user requested that we **always** clear the cache on zoom?
+                           || this->zoomClearsCache && zoom != cacheResult->zoom;
+        }
+
+        if (!needsRefresh) {
+            renderedZoom = cacheResult->zoom;
+            return cairo_surface_reference(cacheResult->rendered);
+        }
 
-                       // Has the user requested that we **always** clear the cache on zoom?
-                       || this->zoomClearsCache && this->zoom != cacheResult->zoom;
+        this->rendering.insert(pageId);
     }
 
-    if (needsRefresh) {
-        double renderZoom = std::max(zoom, 1.0);
+    // Render without holding the lock, so the render threads can rasterize different pages at the same time
+    double renderZoom = std::max(zoom, 1.0);
 
-        auto* img = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, popplerPage->getWidth() * renderZoom,
-                                               popplerPage->getHeight() * renderZoom);
-        cairo_t* cr2 = cairo_create(img);
+    auto* img = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, popplerPage->getWidth() * renderZoom,
+                                           popplerPage->getHeight() * renderZoom);
+    cairo_t* cr2 = cairo_create(img);
 
-        cairo_scale(cr2, renderZoom, renderZoom);
-        popplerPage->render(cr2, false);
-        cairo_destroy(cr2);
+    cairo_scale(cr2, renderZoom, renderZoom);
+    popplerPage->render(cr2, false);
+    cairo_destroy(cr2);
 
-        cacheResult = cache(popplerPage, img, renderZoom);
+    // Referenced before the lock is released, another thread could drop the entry afterwards
+    cairo_surface_reference(img);
+    {
+        std::lock_guard lock(this->renderMutex);
+        cache(popplerPage, img, renderZoom);
+        this->rendering.erase(pageId);
     }
+    this->renderDone.notify_all();
+
+    renderedZoom = renderZoom;
+    return img;
+}
+
+void PdfCache::prepare(const XojPdfPageSPtr& popplerPage, double zoom) {
+    double renderedZoom = 0;
+    cairo_surface_destroy(getRendered(popplerPage, zoom, renderedZoom));
+}
+
+void PdfCache::render(cairo_t* cr, const XojPdfPageSPtr& popplerPage, double zoom) {
+    double renderedZoom = 0;
+    cairo_surface_t* rendered = getRendered(popplerPage, zoom, renderedZoom);
 
     cairo_matrix_t mOriginal;
     cairo_matrix_t mScaled;
     cairo_get_matrix(cr, &mOriginal);
     cairo_get_matrix(cr, &mScaled);
-    mScaled.xx = this->zoom / cacheResult->zoom;
-    mScaled.yy = this->zoom / cacheResult->zoom;
+    mScaled.xx = zoom / renderedZoom;
+    mScaled.yy = zoom / renderedZoom;
     mScaled.xy = 0;
     mScaled.yx = 0;
     cairo_set_matrix(cr, &mScaled);
-    cairo_set_source_surface(cr, cacheResult->rendered, 0, 0);
+    cairo_set_source_surface(cr, rendered, 0, 0);
     cairo_paint(cr);
     cairo_set_matrix(cr, &mOriginal);
 
-    this->renderMutex.unlock();
+    cairo_surface_destroy(rendered);
 }
@@ -11,9 +11,11 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <list>
 #include <mutex>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include <cairo.h>
@@ -35,6 +37,13 @@ private:
 
 public:
     void render(cairo_t* cr, const XojPdfPageSPtr& popplerPage, double zoom);
+
+    /**
+     * Renders the page into the cache if there is no usable raster for `zoom` yet, without painting it.
+     * Different pages can be prepared by several threads at the same time.
+     */
+    void prepare(const XojPdfPageSPtr& popplerPage, double zoom);
+
     void clearCache();
 
 public:
@@ -58,9 +67,21 @@ private:
     PdfCacheEntry* lookup(const XojPdfPageSPtr& popplerPage);
     PdfCacheEntry* cache(XojPdfPageSPtr popplerPage, cairo_surface_t* img, double zoom);
 
+    /**
+     * @return A new reference to a raster of the page, rendered at `renderedZoom`
+     */
+    cairo_surface_t* getRendered(const XojPdfPageSPtr& popplerPage, double zoom, double& renderedZoom);
+
 private:
     std::mutex renderMutex;
 
+    /**
+     * IDs of the pages which are rendered right now, a second thread waits for the result instead of rendering the
+     * page again. Signaled by renderDone.
+     */
+    std::unordered_set<int> rendering;
+    std::condition_variable renderDone;
+
     std::list<PdfCacheEntry*> data;
     std::list<PdfCacheEntry*>::size_type size = 0;
 
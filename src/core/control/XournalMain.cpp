@@ -7,12 +7,16 @@
 #include <gtk/gtk.h>
 #include <libintl.h>
 
+#include "control/BatchConverter.h"
 #include "control/jobs/ImageExport.h"
 #include "control/jobs/ProgressListener.h"
 #include "control/xojfile/LoadHandler.h"
 #include "gui/GladeSearchpath.h"
 #include "gui/MainWindow.h"
 #include "gui/XournalView.h"
+#include "gui/inputdevices/InputContext.h"
+#include "gui/inputdevices/InputTrace.h"
+#include "gui/widgets/XournalWidget.h"
 #include "pdf/base/XojPdfExport.h"
 #include "pdf/base/XojPdfExportFactory.h"
 #include "undo/EmergencySaveRestore.h"
@@ -52,7 +56,7 @@ void checkForErrorlog();
 void checkForEmergencySave(Control* control);
 
 auto exportPdf(const char* input, const char* output, const char* range, ExportBackgroundType exportBackground,
-               bool progressiveMode) -> int;
+               bool progressiveMode, bool reuseBackgroundPdf, bool incremental) -> int;
 auto exportImg(const char* input, const char* output, const char* range, int pngDpi, int pngWidth, int pngHeight,
                ExportBackgroundType exportBackground) -> int;
 
@@ -296,11 +300,13 @@ auto exportImg(const char* input, const char* output, const char* range, int png
  * @param exportBackground If EXPORT_BACKGROUND_NONE, the exported pdf file has white background
  * @param progressiveMode If true, then for each xournalpp page, instead of rendering one PDF page, the page layers are
  * rendered one by one to produce as many pages as there are layers.
+ * @param reuseBackgroundPdf If true, the pages of the background PDF are placed below the annotations as they are
+ * @param incremental If true, only the pages which changed since the last export to the same file are rendered
  *
  * @return 0 on success, -2 on failure opening the input file, -3 on export failure
  */
 auto exportPdf(const char* input, const char* output, const char* range, ExportBackgroundType exportBackground,
-               bool progressiveMode) -> int {
+               bool progressiveMode, bool reuseBackgroundPdf, bool incremental) -> int {
     LoadHandler loader;
 
     Document* doc = loader.loadDocument(input);
@@ -312,6 +318,8 @@ auto exportPdf(const char* input, const char* output, const char* range, ExportB
 
     XojPdfExport* pdfe = XojPdfExportFactory::createExport(doc, nullptr);
     pdfe->setExportBackground(exportBackground);
+    pdfe->setReuseBackgroundPdf(reuseBackgroundPdf);
+    pdfe->setIncremental(incremental);
     char* cpath = g_file_get_path(file);
     std::string path = cpath;
     g_free(cpath);
@@ -353,11 +361,20 @@ struct XournalMainPrivate {
         g_strfreev(optFilename);
         g_free(pdfFilename);
         g_free(imgFilename);
+        g_free(batchSource);
+        g_free(batchWorker);
+        g_free(recordInput);
+        g_free(replayInput);
     }
 
     gchar** optFilename{};
     gchar* pdfFilename{};
     gchar* imgFilename{};
+    gchar* batchSource{};
+    int batchJobs = 0;
+    gchar* batchWorker{};
+    gchar* recordInput{};
+    gchar* replayInput{};
     gboolean showVersion = false;
     int openAtPageNumber = 0;  // when no --page is used, the document opens at the page specified in the metadata file
     gchar* exportRange{};
@@ -367,6 +384,8 @@ struct XournalMainPrivate {
     gboolean exportNoBackground = false;
     gboolean exportNoRuling = false;
     gboolean progressiveMode = false;
+    gboolean reuseBackgroundPdf = false;
+    gboolean exportIncremental = false;
     std::unique_ptr<GladeSearchpath> gladePath;
     std::unique_ptr<Control> control;
     std::unique_ptr<MainWindow> win;
@@ -450,6 +469,21 @@ void initResourcePath(GladeSearchpath* gladePath, const gchar* relativePathAndFi
     }
 }
 
+/**
+ * @brief Replays a recorded input trace against the opened document, prints the time spent on the events and quits
+ */
+void replayInputTrace(GApplication* application, XMPtr app_data) {
+    std::vector<InputTraceEvent> events;
+    if (!InputTrace::read(fs::u8path(app_data->replayInput), events)) {
+        g_warning("Could not read the input trace %s", app_data->replayInput);
+    } else {
+        InputTracePlayer player(GTK_XOURNAL(app_data->win->getXournal()->getWidget())->input);
+        player.play(events);
+        player.printReport(std::cout);
+    }
+    g_application_quit(application);
+}
+
 void on_activate(GApplication*, XMPtr) {}
 
 void on_command_line(GApplication*, GApplicationCommandLine*, XMPtr) {
@@ -551,6 +585,47 @@ void on_startup(GApplication* application, XMPtr app_data) {
     // This fixes it, see #405
     Util::execInUiThread([=]() { app_data->control->getWindow()->getXournal()->layoutPages(); });
     gtk_application_add_window(GTK_APPLICATION(application), GTK_WINDOW(app_data->win->getWindow()));
+
+    if (app_data->recordInput) {
+        InputContext* input = GTK_XOURNAL(app_data->win->getXournal()->getWidget())->input;
+        if (!input->startRecording(fs::u8path(app_data->recordInput))) {
+            g_warning("Could not write the input trace %s", app_data->recordInput);
+        }
+    }
+    if (app_data->replayInput) {
+        // After the pages are laid out, so the recorded coordinates hit the same pages
+        Util::execInUiThread([=]() { replayInputTrace(application, app_data); });
+    }
+}
+
+/**
+ * @brief Export all documents listed in a manifest file or contained in a directory, see BatchConverter
+ *
+ * @return 0 on success, -2 on failure reading the source, -3 if any document could not be exported
+ */
+auto exportBatch(const char* source, XMPtr app_data) -> int {
+    BatchConverter::Options options;
+    options.exportBackground = app_data->exportNoBackground ? EXPORT_BACKGROUND_NONE :
+                               app_data->exportNoRuling     ? EXPORT_BACKGROUND_UNRULED :
+                                                              EXPORT_BACKGROUND_ALL;
+    options.progressiveMode = app_data->progressiveMode;
+    options.reuseBackgroundPdf = app_data->reuseBackgroundPdf;
+    options.pngDpi = app_data->exportPngDpi;
+    options.pngWidth = app_data->exportPngWidth;
+    options.pngHeight = app_data->exportPngHeight;
+    options.jobs = app_data->batchJobs;
+    options.executable = Stacktrace::getExePath();
+    if (app_data->batchWorker) {
+        options.resultFile = fs::u8path(app_data->batchWorker);
+    }
+
+    BatchConverter converter(options);
+    if (!converter.addSource(fs::u8path(source))) {
+        g_message("%s", FC(_F("Could not read the batch source {1}") % source));
+        return -2;
+    }
+
+    return converter.run() == 0 ? 0 : -3;
 }
 
 auto on_handle_local_options(GApplication*, GVariantDict*, XMPtr app_data) -> gint {
@@ -562,12 +637,15 @@ auto on_handle_local_options(GApplication*, GVariantDict*, XMPtr app_data) -> gi
         return 0;
     }
 
+    if (app_data->batchSource) {
+        return exportBatch(app_data->batchSource, app_data);
+    }
     if (app_data->pdfFilename && app_data->optFilename && *app_data->optFilename) {
         return exportPdf(*app_data->optFilename, app_data->pdfFilename, app_data->exportRange,
                          app_data->exportNoBackground ? EXPORT_BACKGROUND_NONE :
                          app_data->exportNoRuling     ? EXPORT_BACKGROUND_UNRULED :
                                                         EXPORT_BACKGROUND_ALL,
-                         app_data->progressiveMode);
+                         app_data->progressiveMode, app_data->reuseBackgroundPdf, app_data->exportIncremental);
     }
     if (app_data->imgFilename && app_data->optFilename && *app_data->optFilename) {
         return exportImg(*app_data->optFilename, app_data->imgFilename, app_data->exportRange, app_data->exportPngDpi,
@@ -604,6 +682,13 @@ auto XournalMain::run(int argc, char** argv) -> int {
                                        "<input>", nullptr},
                           GOptionEntry{"version", 0, 0, G_OPTION_ARG_NONE, &app_data.showVersion,
                                        _("Get version of xournalpp"), nullptr},
+                          GOptionEntry{"record-input", 0, 0, G_OPTION_ARG_FILENAME, &app_data.recordInput,
+                                       _("Record all input events of the session to TRACEFILE"), "TRACEFILE"},
+                          GOptionEntry{"replay-input", 0, 0, G_OPTION_ARG_FILENAME, &app_data.replayInput,
+                                       _("Replay the input events of TRACEFILE on the opened document\n"
+                                         "                                 Prints the time spent per kind of event\n"
+                                         "                                 and quits"),
+                                       "TRACEFILE"},
                           GOptionEntry{nullptr}};  // Must be terminated by a nullptr. See gtk doc
     g_application_add_main_option_entries(G_APPLICATION(app), options.data());
 
@@ -634,6 +719,35 @@ auto XournalMain::run(int argc, char** argv) -> int {
                            "                                 building up the layer stack progressively.\n"
                            "                                 The resulting PDF file can be used for a presentation.\n"),
                          0},
+            GOptionEntry{"export-reuse-background-pdf", 0, 0, G_OPTION_ARG_NONE, &app_data.reuseBackgroundPdf,
+                         _("Reuse the pages of the background PDF\n"
+                           "                                 In PDF export, only render the annotations and place\n"
+                           "                                 the original PDF pages below them (requires qpdf).\n"
+                           "                                 Falls back to rendering the background if not all\n"
+                           "                                 pages have a PDF background.\n"),
+                         0},
+            GOptionEntry{"export-incremental", 0, 0, G_OPTION_ARG_NONE, &app_data.exportIncremental,
+                         _("Only render the pages which changed since the last export\n"
+                           "                                 In PDF export, the unchanged pages are copied from the\n"
+                           "                                 file written by the last export (requires qpdf).\n"
+                           "                                 The pages of every export are remembered in the cache.\n"),
+                         0},
+            GOptionEntry{"export-batch", 0, 0, G_OPTION_ARG_FILENAME, &app_data.batchSource,
+                         _("Export many documents in one run\n"
+                           "                                 SOURCE is a directory (all .xopp and .xoj files are\n"
+                           "                                 exported to PDF next to them) or a manifest file with\n"
+                           "                                 one \"input\" or \"input<TAB>output\" per line.\n"
+                           "                                 The output format follows the extension of the output"),
+                         "SOURCE"},
+            GOptionEntry{"export-batch-jobs", 0, 0, G_OPTION_ARG_INT, &app_data.batchJobs,
+                         _("Number of documents exported in parallel by --export-batch\n"
+                           "                                 Every document is exported by one of N worker\n"
+                           "                                 processes. Default is one per processor"),
+                         "N"},
+            GOptionEntry{"export-batch-worker", 0, G_OPTION_FLAG_HIDDEN, G_OPTION_ARG_FILENAME, &app_data.batchWorker,
+                         "Internal: export the documents of --export-batch as worker process, writing the results to "
+                         "RESULTS",
+                         "RESULTS"},
             GOptionEntry{"export-range", 0, 0, G_OPTION_ARG_STRING, &app_data.exportRange,
                          _("Only export the pages specified by RANGE (e.g. \"2-3,5,7-\")\n"
                            "                                 No effect without -p/--create-pdf or -i/--create-img"),
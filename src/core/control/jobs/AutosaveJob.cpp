@@ -19,6 +19,7 @@ void AutosaveJob::afterRun() {
 
 void AutosaveJob::run() {
     SaveHandler handler;
+    handler.setCompression(control->getSettings()->getSaveCompressionLevel());
 
     control->getUndoRedoHandler()->documentAutosaved();
 
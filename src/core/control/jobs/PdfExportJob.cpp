@@ -1,10 +1,18 @@
 #include "PdfExportJob.h"
 
+#include <atomic>
+#include <utility>
+
 #include "control/Control.h"
 #include "pdf/base/XojPdfExport.h"
 #include "pdf/base/XojPdfExportFactory.h"
+#include "util/XojMsgBox.h"
 #include "util/i18n.h"
 
+namespace {
+std::atomic<bool> warningShown{false};
+}  // namespace
+
 PdfExportJob::PdfExportJob(Control* control): BaseExportJob(control, _("PDF Export")) {}
 
 PdfExportJob::~PdfExportJob() = default;
@@ -31,12 +39,28 @@ void PdfExportJob::run() {
     XojPdfExport* pdfe = XojPdfExportFactory::createExport(doc, control);
     doc->unlock();
 
+    // Exporting the same document again only renders the pages which changed
+    pdfe->setIncremental(control->getSettings()->isIncrementalPdfExport());
+
     if (!pdfe->createPdf(this->filepath, false)) {
         this->errorMsg = pdfe->getLastError();
         if (control->getWindow()) {
             callAfterRun();
         }
+    } else if (std::string warning = pdfe->getLastWarning(); !warning.empty() && !warningShown.exchange(true)) {
+        this->warningMsg = std::move(warning);
+        if (control->getWindow()) {
+            callAfterRun();
+        }
     }
 
     delete pdfe;
 }
+
+void PdfExportJob::afterRun() {
+    BaseExportJob::afterRun();
+
+    if (!this->warningMsg.empty()) {
+        XojMsgBox::showErrorToUser(control->getGtkWindow(), this->warningMsg);
+    }
+}
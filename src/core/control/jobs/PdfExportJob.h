@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <string>
+
 #include "BaseExportJob.h"
 
 class PdfExportJob: public BaseExportJob {
@@ -22,10 +24,15 @@ protected:
 
 public:
     void run();
+    void afterRun() override;
 
 protected:
     virtual void addFilterToDialog();
     bool testAndSetFilepath(fs::path file) override;
 
 private:
+    /**
+     * Shown once per session, e.g. that the export was slower because qpdf is missing
+     */
+    std::string warningMsg;
 };
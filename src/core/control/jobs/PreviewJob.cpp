@@ -4,6 +4,7 @@
 #include "gui/Shadow.h"
 #include "gui/sidebar/previews/base/SidebarPreviewBase.h"
 #include "gui/sidebar/previews/base/SidebarPreviewBaseEntry.h"
+#include "gui/sidebar/previews/base/SidebarPreviewCache.h"
 #include "gui/sidebar/previews/layer/SidebarPreviewLayerEntry.h"
 #include "model/Document.h"
 #include "view/DocumentView.h"
@@ -20,9 +21,13 @@ auto PreviewJob::getSource() -> void* { return this->sidebarPreview; }
 auto PreviewJob::getType() -> JobType { return JOB_TYPE_PREVIEW; }
 
 void PreviewJob::initGraphics() {
-    GtkAllocation alloc;
-    gtk_widget_get_allocation(this->sidebarPreview->widget, &alloc);
-    crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, alloc.width, alloc.height);
+    this->sidebarPreview->drawingMutex.lock();
+    this->generation = this->sidebarPreview->generation;
+    this->sidebarPreview->drawingMutex.unlock();
+
+    // The widget of a preview may not exist, it is only created while the preview is scrolled into view
+    crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, this->sidebarPreview->getWidgetWidth(),
+                                          this->sidebarPreview->getWidgetHeight());
     zoom = this->sidebarPreview->sidebar->getZoom();
     cr2 = cairo_create(crBuffer);
 }
@@ -35,10 +40,24 @@ void PreviewJob::drawBorder() {
 void PreviewJob::finishPaint() {
     this->sidebarPreview->drawingMutex.lock();
 
+    bool outdated = this->generation != this->sidebarPreview->generation;
+    if (outdated || this->sidebarPreview->widget == nullptr) {
+        if (!outdated) {
+            // Scrolled out of view while rendering
+            this->sidebarPreview->sidebar->getPreviewCache()->store(this->sidebarPreview, crBuffer);
+        }
+        // Otherwise the page was changed while rendering, a visible preview has queued a new job
+        cairo_surface_destroy(crBuffer);
+        crBuffer = nullptr;
+        this->sidebarPreview->drawingMutex.unlock();
+        return;
+    }
+
     if (this->sidebarPreview->crBuffer) {
         cairo_surface_destroy(this->sidebarPreview->crBuffer);
     }
     this->sidebarPreview->crBuffer = crBuffer;
+    this->sidebarPreview->outdated = false;
 
     // The preview widget can be referenced after this is deleted.
     // Only it should be referenced in the callback.
@@ -64,6 +64,11 @@ private:
      */
     double zoom = 0;
 
+    /**
+     * Generation of the preview when rendering started, see SidebarPreviewBaseEntry::generation
+     */
+    size_t generation = 0;
+
     /**
      * Sidebar preview
      */
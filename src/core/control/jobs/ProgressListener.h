@@ -11,11 +11,18 @@
 
 #pragma once
 
+#include <string>
+
 class ProgressListener {
 public:
     virtual void setMaximumState(int max) = 0;
     virtual void setCurrentState(int state) = 0;
 
+    /**
+     * Optional details about the progress, e.g. the throughput of an export
+     */
+    virtual void setStatusText(const std::string& text){};
+
     virtual ~ProgressListener(){};
 };
 
@@ -1,6 +1,8 @@
 #include "RenderJob.h"
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 #include "control/Control.h"
 #include "control/ToolHandler.h"
@@ -16,7 +18,7 @@ RenderJob::RenderJob(XojPageView* view): view(view) {}
 
 auto RenderJob::getSource() -> void* { return this->view; }
 
-void RenderJob::rerenderRectangle(Rectangle<double> const& rect) {
+void RenderJob::rerenderRegion(const DamageRegion& damage) {
     double zoom = view->xournal->getZoom();
     Document* doc = view->xournal->getDocument();
     doc->lock();
@@ -24,65 +26,117 @@ void RenderJob::rerenderRectangle(Rectangle<double> const& rect) {
     double pageHeight = view->page->getHeight();
     doc->unlock();
 
-    auto x = int(std::lround(rect.x * zoom));
-    auto y = int(std::lround(rect.y * zoom));
-    auto width = int(std::lround(rect.width * zoom));
-    auto height = int(std::lround(rect.height * zoom));
+    struct DeviceRect {
+        Rectangle<double> rect;
+        int x, y, width, height;
+    };
+
+    std::vector<DeviceRect> deviceRects;
+    int maxWidth = 0;
+    int maxHeight = 0;
+    for (Rectangle<double> const& rect: damage.getRects({0, 0, pageWidth, pageHeight})) {
+        auto x = int(std::lround(rect.x * zoom));
+        auto y = int(std::lround(rect.y * zoom));
+        auto width = int(std::lround(rect.width * zoom));
+        auto height = int(std::lround(rect.height * zoom));
+        if (width <= 0 || height <= 0) {
+            continue;
+        }
+        deviceRects.push_back({rect, x, y, width, height});
+        maxWidth = std::max(maxWidth, width);
+        maxHeight = std::max(maxHeight, height);
+    }
 
-    cairo_surface_t* rectBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
-    cairo_t* crRect = cairo_create(rectBuffer);
-    cairo_translate(crRect, -x, -y);
-    cairo_scale(crRect, zoom, zoom);
+    if (deviceRects.empty()) {
+        return;
+    }
+
+    // One scratch buffer, large enough for the biggest rectangle, is shared by all rectangles
+    cairo_surface_t* rectBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, maxWidth, maxHeight);
 
     DocumentView v;
     Control* control = view->getXournal()->getControl();
     v.setMarkAudioStroke(control->getToolHandler()->getToolType() == TOOL_PLAY_OBJECT);
-    v.limitArea(rect.x, rect.y, rect.width, rect.height);
-
-    bool backgroundVisible = view->page->isLayerVisible(0);
-    if (backgroundVisible && view->page->getBackgroundType().isPdfPage()) {
-        auto pgNo = view->page->getPdfPageNr();
-        XojPdfPageSPtr popplerPage = doc->getPdfPage(pgNo);
-        PdfCache* cache = view->xournal->getCache();
-        PdfView::drawPage(cache, popplerPage, crRect, zoom, pageWidth, pageHeight);
-    }
 
-    doc->lock();
-    v.drawPage(view->page, crRect, false);
-    doc->unlock();
+    auto paintPdf = [&](cairo_t* cr) {
+        XojPdfPageSPtr popplerPage = doc->getPdfPage(view->page->getPdfPageNr());
+        PdfView::drawPage(view->xournal->getCache(), popplerPage, cr, zoom, pageWidth, pageHeight);
+    };
+
+    for (DeviceRect const& r: deviceRects) {
+        cairo_t* crRect = cairo_create(rectBuffer);
+        cairo_rectangle(crRect, 0, 0, r.width, r.height);
+        cairo_clip(crRect);
+
+        // Remove what the previous rectangle left in the buffer
+        cairo_set_operator(crRect, CAIRO_OPERATOR_CLEAR);
+        cairo_paint(crRect);
+        cairo_set_operator(crRect, CAIRO_OPERATOR_OVER);
 
-    cairo_destroy(crRect);
+        cairo_translate(crRect, -r.x, -r.y);
+        cairo_scale(crRect, zoom, zoom);
 
-    view->drawingMutex.lock();
+        doc->lock();
+        view->layerCache.paint(crRect, view->page, zoom, v, paintPdf, &r.rect);
+        doc->unlock();
+
+        cairo_destroy(crRect);
+        cairo_surface_flush(rectBuffer);
 
-    cairo_t* crPageBuffer = cairo_create(view->crBuffer);
+        view->drawingMutex.lock();
 
-    cairo_set_operator(crPageBuffer, CAIRO_OPERATOR_SOURCE);
-    cairo_set_source_surface(crPageBuffer, rectBuffer, x, y);
-    cairo_rectangle(crPageBuffer, x, y, width, height);
-    cairo_fill(crPageBuffer);
+        if (view->crBuffer) {
+            cairo_t* crPageBuffer = cairo_create(view->crBuffer);
 
-    cairo_destroy(crPageBuffer);
+            cairo_set_operator(crPageBuffer, CAIRO_OPERATOR_SOURCE);
+            cairo_set_source_surface(crPageBuffer, rectBuffer, r.x, r.y);
+            cairo_rectangle(crPageBuffer, r.x, r.y, r.width, r.height);
+            cairo_fill(crPageBuffer);
+
+            cairo_destroy(crPageBuffer);
+        }
+
+        view->drawingMutex.unlock();
+    }
 
     cairo_surface_destroy(rectBuffer);
+}
+
+auto RenderJob::isObsolete(double zoom) -> bool { return this->view->xournal->getZoom() != zoom; }
 
-    view->drawingMutex.unlock();
+void RenderJob::rerenderObsolete() {
+    // Queue the rerender at the new zoom from the UI thread, not from here while the document may be locked. If the
+    // zoom change already queued this page, the jobs are merged.
+    XournalView* xournal = this->view->xournal;
+    XojPageView* view = this->view;
+    Util::execInUiThread([xournal, view]() { xournal->rerenderObsoletePage(view); });
 }
 
 void RenderJob::run() {
     double zoom = this->view->xournal->getZoom();
+    const double viewZoom = zoom;
 
     this->view->repaintRectMutex.lock();
 
     bool rerenderComplete = this->view->rerenderComplete;
-    auto rerenderRects = std::move(this->view->rerenderRects);
+    DamageRegion damage = std::move(this->view->rerenderRegion);
 
     this->view->rerenderComplete = false;
 
     this->view->repaintRectMutex.unlock();
 
+    if (!rerenderComplete && damage.isEmpty()) {
+        // The damage was already covered by a complete rerender of an earlier job
+        return;
+    }
+
     int dpiScaleFactor = this->view->xournal->getDpiScaleFactor();
 
+    if (rerenderComplete) {
+        // Something else than the layer contents changed, e.g. the zoom or the background
+        this->view->layerCache.clear();
+    }
+
     if (rerenderComplete || dpiScaleFactor > 1) {
         Document* doc = this->view->xournal->getDocument();
 
@@ -100,11 +154,26 @@ void RenderJob::run() {
         XojPdfPageSPtr popplerPage;
 
         doc->lock();
-
         if (this->view->page->getBackgroundType().isPdfPage()) {
             auto pgNo = this->view->page->getPdfPageNr();
             popplerPage = doc->getPdfPage(pgNo);
         }
+        bool backgroundVisible = this->view->page->isLayerVisible(0);
+        doc->unlock();
+
+        // Rasterizing the PDF does not need the document, so the render threads can do it for several pages at once
+        if (popplerPage && backgroundVisible) {
+            this->view->xournal->getCache()->prepare(popplerPage, zoom);
+        }
+
+        if (isObsolete(viewZoom)) {
+            cairo_destroy(cr2);
+            cairo_surface_destroy(crBuffer);
+            rerenderObsolete();
+            return;
+        }
+
+        doc->lock();
 
         Control* control = view->getXournal()->getControl();
         DocumentView localView;
@@ -112,14 +181,20 @@ void RenderJob::run() {
         int width = this->view->page->getWidth();
         int height = this->view->page->getHeight();
 
-        bool backgroundVisible = this->view->page->isLayerVisible(0);
-        if (backgroundVisible && this->view->page->getBackgroundType().isPdfPage()) {
-            PdfView::drawPage(this->view->xournal->getCache(), popplerPage, cr2, zoom, width, height);
-        }
-        localView.drawPage(this->view->page, cr2, false);
+        auto paintPdf = [&](cairo_t* cr) {
+            PdfView::drawPage(this->view->xournal->getCache(), popplerPage, cr, zoom, width, height);
+        };
+        this->view->layerCache.paint(cr2, this->view->page, zoom, localView, paintPdf, nullptr);
 
         cairo_destroy(cr2);
 
+        if (isObsolete(viewZoom)) {
+            doc->unlock();
+            cairo_surface_destroy(crBuffer);
+            rerenderObsolete();
+            return;
+        }
+
         this->view->drawingMutex.lock();
 
         if (this->view->crBuffer) {
@@ -130,7 +205,7 @@ void RenderJob::run() {
         this->view->drawingMutex.unlock();
         doc->unlock();
     } else {
-        for (Rectangle<double> const& rect: rerenderRects) { rerenderRectangle(rect); }
+        rerenderRegion(damage);
     }
 
     // Schedule a repaint of the widget
@@ -16,7 +16,7 @@
 
 #include <gtk/gtk.h>
 
-#include "util/Rectangle.h"
+#include "util/DamageRegion.h"
 
 #include "Job.h"
 
@@ -43,7 +43,20 @@ private:
      */
     static void repaintWidget(GtkWidget* widget);
 
-    void rerenderRectangle(Rectangle<double> const& rect);
+    /**
+     * Rerender the damaged parts of the page into the page buffer
+     */
+    void rerenderRegion(const DamageRegion& damage);
+
+    /**
+     * @return true if the zoom changed since the rendering at `zoom` started
+     */
+    bool isObsolete(double zoom);
+
+    /**
+     * Requests a rerender at the new zoom in the UI thread, after the job found its result obsolete
+     */
+    void rerenderObsolete();
 
 private:
     XojPageView* view;
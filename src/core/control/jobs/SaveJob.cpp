@@ -3,11 +3,11 @@
 #include <config.h>
 
 #include "control/Control.h"
+#include "control/xojfile/PreviewRenderer.h"
 #include "control/xojfile/SaveHandler.h"
 #include "util/PathUtil.h"
 #include "util/XojMsgBox.h"
 #include "util/i18n.h"
-#include "view/DocumentView.h"
 
 #include "filesystem.h"
 
@@ -38,45 +38,11 @@ void SaveJob::updatePreview(Control* control) {
     Document* doc = control->getDocument();
 
     doc->lock();
-
-    if (doc->getPageCount() > 0) {
-        PageRef page = doc->getPage(0);
-
-        double width = page->getWidth();
-        double height = page->getHeight();
-
-        double zoom = 1;
-
-        if (width < height) {
-            zoom = previewSize / height;
-        } else {
-            zoom = previewSize / width;
-        }
-        width *= zoom;
-        height *= zoom;
-
-        cairo_surface_t* crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
-
-        cairo_t* cr = cairo_create(crBuffer);
-        cairo_scale(cr, zoom, zoom);
-
-        if (page->getBackgroundType().isPdfPage()) {
-            auto pgNo = page->getPdfPageNr();
-            XojPdfPageSPtr popplerPage = doc->getPdfPage(pgNo);
-            if (popplerPage) {
-                popplerPage->render(cr, false);
-            }
-        }
-
-        DocumentView view;
-        view.drawPage(page, cr, true);
-        cairo_destroy(cr);
-        doc->setPreview(crBuffer);
-        cairo_surface_destroy(crBuffer);
-    } else {
-        doc->setPreview(nullptr);
+    cairo_surface_t* preview = PreviewRenderer::renderPage(doc, 0, previewSize);
+    doc->setPreview(preview);
+    if (preview) {
+        cairo_surface_destroy(preview);
     }
-
     doc->unlock();
 }
 
@@ -84,6 +50,7 @@ auto SaveJob::save() -> bool {
     updatePreview(control);
     Document* doc = this->control->getDocument();
     SaveHandler h;
+    h.setCompression(this->control->getSettings()->getSaveCompressionLevel());
 
     doc->lock();
     h.prepareSave(doc);
@@ -1,5 +1,6 @@
 #include "Scheduler.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cinttypes>
 
@@ -31,8 +32,10 @@ Scheduler::~Scheduler() {
 
     stop();
 
-    Job* job = nullptr;
-    while ((job = getNextJobUnlocked()) != nullptr) { job->unref(); }
+    for (std::deque<Job*>* queue: this->jobQueue) {
+        for (Job* job: *queue) { job->unref(); }
+        queue->clear();
+    }
 
     if (this->blockRenderZoomTime) {
         g_free(this->blockRenderZoomTime);
@@ -44,6 +47,17 @@ void Scheduler::start() {
     g_return_if_fail(this->thread == nullptr);
 
     this->thread = g_thread_new(name.c_str(), reinterpret_cast<GThreadFunc>(jobThreadCallback), this);
+
+    for (int i = 0; i < this->renderThreadCount; i++) {
+        std::string threadName = name + "Render" + std::to_string(i);
+        this->renderThreads.push_back(
+                g_thread_new(threadName.c_str(), reinterpret_cast<GThreadFunc>(renderThreadCallback), this));
+    }
+}
+
+void Scheduler::setRenderThreadCount(int count) {
+    g_return_if_fail(this->thread == nullptr);
+    this->renderThreadCount = std::max(count, 0);
 }
 
 void Scheduler::stop() {
@@ -58,6 +72,8 @@ void Scheduler::stop() {
     if (this->thread) {
         g_thread_join(this->thread);
     }
+    for (GThread* renderThread: this->renderThreads) { g_thread_join(renderThread); }
+    this->renderThreads.clear();
 }
 
 void Scheduler::addJob(Job* job, JobPriority priority) {
@@ -74,30 +90,40 @@ void Scheduler::addJob(Job* job, JobPriority priority) {
     this->jobQueueCond.notify_all();
 }
 
-auto Scheduler::getNextJobUnlocked(bool onlyNotRender, bool* hasRenderJobs) -> Job* {
+auto Scheduler::getNextJobUnlocked(bool onlyNotRender, bool* hasRenderJobs, bool onlyRender) -> Job* {
     Job* job = nullptr;
 
     for (int i = JOB_PRIORITY_URGENT; i < JOB_N_PRIORITIES; i++) {
         std::deque<Job*>& queue = *this->jobQueue[i];
 
-        if (onlyNotRender) {
-            for (auto it = queue.begin(); it != queue.end(); ++it) {
-                job = *it;
+        for (auto it = queue.begin(); it != queue.end(); ++it) {
+            job = *it;
 
-                if (job->getType() != JOB_TYPE_RENDER) {
-                    queue.erase(it);
-                    return job;
+            if (job->getType() != JOB_TYPE_RENDER) {
+                if (onlyRender) {
+                    continue;
                 }
 
+                queue.erase(it);
+                assert(job != nullptr);
+                return job;
+            }
+
+            if (onlyNotRender) {
                 if (hasRenderJobs != nullptr) {
                     *hasRenderJobs = true;
                 }
+                continue;
             }
-        } else if (!queue.empty()) {
-            job = queue.front();
-            queue.pop_front();
-            assert(job != nullptr);
 
+            // Two jobs rendering the same page would overwrite each others buffers
+            auto& running = this->runningRenderSources;
+            if (std::find(running.begin(), running.end(), job->getSource()) != running.end()) {
+                continue;
+            }
+
+            queue.erase(it);
+            running.push_back(job->getSource());
             return job;
         }
     }
@@ -108,7 +134,21 @@ auto Scheduler::getNextJobUnlocked(bool onlyNotRender, bool* hasRenderJobs) -> J
 /**
  * Locks the complete scheduler
  */
-void Scheduler::lock() { this->schedulerMutex.lock(); }
+void Scheduler::lock() {
+    // std::shared_mutex does not prefer writers, without this the job threads could keep it shared all the time
+    {
+        std::lock_guard lock{this->jobQueueMutex};
+        this->lockRequests++;
+    }
+
+    this->schedulerMutex.lock();
+
+    {
+        std::lock_guard lock{this->jobQueueMutex};
+        this->lockRequests--;
+    }
+    this->jobQueueCond.notify_all();
+}
 
 /**
  * Unlocks the complete scheduler
@@ -180,39 +220,58 @@ auto Scheduler::jobRenderThreadTimer(Scheduler* scheduler) -> bool {
 }
 
 auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
-    while (scheduler->threadRunning) {
-        // lock the whole scheduler
-        std::unique_lock schedulerLock{scheduler->schedulerMutex};
+    scheduler->runJobs(false);
+    return nullptr;
+}
+
+auto Scheduler::renderThreadCallback(Scheduler* scheduler) -> gpointer {
+    scheduler->runJobs(true);
+    return nullptr;
+}
+
+void Scheduler::runJobs(bool onlyRender) {
+    while (this->threadRunning) {
+        // lock the whole scheduler, shared with the other job threads
+        std::shared_lock schedulerLock{this->schedulerMutex};
         SDEBUG("Job Thread: Blocked scheduler.");
 
         bool onlyNonRenderJobs = false;
         glong diff = 1000;
-        if (scheduler->blockRenderZoomTime) {
-            std::lock_guard lock{scheduler->blockRenderMutex};
-            SDEBUG("Zoom re-render blocking.");
-
-            GTimeVal time;
-            g_get_current_time(&time);
-
-            diff = g_time_val_diff(scheduler->blockRenderZoomTime, &time);
-            if (diff <= 0) {
-                g_free(scheduler->blockRenderZoomTime);
-                scheduler->blockRenderZoomTime = nullptr;
-                SDEBUG("Ended zoom re-render blocking.");
-            } else {
-                onlyNonRenderJobs = true;
-                SDEBUG("Rendering blocked: Only running non-rendering jobs.");
+        {
+            std::lock_guard lock{this->blockRenderMutex};
+            if (this->blockRenderZoomTime) {
+                SDEBUG("Zoom re-render blocking.");
+
+                GTimeVal time;
+                g_get_current_time(&time);
+
+                diff = g_time_val_diff(this->blockRenderZoomTime, &time);
+                if (diff <= 0) {
+                    g_free(this->blockRenderZoomTime);
+                    this->blockRenderZoomTime = nullptr;
+                    SDEBUG("Ended zoom re-render blocking.");
+                } else {
+                    onlyNonRenderJobs = true;
+                    SDEBUG("Rendering blocked: Only running non-rendering jobs.");
+                }
             }
         }
 
         Job* job;
+        std::shared_lock<std::shared_mutex> runningLock;
 
         {
-            std::unique_lock jobLock{scheduler->jobQueueMutex};
+            std::unique_lock jobLock{this->jobQueueMutex};
             SDEBUG("Job Thread: Locked job queue.");
 
             bool hasOnlyRenderJobs = false;
-            job = scheduler->getNextJobUnlocked(onlyNonRenderJobs, &hasOnlyRenderJobs);
+            if (this->finishRequests > 0 || this->lockRequests > 0 || (onlyRender && onlyNonRenderJobs)) {
+                // Someone waits for the running jobs to finish or to lock the scheduler, or rendering is blocked for
+                // the render threads
+                job = nullptr;
+            } else {
+                job = getNextJobUnlocked(onlyNonRenderJobs, &hasOnlyRenderJobs, onlyRender);
+            }
             if (job != nullptr) {
                 hasOnlyRenderJobs = false;
             }
@@ -223,31 +282,44 @@ auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
                 // unlock the whole scheduler
                 schedulerLock.unlock();
 
-                if (hasOnlyRenderJobs) {
-                    if (scheduler->jobRenderThreadTimerId) {
-                        g_source_remove(scheduler->jobRenderThreadTimerId);
+                if (hasOnlyRenderJobs && !onlyRender) {
+                    if (this->jobRenderThreadTimerId) {
+                        g_source_remove(this->jobRenderThreadTimerId);
                     }
-                    scheduler->jobRenderThreadTimerId = g_timeout_add(
-                            static_cast<guint>(diff), reinterpret_cast<GSourceFunc>(jobRenderThreadTimer), scheduler);
+                    this->jobRenderThreadTimerId = g_timeout_add(
+                            static_cast<guint>(diff), reinterpret_cast<GSourceFunc>(jobRenderThreadTimer), this);
                 }
 
-                scheduler->jobQueueCond.wait(jobLock);
+                this->jobQueueCond.wait(jobLock);
                 continue;
             }
+
+            // Taken before the job queue is unlocked, so removing a source waits for this job
+            runningLock = std::shared_lock{this->jobRunningMutex};
         }
 
         // Run the job.
-        {
-            std::lock_guard lock{scheduler->jobRunningMutex};
-            SDEBUG("do job: %" PRId64, (uint64_t)job);
-            job->execute();
-            job->unref();
+        bool isRenderJob = job->getType() == JOB_TYPE_RENDER;
+        void* source = job->getSource();
+
+        SDEBUG("do job: %" PRId64, (uint64_t)job);
+        job->execute();
+        job->unref();
+
+        if (isRenderJob) {
+            {
+                std::lock_guard lock{this->jobQueueMutex};
+                auto& running = this->runningRenderSources;
+                running.erase(std::find(running.begin(), running.end(), source));
+            }
+            // Another job for the same source may be waiting
+            this->jobQueueCond.notify_all();
         }
 
+        runningLock.unlock();
+
         SDEBUG("next");
     }
 
     SDEBUG("finished");
-
-    return nullptr;
 }
@@ -17,7 +17,9 @@
 #include <condition_variable>
 #include <deque>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <vector>
 
 #include <gtk/gtk.h>
 
@@ -83,7 +85,13 @@ public:
     void stop();
 
     /**
-     * Locks the complete scheduler
+     * Sets the number of threads which may additionally run render jobs, must be called before start().
+     * Render jobs for different sources then run concurrently, all other jobs still run one after the other.
+     */
+    void setRenderThreadCount(int count);
+
+    /**
+     * Locks the complete scheduler, waits until the running jobs are done. New jobs are not started while waiting.
      */
     void lock();
 
@@ -104,7 +112,16 @@ public:
 
 private:
     static gpointer jobThreadCallback(Scheduler* scheduler);
-    Job* getNextJobUnlocked(bool onlyNotRender = false, bool* hasRenderJobs = nullptr);
+    static gpointer renderThreadCallback(Scheduler* scheduler);
+
+    /**
+     * The loop of the job threads
+     *
+     * @param onlyRender true for the render threads, which do not run any other jobs
+     */
+    void runJobs(bool onlyRender);
+
+    Job* getNextJobUnlocked(bool onlyNotRender = false, bool* hasRenderJobs = nullptr, bool onlyRender = false);
 
     static bool jobRenderThreadTimer(Scheduler* scheduler);
 
@@ -115,15 +132,41 @@ protected:
 
     GThread* thread = nullptr;
 
+    std::vector<GThread*> renderThreads;
+    int renderThreadCount = 0;
+
     std::condition_variable jobQueueCond{};
     std::mutex jobQueueMutex{};
-    std::mutex schedulerMutex{};
+
+    /**
+     * Held shared by every running job, lock() acquires it exclusively
+     */
+    std::shared_mutex schedulerMutex{};
 
     /**
      * This is need to be sure there is no job running if we delete a page.
      * If a job is, we may access deleted memory.
+     * Held shared by every running job.
+     */
+    std::shared_mutex jobRunningMutex{};
+
+    /**
+     * Sources of the render jobs currently running, a second job for the same source has to wait.
+     * Protected by jobQueueMutex.
+     */
+    std::vector<void*> runningRenderSources;
+
+    /**
+     * Number of threads waiting for all running jobs to finish, no new jobs are started meanwhile.
+     * Protected by jobQueueMutex.
+     */
+    int finishRequests = 0;
+
+    /**
+     * Number of threads waiting in lock(), no new jobs are started meanwhile.
+     * Protected by jobQueueMutex.
      */
-    std::mutex jobRunningMutex{};
+    int lockRequests = 0;
 
     /**
      * Jobs of each priority. New jobs
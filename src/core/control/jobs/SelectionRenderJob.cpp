@@ -0,0 +1,19 @@
+#include "SelectionRenderJob.h"
+
+#include "control/tools/EditSelectionContents.h"
+
+SelectionRenderJob::SelectionRenderJob(EditSelectionContents* selection): selection(selection) {}
+
+void SelectionRenderJob::onDelete() { this->selection = nullptr; }
+
+auto SelectionRenderJob::getSource() -> void* { return this->selection; }
+
+auto SelectionRenderJob::getType() -> JobType { return JOB_TYPE_RENDER; }
+
+void SelectionRenderJob::run() {
+    if (this->selection == nullptr) {
+        return;
+    }
+
+    this->selection->renderInBackground();
+}
@@ -0,0 +1,35 @@
+/*
+ * Xournal++
+ *
+ * A job which renders a scaled selection in the background
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "Job.h"
+
+class EditSelectionContents;
+
+class SelectionRenderJob: public Job {
+public:
+    SelectionRenderJob(EditSelectionContents* selection);
+
+protected:
+    virtual void onDelete() override;
+    virtual ~SelectionRenderJob() = default;
+
+public:
+    virtual void* getSource() override;
+
+    virtual void run() override;
+
+    virtual JobType getType() override;
+
+private:
+    EditSelectionContents* selection;
+};
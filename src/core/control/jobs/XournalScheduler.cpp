@@ -1,9 +1,17 @@
 #include "XournalScheduler.h"
 
+#include <algorithm>
+
 #include "PreviewJob.h"
 #include "RenderJob.h"
+#include "SelectionRenderJob.h"
+
+XournalScheduler::XournalScheduler() {
+    this->name = "XournalScheduler";
 
-XournalScheduler::XournalScheduler() { this->name = "XournalScheduler"; }
+    // Pages are rendered concurrently, but they share the document lock and the caches, so more threads do not help
+    setRenderThreadCount(std::clamp(static_cast<int>(g_get_num_processors()) - 1, 1, 3));
+}
 
 XournalScheduler::~XournalScheduler() = default;
 
@@ -14,7 +22,32 @@ void XournalScheduler::removeSidebar(SidebarPreviewBaseEntry* preview) {
     removeSource(preview, JOB_TYPE_PREVIEW, JOB_PRIORITY_HIGH, waitForTaskCompletion);
 }
 
-void XournalScheduler::removePage(XojPageView* view) { removeSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT); }
+void XournalScheduler::removePendingSidebar(SidebarPreviewBaseEntry* preview) {
+    removeSource(preview, JOB_TYPE_PREVIEW, JOB_PRIORITY_HIGH, false);
+}
+
+void XournalScheduler::removePage(XojPageView* view) {
+    // Render jobs are queued with different priorities, see addRerenderPage()
+    for (int priority = JOB_PRIORITY_URGENT; priority < JOB_N_PRIORITIES; priority++) {
+        removeSource(view, JOB_TYPE_RENDER, static_cast<JobPriority>(priority), false);
+    }
+    finishTask();
+}
+
+void XournalScheduler::removeSelection(EditSelectionContents* selection) {
+    // Waiting for all running jobs would block on e.g. a running save or export
+    removeSource(selection, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT, false);
+    waitForRenderSource(selection);
+}
+
+void XournalScheduler::waitForRenderSource(void* source) {
+    // The source is removed from the running render sources after its job is done, then the condition is notified
+    std::unique_lock lock{this->jobQueueMutex};
+    this->jobQueueCond.wait(lock, [this, source]() {
+        auto& running = this->runningRenderSources;
+        return std::find(running.begin(), running.end(), source) == running.end();
+    });
+}
 
 void XournalScheduler::removeAllJobs() {
     std::lock_guard lock{this->jobQueueMutex};
@@ -43,7 +76,21 @@ void XournalScheduler::removeAllJobs() {
     }
 }
 
-void XournalScheduler::finishTask() { std::lock_guard lock{this->jobRunningMutex}; }
+void XournalScheduler::finishTask() {
+    // Keep the job threads from starting new jobs, otherwise concurrent render jobs could hold the lock forever
+    {
+        std::lock_guard lock{this->jobQueueMutex};
+        this->finishRequests++;
+    }
+
+    { std::lock_guard lock{this->jobRunningMutex}; }
+
+    {
+        std::lock_guard lock{this->jobQueueMutex};
+        this->finishRequests--;
+    }
+    this->jobQueueCond.notify_all();
+}
 
 void XournalScheduler::removeSource(void* source, JobType type, JobPriority priority, bool awaitFinishTask) {
     {
@@ -98,12 +145,46 @@ void XournalScheduler::addRepaintSidebar(SidebarPreviewBaseEntry* preview) {
     job->unref();
 }
 
-void XournalScheduler::addRerenderPage(XojPageView* view) {
-    if (existsSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT)) {
-        return;
+auto XournalScheduler::addRenderSelection(EditSelectionContents* selection) -> bool {
+    if (existsSource(selection, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT)) {
+        return false;
     }
 
-    auto* job = new RenderJob(view);
+    auto* job = new SelectionRenderJob(selection);
     addJob(job, JOB_PRIORITY_URGENT);
     job->unref();
+    return true;
+}
+
+void XournalScheduler::addRerenderPage(XojPageView* view, JobPriority priority) {
+    {
+        std::lock_guard lock{this->jobQueueMutex};
+
+        Job* job = nullptr;
+        for (int p = JOB_PRIORITY_URGENT; p < JOB_N_PRIORITIES && !job; p++) {
+            std::deque<Job*>& queue = *this->jobQueue[p];
+            auto it = std::find_if(queue.begin(), queue.end(), [view](Job* j) {
+                return j->getType() == JOB_TYPE_RENDER && j->getSource() == view;
+            });
+            if (it == queue.end()) {
+                continue;
+            }
+
+            if (p == priority) {
+                return;
+            }
+
+            // Move the queued job, the RenderJob picks up the current state of the view when it runs
+            job = *it;
+            queue.erase(it);
+        }
+
+        if (!job) {
+            // The queue owns the initial reference
+            job = new RenderJob(view);
+        }
+        this->jobQueue[priority]->push_back(job);
+    }
+
+    this->jobQueueCond.notify_all();
 }
@@ -21,6 +21,8 @@
 
 #include "Scheduler.h"
 
+class EditSelectionContents;
+
 class XournalScheduler: public Scheduler {
 public:
     XournalScheduler();
@@ -32,7 +34,15 @@ public:
      * Blocks until all jobs that could be using the source have finished.
      */
     void removeSidebar(SidebarPreviewBaseEntry* preview);
+    /**
+     * Removes the queued PreviewJob of the preview, without waiting for a running one
+     */
+    void removePendingSidebar(SidebarPreviewBaseEntry* preview);
     void removePage(XojPageView* view);
+    /**
+     * Removes the queued SelectionRenderJob of the selection and waits only for a running one of the same selection
+     */
+    void removeSelection(EditSelectionContents* selection);
 
     /**
      * Removes all PreviewJob%s / RenderJob%s scheduled to be run
@@ -40,7 +50,18 @@ public:
     void removeAllJobs();
 
     void addRepaintSidebar(SidebarPreviewBaseEntry* preview);
-    void addRerenderPage(XojPageView* view);
+
+    /**
+     * Queues a SelectionRenderJob, unless one is already waiting. The job renders the size of the last paint request.
+     *
+     * @return true if a new job was queued
+     */
+    bool addRenderSelection(EditSelectionContents* selection);
+    /**
+     * Queues a RenderJob for the page. If one is already queued with another priority, it is moved to the end of the
+     * queue of `priority` instead, so the order of rerenders can be changed, e.g. after zooming.
+     */
+    void addRerenderPage(XojPageView* view, JobPriority priority = JOB_PRIORITY_URGENT);
 
     /**
      * Blocks until all currently running Job%s have been executed
@@ -55,5 +76,10 @@ private:
 
     bool existsSource(void* source, JobType type, JobPriority priority);
 
+    /**
+     * Blocks until no render job of `source` is running anymore
+     */
+    void waitForRenderSource(void* source);
+
 private:
 };
@@ -0,0 +1,94 @@
+#include "LatexCache.h"
+
+#include <algorithm>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <glib.h>
+
+#include "util/PathUtil.h"
+
+LatexCache::LatexCache(fs::path folder, uintmax_t maxSize):
+        folder(folder.empty() ? Util::getCacheSubfolder("tex") : std::move(folder)), maxSize(maxSize) {}
+
+auto LatexCache::key(const std::string& genCmd, const std::string& texContents) -> std::string {
+    GChecksum* checksum = g_checksum_new(G_CHECKSUM_SHA256);
+    g_checksum_update(checksum, reinterpret_cast<const guchar*>(genCmd.data()), genCmd.length());
+    // Separator, so that the boundary between command and file cannot move
+    g_checksum_update(checksum, reinterpret_cast<const guchar*>(""), 1);
+    g_checksum_update(checksum, reinterpret_cast<const guchar*>(texContents.data()), texContents.length());
+    std::string result = g_checksum_get_string(checksum);
+    g_checksum_free(checksum);
+    return result;
+}
+
+auto LatexCache::getFile(const std::string& key) const -> fs::path { return this->folder / (key + ".pdf"); }
+
+auto LatexCache::contains(const std::string& key) const -> bool {
+    std::error_code ec;
+    return fs::is_regular_file(getFile(key), ec);
+}
+
+auto LatexCache::lookup(const std::string& key) const -> std::optional<std::string> {
+    if (!contains(key)) {
+        return std::nullopt;
+    }
+
+    // Mark the file as recently used
+    fs::path file = getFile(key);
+    std::error_code ec;
+    fs::last_write_time(file, fs::file_time_type::clock::now(), ec);
+    return Util::readString(file, false);
+}
+
+void LatexCache::store(const std::string& key, const std::string& pdf) {
+    fs::path file = getFile(key);
+    GError* err = nullptr;
+    if (!g_file_set_contents(file.u8string().c_str(), pdf.data(), static_cast<gssize>(pdf.length()), &err)) {
+        g_warning("Could not write LaTeX cache file %s: %s", file.u8string().c_str(), err->message);
+        g_error_free(err);
+        return;
+    }
+
+    removeLeastRecentlyUsed(file);
+}
+
+void LatexCache::removeLeastRecentlyUsed(const fs::path& keep) const {
+    struct Entry {
+        fs::file_time_type time;
+        uintmax_t size;
+        fs::path file;
+    };
+    std::vector<Entry> entries;
+    uintmax_t size = 0;
+
+    std::error_code ec;
+    for (const auto& entry: fs::directory_iterator(this->folder, ec)) {
+        std::error_code entryEc;
+        auto time = fs::last_write_time(entry.path(), entryEc);
+        auto fileSize = fs::file_size(entry.path(), entryEc);
+        if (entryEc || entry.path().extension() != ".pdf") {
+            continue;
+        }
+        size += fileSize;
+        if (entry.path() != keep) {
+            entries.push_back({time, fileSize, entry.path()});
+        }
+    }
+
+    if (size <= this->maxSize) {
+        return;
+    }
+
+    // Least recently used first
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.time < b.time; });
+    for (const Entry& entry: entries) {
+        if (size <= this->maxSize) {
+            break;
+        }
+        if (fs::remove(entry.file, ec)) {
+            size -= entry.size;
+        }
+    }
+}
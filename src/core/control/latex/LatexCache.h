@@ -0,0 +1,68 @@
+/*
+ * Xournal++
+ *
+ * Cache of generated LaTeX PDFs
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "filesystem.h"
+
+/**
+ * Content addressed store of the PDFs generated from LaTeX files. The key is a hash of the instantiated template (which
+ * contains the formula and the text color) and of the generator command, so a formula is compiled only once, no matter
+ * how often it appears in documents or in the preview.
+ *
+ * The modification time of a file is updated whenever it is used. If the cache grows beyond its size, the least
+ * recently used files are removed.
+ */
+class LatexCache {
+public:
+    static constexpr uintmax_t DEFAULT_MAX_SIZE = 64 * 1024 * 1024;
+
+    /**
+     * @param folder Folder of the cache files, the user cache folder by default
+     * @param maxSize Size of all cache files, in bytes
+     */
+    explicit LatexCache(fs::path folder = {}, uintmax_t maxSize = DEFAULT_MAX_SIZE);
+
+public:
+    /**
+     * @param genCmd The command used to generate the PDF
+     * @param texContents The complete LaTeX file
+     */
+    static std::string key(const std::string& genCmd, const std::string& texContents);
+
+    bool contains(const std::string& key) const;
+
+    /**
+     * @return The PDF, std::nullopt if it is not cached
+     */
+    std::optional<std::string> lookup(const std::string& key) const;
+
+    /**
+     * Stores the PDF. The file is replaced atomically, so other instances of the application never read a partial PDF.
+     */
+    void store(const std::string& key, const std::string& pdf);
+
+private:
+    fs::path getFile(const std::string& key) const;
+
+    /**
+     * Removes the least recently used files until the cache fits into maxSize, `keep` is never removed
+     */
+    void removeLeastRecentlyUsed(const fs::path& keep) const;
+
+private:
+    fs::path folder;
+    uintmax_t maxSize;
+};
@@ -0,0 +1,151 @@
+#include "LatexCompiler.h"
+
+#include <algorithm>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include "util/PathUtil.h"
+#include "util/i18n.h"
+
+struct LatexCompiler::Job {
+    /**
+     * nullptr once the compiler was destroyed
+     */
+    LatexCompiler* compiler = nullptr;
+    std::string key;
+    std::string texContents;
+    std::vector<Callback> callbacks;
+
+    size_t slot = 0;
+    GSubprocess* proc = nullptr;
+    GCancellable* cancellable = nullptr;
+};
+
+LatexCompiler::LatexCompiler(const LatexSettings& settings, fs::path workDir, size_t maxJobs):
+        settings(settings),
+        generator(settings),
+        workDir(std::move(workDir)),
+        maxJobs(maxJobs > 0 ? maxJobs : std::max<size_t>(std::thread::hardware_concurrency(), 1)) {}
+
+LatexCompiler::~LatexCompiler() {
+    for (auto& [key, job]: this->jobs) {
+        if (job->cancellable == nullptr) {
+            // Still queued
+            continue;
+        }
+        // The job frees itself when the cancellation is reported
+        Job* running = job.release();
+        running->compiler = nullptr;
+        g_subprocess_force_exit(running->proc);
+        g_cancellable_cancel(running->cancellable);
+    }
+}
+
+auto LatexCompiler::isCached(const std::string& texContents) const -> bool {
+    return this->cache.contains(LatexCache::key(this->settings.genCmd, texContents));
+}
+
+void LatexCompiler::compile(const std::string& texContents, Callback callback) {
+    std::string key = LatexCache::key(this->settings.genCmd, texContents);
+
+    if (auto it = this->jobs.find(key); it != this->jobs.end()) {
+        it->second->callbacks.push_back(std::move(callback));
+        return;
+    }
+
+    if (auto pdf = this->cache.lookup(key)) {
+        callback({Status::Ok, std::move(*pdf), {}});
+        return;
+    }
+
+    auto job = std::make_unique<Job>();
+    job->compiler = this;
+    job->key = key;
+    job->texContents = texContents;
+    job->callbacks.push_back(std::move(callback));
+
+    this->queue.push_back(job.get());
+    this->jobs.emplace(key, std::move(job));
+    startQueued();
+}
+
+void LatexCompiler::startQueued() {
+    while (!this->queue.empty() && this->running < this->maxJobs) {
+        Job* job = this->queue.front();
+        this->queue.pop_front();
+
+        auto slot = std::find(this->busySlots.begin(), this->busySlots.end(), false);
+        job->slot = static_cast<size_t>(slot - this->busySlots.begin());
+        if (slot == this->busySlots.end()) {
+            this->busySlots.push_back(true);
+        } else {
+            *slot = true;
+        }
+        this->running++;
+
+        fs::path dir = Util::ensureFolderExists(this->workDir / std::to_string(job->slot));
+        auto result = this->generator.asyncRun(dir, job->texContents);
+        if (auto* err = std::get_if<LatexGenerator::GenError>(&result)) {
+            finish(job, {Status::Failed, {}, err->message});
+            // finish() already started the next jobs
+            return;
+        }
+
+        job->proc = std::get<GSubprocess*>(result);
+        job->cancellable = g_cancellable_new();
+        g_subprocess_wait_check_async(job->proc, job->cancellable, reinterpret_cast<GAsyncReadyCallback>(onProcessExit),
+                                      job);
+    }
+}
+
+void LatexCompiler::finish(Job* job, Result result) {
+    this->busySlots[job->slot] = false;
+    this->running--;
+
+    std::vector<Callback> callbacks = std::move(job->callbacks);
+    this->jobs.erase(job->key);
+
+    // Start the next compilations before the callbacks, which may request new ones
+    startQueued();
+    for (const Callback& callback: callbacks) { callback(result); }
+}
+
+void LatexCompiler::onProcessExit(GObject* procObj, GAsyncResult* res, Job* job) {
+    GError* err = nullptr;
+    g_subprocess_wait_check_finish(G_SUBPROCESS(procObj), res, &err);
+    g_clear_object(&job->proc);
+    g_clear_object(&job->cancellable);
+
+    LatexCompiler* self = job->compiler;
+    if (self == nullptr) {
+        // The compiler was destroyed, nobody waits for the result
+        g_clear_error(&err);
+        delete job;
+        return;
+    }
+
+    Result result;
+    fs::path pdfPath = self->workDir / std::to_string(job->slot) / "tex.pdf";
+    if (err != nullptr) {
+        if (g_error_matches(err, G_SPAWN_EXIT_ERROR, 1)) {
+            result.status = Status::InvalidTex;
+        } else {
+            // The error was not caused by invalid LaTeX.
+            result.message =
+                    FS(_F("Latex generation encountered an error: {1} (exit code: {2})") % err->message % err->code);
+            g_warning("latex: %s", result.message.c_str());
+        }
+        g_error_free(err);
+    } else if (auto pdf = Util::readString(pdfPath, false)) {
+        self->cache.store(job->key, *pdf);
+        result = {Status::Ok, std::move(*pdf), {}};
+    } else {
+        result.message = _("Could not load LaTeX PDF file");
+    }
+
+    std::error_code ec;
+    fs::remove(pdfPath, ec);
+
+    self->finish(job, std::move(result));
+}
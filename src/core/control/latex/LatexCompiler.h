@@ -0,0 +1,116 @@
+/*
+ * Xournal++
+ *
+ * Runs LaTeX compilations in parallel
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gio/gio.h>
+
+#include "control/latex/LatexCache.h"
+#include "control/latex/LatexGenerator.h"
+#include "control/settings/LatexSettings.h"
+
+#include "filesystem.h"
+
+/**
+ * Compiles LaTeX files to PDF asynchronously, on the main loop.
+ *
+ * Results are looked up in a LatexCache first. Requests for a file which is already being compiled are attached to
+ * the running compilation instead of starting a new one, and up to `maxJobs` compilations run in parallel, each in
+ * its own folder.
+ */
+class LatexCompiler {
+public:
+    enum class Status {
+        /**
+         * The PDF was generated
+         */
+        Ok,
+
+        /**
+         * LaTeX rejected the input
+         */
+        InvalidTex,
+
+        /**
+         * The generator could not be started or failed, see the message
+         */
+        Failed
+    };
+
+    struct Result {
+        Status status = Status::Failed;
+        std::string pdf;
+        std::string message;
+    };
+
+    using Callback = std::function<void(const Result& result)>;
+
+    /**
+     * @param workDir Folder for the LaTeX files, the compilations use subfolders
+     * @param maxJobs Maximal number of parallel compilations, 0 for one per processor
+     */
+    LatexCompiler(const LatexSettings& settings, fs::path workDir, size_t maxJobs = 0);
+    LatexCompiler(const LatexCompiler&) = delete;
+    LatexCompiler& operator=(const LatexCompiler&) = delete;
+
+    /**
+     * Stops all running compilations, pending callbacks are not called
+     */
+    virtual ~LatexCompiler();
+
+public:
+    /**
+     * Compiles the LaTeX file. The callback is called on the main loop once the PDF is available, or immediately if
+     * it is cached.
+     *
+     * @param texContents The complete LaTeX file, see LatexGenerator::templateSub()
+     */
+    void compile(const std::string& texContents, Callback callback);
+
+    /**
+     * @return true if the PDF of this file is cached, and compile() would call its callback immediately
+     */
+    bool isCached(const std::string& texContents) const;
+
+private:
+    struct Job;
+
+    void startQueued();
+    void finish(Job* job, Result result);
+
+    static void onProcessExit(GObject* procObj, GAsyncResult* res, Job* job);
+
+private:
+    const LatexSettings& settings;
+    LatexGenerator generator;
+    LatexCache cache;
+    fs::path workDir;
+    size_t maxJobs;
+
+    /**
+     * All queued and running compilations, by cache key
+     */
+    std::map<std::string, std::unique_ptr<Job>> jobs;
+    std::deque<Job*> queue;
+
+    /**
+     * The subfolders of workDir which are in use
+     */
+    std::vector<bool> busySlots;
+    size_t running = 0;
+};
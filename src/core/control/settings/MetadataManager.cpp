@@ -2,23 +2,99 @@
 
 #include <algorithm>  // std::sort
 #include <fstream>
+#include <iomanip>
+#include <limits>
+#include <locale>
 #include <sstream>
+#include <utility>
 
-#include <fcntl.h>
 #include <glib.h>
-#include <glib/gstdio.h>
-#include <sys/stat.h>
-#include <sys/types.h>
 
 #include "util/PathUtil.h"
-#include "util/XojMsgBox.h"
 
 using namespace std;
 
+namespace {
+constexpr auto LOG_HEADER = "XOJ-METADATA-LOG/1.0";
+
+/**
+ * Number of documents kept when the log is compacted
+ */
+constexpr size_t MAX_ENTRIES = 1000;
+
+/**
+ * The log is compacted when it has this many more lines than twice the number of documents
+ */
+constexpr size_t COMPACT_SLACK = 100;
+
+/**
+ * Parses a line of the log: time, page, zoom and the path of the document, separated by tabs
+ */
+auto parseEntry(const string& line, MetadataEntry& entry) -> bool {
+    istringstream fields(line);
+    fields.imbue(std::locale::classic());
+
+    fields >> entry.time >> entry.page >> entry.zoom;
+    if (!fields || fields.get() != '\t') {
+        return false;
+    }
+
+    string path;
+    if (!getline(fields, path) || path.empty()) {
+        return false;
+    }
+    entry.path = fs::u8path(path);
+    entry.valid = true;
+    return true;
+}
+
+/**
+ * Adds the entry to the index, unless the index already contains a newer entry of the document
+ */
+void mergeEntry(unordered_map<string, MetadataEntry>& index, const MetadataEntry& entry) {
+    MetadataEntry& current = index[entry.path.u8string()];
+    if (!current.valid || current.time <= entry.time) {
+        current = entry;
+    }
+}
+
+/**
+ * Merges the entries of the log into the index
+ *
+ * @param entries Is set to the number of valid lines of the log
+ * @return false if the log is damaged
+ */
+auto readLog(ifstream& in, unordered_map<string, MetadataEntry>& index, size_t& entries) -> bool {
+    entries = 0;
+
+    string line;
+    if (!getline(in, line) || line != LOG_HEADER) {
+        return false;
+    }
+
+    bool damaged = false;
+    while (getline(in, line)) {
+        MetadataEntry entry;
+        if (!parseEntry(line, entry)) {
+            // E.g. a line cut off by a crash
+            damaged = true;
+            continue;
+        }
+        entries++;
+        mergeEntry(index, entry);
+    }
+    return !damaged;
+}
+}  // namespace
+
 MetadataEntry::MetadataEntry(): valid(false), zoom(1), page(0), time(0) {}
 
 
-MetadataManager::MetadataManager(): metadata(nullptr) {}
+MetadataManager::MetadataManager():
+        MetadataManager(Util::getConfigFile("metadata.log"), Util::getConfigFolder() / "metadata") {}
+
+MetadataManager::MetadataManager(fs::path logFile, fs::path legacyFolder):
+        metadata(nullptr), logFile(std::move(logFile)), legacyFolder(std::move(legacyFolder)) {}
 
 MetadataManager::~MetadataManager() { documentChanged(); }
 
@@ -54,33 +130,55 @@ void MetadataManager::documentChanged() {
     delete m;
 }
 
-auto sortMetadata(MetadataEntry& a, MetadataEntry& b) -> bool { return a.time > b.time; }
+void MetadataManager::loadIndex() {
+    if (this->indexLoaded) {
+        return;
+    }
+    this->indexLoaded = true;
 
-/**
- * Load the metadata list (sorted)
- */
-auto MetadataManager::loadList() -> vector<MetadataEntry> {
-    auto folder = Util::getConfigSubfolder("metadata");
+    ifstream in(this->logFile);
+    if (!in) {
+        importLegacyFolder();
+        return;
+    }
 
-    vector<MetadataEntry> data;
-    try {
-        for (auto const& f: fs::directory_iterator(folder)) {
-            auto path = folder / f;
+    if (!readLog(in, this->index, this->logEntries)) {
+        // Otherwise the next line would be appended to the damaged one
+        compact();
+    }
+}
 
-            MetadataEntry entry = loadMetadataFile(path, f.path());
+void MetadataManager::importLegacyFolder() {
+    vector<fs::path> files;
+    std::error_code ec;
+    if (fs::is_directory(this->legacyFolder, ec)) {
+        for (auto const& f: fs::directory_iterator(this->legacyFolder, ec)) {
+            if (f.path().extension() != ".metadata") {
+                continue;
+            }
+            files.push_back(f.path());
 
-            if (entry.valid) {
-                data.push_back(entry);
+            MetadataEntry entry = loadMetadataFile(f.path(), f.path());
+            if (!entry.valid) {
+                continue;
             }
+            mergeEntry(this->index, entry);
         }
-    } catch (fs::filesystem_error& e) {
-        XojMsgBox::showErrorToUser(nullptr, e.what());
-        return data;
     }
 
-    std::sort(data.begin(), data.end(), sortMetadata);
+    // Also writes an empty log, so the folder is only searched once
+    compact();
+    if (!fs::exists(this->logFile, ec)) {
+        return;
+    }
 
-    return data;
+    for (const fs::path& file: files) {
+        if (fs::exists(file, ec)) {
+            deleteMetadataFile(file);
+        }
+    }
+    // Only succeeds if the folder is empty now
+    fs::remove(this->legacyFolder, ec);
 }
 
 /**
@@ -128,51 +226,83 @@ auto MetadataManager::loadMetadataFile(fs::path const& path, fs::path const& fil
     return entry;
 }
 
+auto MetadataManager::formatEntry(const MetadataEntry& entry) -> string {
+    ostringstream line;
+    line.imbue(std::locale::classic());
+    line << setprecision(numeric_limits<double>::max_digits10);
+    line << entry.time << '\t' << entry.page << '\t' << entry.zoom << '\t' << entry.path.u8string() << '\n';
+    return line.str();
+}
+
+void MetadataManager::compact() {
+    // Other instances may have appended to the log since it was loaded, their entries must not be lost
+    ifstream in(this->logFile);
+    if (in) {
+        size_t entries = 0;
+        readLog(in, this->index, entries);
+        in.close();
+    }
+
+    vector<pair<gint64, string>> entries;
+    entries.reserve(this->index.size());
+    for (const auto& [key, entry]: this->index) { entries.emplace_back(entry.time, key); }
+
+    // Most recent first
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    for (size_t i = MAX_ENTRIES; i < entries.size(); i++) { this->index.erase(entries[i].second); }
+    entries.resize(std::min(entries.size(), MAX_ENTRIES));
+
+    string data = string(LOG_HEADER) + "\n";
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) { data += formatEntry(this->index[it->second]); }
+
+    // Replaces the log atomically
+    GError* err = nullptr;
+    if (!g_file_set_contents(this->logFile.u8string().c_str(), data.data(), static_cast<gssize>(data.length()),
+                             &err)) {
+        g_warning("Could not write metadata file %s: %s", this->logFile.u8string().c_str(), err->message);
+        g_error_free(err);
+    }
+    this->logEntries = entries.size();
+}
+
 /**
  * Get the metadata for a file
  */
 auto MetadataManager::getForFile(fs::path const& file) -> MetadataEntry {
-    vector<MetadataEntry> files = loadList();
+    std::lock_guard lock(this->indexMutex);
+    loadIndex();
 
-    MetadataEntry entry;
-    for (const MetadataEntry& e: files) {
-        if (e.path == file) {
-            entry = e;
-            break;
-        }
-    }
-
-    for (int i = 20; i < static_cast<int>(files.size()); i++) {
-        auto path = files[i].metadataFile;
-        deleteMetadataFile(path);
+    auto it = this->index.find(file.u8string());
+    if (it == this->index.end()) {
+        return MetadataEntry();
     }
-
-    return entry;
+    return it->second;
 }
 
 /**
  * Store metadata to file
  */
 void MetadataManager::storeMetadata(MetadataEntry* m) {
-    vector<MetadataEntry> files = loadList();
-    for (const MetadataEntry& e: files) {
-        if (e.path == m->path) {
-            // This is an old entry with the same path
-            deleteMetadataFile(e.metadataFile);
-        }
+    if (m->path.u8string().find('\n') != string::npos) {
+        // Cannot be stored in a line of the log
+        return;
     }
 
-    auto path = Util::getConfigSubfolder("metadata");
-    gint64 time = g_get_real_time();
-    path /= std::to_string(time);
-    path += ".metadata";
+    std::lock_guard lock(this->indexMutex);
+    loadIndex();
 
-    ofstream out(path);
-    out << "XOJ-METADATA/1.0\n";
-    out << m->path << "\n";
-    out << "page=" << m->page << "\n";
-    out << "zoom=" << m->zoom << "\n";
-    out.close();
+    this->index[m->path.u8string()] = *m;
+    if (this->logEntries + 1 >= 2 * this->index.size() + COMPACT_SLACK || this->index.size() > MAX_ENTRIES) {
+        compact();
+        return;
+    }
+
+    ofstream out(this->logFile, ios::app | ios::binary);
+    out << formatEntry(*m);
+    if (!out) {
+        g_warning("Could not write metadata file %s", this->logFile.u8string().c_str());
+    }
+    this->logEntries++;
 }
 
 /**
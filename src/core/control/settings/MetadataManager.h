@@ -11,8 +11,10 @@
 
 #pragma once
 
+#include <cstddef>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <glib.h>
@@ -33,16 +35,30 @@ public:
     gint64 time;
 };
 
+/**
+ * Stores the page and zoom of recently opened documents.
+ *
+ * All entries are kept in one log file, each change is appended as a line and the latest line of a document wins.
+ * The log is read once into an index, so looking up a document does not touch the disk again. When the log contains
+ * many outdated lines it is compacted, i.e. rewritten with only the current entries of the most recent documents.
+ */
 class MetadataManager {
 public:
     MetadataManager();
+
+    /**
+     * @param logFile The file containing the entries
+     * @param legacyFolder Folder with one file per entry, as written by older versions. Its entries are imported
+     *                     into the log if the log does not exist yet.
+     */
+    MetadataManager(fs::path logFile, fs::path legacyFolder);
     virtual ~MetadataManager();
 
 public:
     /**
      * Get the metadata for a file
      */
-    static MetadataEntry getForFile(fs::path const& file);
+    MetadataEntry getForFile(fs::path const& file);
 
     /**
      * Store the current data into metadata
@@ -61,23 +77,54 @@ private:
     static void deleteMetadataFile(fs::path const& path);
 
     /**
-     * Parse a single metadata file
+     * Parse a single metadata file of the legacy folder
      */
     static MetadataEntry loadMetadataFile(fs::path const& path, fs::path const& file);
 
     /**
-     * Store metadata to file
+     * Adds the entry to the index and appends it to the log
      */
-    static void storeMetadata(MetadataEntry* m);
+    void storeMetadata(MetadataEntry* m);
 
 private:
     /**
-     * Load the metadata list (sorted)
+     * Reads the log into the index, on the first call only. The indexMutex must be locked.
      */
-    static std::vector<MetadataEntry> loadList();
+    void loadIndex();
 
+    /**
+     * Imports and deletes the files of the legacy folder
+     */
+    void importLegacyFolder();
+
+    /**
+     * Rewrites the log with the current entries of the most recent documents. The entries which other instances
+     * appended to the log in the meantime are merged into the index before. The indexMutex must be locked.
+     */
+    void compact();
+
+    /**
+     * @return The log line of an entry, with a trailing newline
+     */
+    static std::string formatEntry(const MetadataEntry& entry);
 
 private:
     std::mutex mutex;
     MetadataEntry* metadata;
+
+    fs::path logFile;
+    fs::path legacyFolder;
+
+    std::mutex indexMutex;
+    bool indexLoaded = false;
+
+    /**
+     * Latest entry of each document, by the UTF-8 path of the document
+     */
+    std::unordered_map<std::string, MetadataEntry> index;
+
+    /**
+     * Number of entries in the log, including outdated ones
+     */
+    size_t logEntries = 0;
 };
@@ -1,11 +1,13 @@
 #include "Settings.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <utility>
 
 #include "control/DeviceListHelper.h"
 #include "model/FormatDefinitions.h"
 #include "util/PathUtil.h"
+#include "util/RasterCache.h"
 #include "util/Util.h"
 #include "util/i18n.h"
 
@@ -18,6 +20,16 @@ using std::string;
 constexpr auto const* DEFAULT_FONT = "Sans";
 constexpr auto DEFAULT_FONT_SIZE = 12;
 
+/**
+ * Time without changes after which the settings are written, in ms
+ */
+constexpr guint SAVE_DELAY = 500;
+
+/**
+ * Below this the rasters of a single page would evict each other, in MiB
+ */
+constexpr int MIN_RASTER_CACHE_SIZE = 32;
+
 #define SAVE_BOOL_PROP(var) xmlNode = saveProperty((const char*)#var, (var) ? "true" : "false", root)
 #define SAVE_STRING_PROP(var) xmlNode = saveProperty((const char*)#var, (var).empty() ? "" : (var).c_str(), root)
 #define SAVE_INT_PROP(var) xmlNode = saveProperty((const char*)#var, var, root)
@@ -27,9 +39,12 @@ constexpr auto DEFAULT_FONT_SIZE = 12;
     com = xmlNewComment((const xmlChar*)(var)); \
     xmlAddPrevSibling(xmlNode, com);
 
-Settings::Settings(fs::path filepath): filepath(std::move(filepath)) { loadDefault(); }
+Settings::Settings(fs::path filepath): filepath(std::move(filepath)), writer(this->filepath) { loadDefault(); }
 
 Settings::~Settings() {
+    // Needs the button configuration
+    flush();
+
     for (auto& i: this->buttonConfig) {
         delete i;
         i = nullptr;
@@ -100,6 +115,13 @@ void Settings::loadDefault() {
     this->autosaveTimeout = 3;
     this->autosaveEnabled = true;
 
+    // zlib default, see GzOutputStream
+    this->saveCompressionLevel = -1;
+
+    this->incrementalPdfExport = true;
+
+    this->rasterCacheSize = static_cast<int>(RasterBudget::DEFAULT_MEMORY_LIMIT / (1024 * 1024));
+
     this->addHorizontalSpace = false;
     this->addHorizontalSpaceAmount = 150;
     this->addVerticalSpace = false;
@@ -423,6 +445,15 @@ void Settings::parseItem(xmlDocPtr doc, xmlNodePtr cur) {
         this->autosaveEnabled = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("autosaveTimeout")) == 0) {
         this->autosaveTimeout = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("saveCompressionLevel")) == 0) {
+        this->saveCompressionLevel =
+                std::clamp(static_cast<int>(g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10)), -1, 9);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("incrementalPdfExport")) == 0) {
+        this->incrementalPdfExport = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("rasterCacheSize")) == 0) {
+        this->rasterCacheSize = std::max(
+                static_cast<int>(g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10)),
+                MIN_RASTER_CACHE_SIZE);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("fullscreenHideElements")) == 0) {
         this->fullscreenHideElements = reinterpret_cast<const char*>(value);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("presentationHideElements")) == 0) {
@@ -796,6 +827,44 @@ void Settings::save() {
         return;
     }
 
+    this->dirty = true;
+    if (this->saveTimeout != 0) {
+        // Restart the delay, rapid changes are written together
+        g_source_remove(this->saveTimeout);
+    }
+    this->saveTimeout = g_timeout_add(SAVE_DELAY, reinterpret_cast<GSourceFunc>(saveTimeoutCallback), this);
+}
+
+auto Settings::saveTimeoutCallback(Settings* settings) -> bool {
+    settings->saveTimeout = 0;
+    settings->writeIfDirty();
+    return false;
+}
+
+void Settings::flush() {
+    if (this->saveTimeout != 0) {
+        g_source_remove(this->saveTimeout);
+        this->saveTimeout = 0;
+    }
+    writeIfDirty();
+    this->writer.flush();
+}
+
+void Settings::writeIfDirty() {
+    if (!this->dirty || this->inTransaction) {
+        return;
+    }
+    this->dirty = false;
+
+    std::string data = serialize();
+    if (data == this->savedData) {
+        return;
+    }
+    this->savedData = data;
+    this->writer.write(std::move(data));
+}
+
+auto Settings::serialize() -> std::string {
     xmlDocPtr doc = nullptr;
     xmlNodePtr root = nullptr;
     xmlNodePtr xmlNode = nullptr;
@@ -804,7 +873,7 @@ void Settings::save() {
 
     doc = xmlNewDoc(reinterpret_cast<const xmlChar*>("1.0"));
     if (doc == nullptr) {
-        return;
+        return {};
     }
 
     saveButtonConfig();
@@ -898,6 +967,9 @@ void Settings::save() {
 
     SAVE_BOOL_PROP(autosaveEnabled);
     SAVE_INT_PROP(autosaveTimeout);
+    SAVE_INT_PROP(saveCompressionLevel);
+    SAVE_BOOL_PROP(incrementalPdfExport);
+    SAVE_INT_PROP(rasterCacheSize);
 
     SAVE_BOOL_PROP(addHorizontalSpace);
     SAVE_INT_PROP(addHorizontalSpaceAmount);
@@ -1000,8 +1072,13 @@ void Settings::save() {
 
     for (std::map<string, SElement>::value_type p: data) { saveData(root, p.first, p.second); }
 
-    xmlSaveFormatFileEnc(filepath.u8string().c_str(), doc, "UTF-8", 1);
+    xmlChar* buffer = nullptr;
+    int size = 0;
+    xmlDocDumpFormatMemoryEnc(doc, &buffer, &size, "UTF-8", 1);
+    std::string result(reinterpret_cast<const char*>(buffer), static_cast<size_t>(size));
+    xmlFree(buffer);
     xmlFreeDoc(doc);
+    return result;
 }
 
 void Settings::saveData(xmlNodePtr root, const string& name, SElement& elem) {
@@ -1124,6 +1201,44 @@ void Settings::setAutosaveTimeout(int autosave) {
     save();
 }
 
+auto Settings::getSaveCompressionLevel() const -> int { return this->saveCompressionLevel; }
+
+void Settings::setSaveCompressionLevel(int level) {
+    level = std::clamp(level, -1, 9);
+    if (this->saveCompressionLevel == level) {
+        return;
+    }
+
+    this->saveCompressionLevel = level;
+
+    save();
+}
+
+auto Settings::isIncrementalPdfExport() const -> bool { return this->incrementalPdfExport; }
+
+void Settings::setIncrementalPdfExport(bool incremental) {
+    if (this->incrementalPdfExport == incremental) {
+        return;
+    }
+
+    this->incrementalPdfExport = incremental;
+
+    save();
+}
+
+auto Settings::getRasterCacheSize() const -> int { return this->rasterCacheSize; }
+
+void Settings::setRasterCacheSize(int mebibytes) {
+    mebibytes = std::max(mebibytes, MIN_RASTER_CACHE_SIZE);
+    if (this->rasterCacheSize == mebibytes) {
+        return;
+    }
+
+    this->rasterCacheSize = mebibytes;
+
+    save();
+}
+
 auto Settings::isAutosaveEnabled() const -> bool { return this->autosaveEnabled; }
 
 void Settings::setAutosaveEnabled(bool autosave) {
@@ -25,6 +25,7 @@
 
 #include "LatexSettings.h"
 #include "SettingsEnums.h"
+#include "SettingsWriter.h"
 #include "filesystem.h"
 
 constexpr auto DEFAULT_GRID_SIZE = 14.17;
@@ -95,10 +96,34 @@ public:
     bool load();
     void parseData(xmlNodePtr cur, SElement& elem);
 
+    /**
+     * Marks the settings as changed. They are written shortly after the last change, in the background, so rapid
+     * changes (e.g. of tools or colors) only cause one write.
+     */
     void save();
 
+    /**
+     * Writes changed settings immediately and waits until they are on the disk
+     */
+    void flush();
+
 private:
     void loadDefault();
+
+    /**
+     * Called when no change happened for SAVE_DELAY
+     */
+    static bool saveTimeoutCallback(Settings* settings);
+
+    /**
+     * Serializes the settings and queues them for the writer, if they changed since the last write
+     */
+    void writeIfDirty();
+
+    /**
+     * @return The content of the settings file
+     */
+    std::string serialize();
     void parseItem(xmlDocPtr doc, xmlNodePtr cur);
 
     static xmlNodePtr savePropertyDouble(const gchar* key, double value, xmlNodePtr parent);
@@ -253,6 +278,24 @@ public:
     bool isAutosaveEnabled() const;
     void setAutosaveEnabled(bool autosave);
 
+    /**
+     * zlib compression level of saved documents, 0 (none) to 9 (best), -1 for the default
+     */
+    int getSaveCompressionLevel() const;
+    void setSaveCompressionLevel(int level);
+
+    /**
+     * Export as PDF only renders the pages which changed since the last export to the same file
+     */
+    bool isIncrementalPdfExport() const;
+    void setIncrementalPdfExport(bool incremental);
+
+    /**
+     * Memory for the decoded images and the rasters of TeX, backgrounds and layers, in MiB. Applied on startup.
+     */
+    int getRasterCacheSize() const;
+    void setRasterCacheSize(int mebibytes);
+
     bool getAddVerticalSpace() const;
     void setAddVerticalSpace(bool space);
     int getAddVerticalSpaceAmount() const;
@@ -783,6 +826,21 @@ private:
      */
     bool autosaveEnabled{};
 
+    /**
+     * Compression level of saved documents
+     */
+    int saveCompressionLevel{};
+
+    /**
+     * Re-export PDFs incrementally
+     */
+    bool incrementalPdfExport{};
+
+    /**
+     * Memory budget of the render caches, in MiB
+     */
+    int rasterCacheSize{};
+
     /**
      * Allow scroll outside the page display area (horizontal)
      */
@@ -992,6 +1050,23 @@ private:
      */
     bool inTransaction{};
 
+    /**
+     * The settings were changed since they were last serialized
+     */
+    bool dirty{};
+
+    /**
+     * Pending timeout of save(), 0 if none
+     */
+    guint saveTimeout{};
+
+    /**
+     * The last content given to the writer, identical content is not written again
+     */
+    std::string savedData;
+
+    SettingsWriter writer;
+
     /** The preferred locale as its language code
      * e.g. "en_US"
      */
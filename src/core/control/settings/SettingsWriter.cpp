@@ -0,0 +1,68 @@
+#include "SettingsWriter.h"
+
+#include <utility>
+
+#include <glib.h>
+
+SettingsWriter::SettingsWriter(fs::path file): file(std::move(file)) {}
+
+SettingsWriter::~SettingsWriter() {
+    {
+        std::lock_guard lock(this->mutex);
+        this->stop = true;
+    }
+    this->condition.notify_all();
+
+    if (this->thread.joinable()) {
+        this->thread.join();
+    }
+}
+
+void SettingsWriter::write(std::string data) {
+    {
+        std::lock_guard lock(this->mutex);
+        this->pending = std::move(data);
+        if (!this->thread.joinable()) {
+            this->thread = std::thread(&SettingsWriter::run, this);
+        }
+    }
+    this->condition.notify_all();
+}
+
+void SettingsWriter::flush() {
+    std::unique_lock lock(this->mutex);
+    this->condition.wait(lock, [this]() { return !this->pending && !this->writing; });
+}
+
+void SettingsWriter::run() {
+    std::unique_lock lock(this->mutex);
+    while (true) {
+        this->condition.wait(lock, [this]() { return this->pending || this->stop; });
+        if (!this->pending) {
+            // Stopped and everything is written
+            return;
+        }
+
+        std::string data = std::move(*this->pending);
+        this->pending.reset();
+        this->writing = true;
+
+        lock.unlock();
+        writeFile(this->file, data);
+        lock.lock();
+
+        this->writing = false;
+        this->condition.notify_all();
+    }
+}
+
+auto SettingsWriter::writeFile(const fs::path& file, const std::string& data) -> bool {
+    // Writes a temporary file in the same folder and renames it
+    GError* err = nullptr;
+    if (!g_file_set_contents(file.u8string().c_str(), data.data(), static_cast<gssize>(data.length()), &err)) {
+        g_warning("Could not write settings file %s: %s", file.u8string().c_str(), err->message);
+        g_error_free(err);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,76 @@
+/*
+ * Xournal++
+ *
+ * Writes the settings file in the background
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "filesystem.h"
+
+/**
+ * Writes a file on a worker thread, so the UI never waits for the disk.
+ *
+ * The file is replaced atomically (the data is written to a temporary file which is renamed over the old one), so a
+ * crash while writing never leaves a truncated settings file behind. Data queued while a write is running replaces
+ * older queued data, only the latest state is written.
+ */
+class SettingsWriter {
+public:
+    SettingsWriter(fs::path file);
+    SettingsWriter(const SettingsWriter&) = delete;
+    void operator=(const SettingsWriter&) = delete;
+
+    /**
+     * Writes the queued data and stops the worker thread
+     */
+    ~SettingsWriter();
+
+public:
+    /**
+     * Queues the new content of the file, the worker thread is started on the first call
+     */
+    void write(std::string data);
+
+    /**
+     * Blocks until the queued data is written
+     */
+    void flush();
+
+    /**
+     * Replaces the file atomically
+     *
+     * @return false if the file could not be written, the error is logged
+     */
+    static bool writeFile(const fs::path& file, const std::string& data);
+
+private:
+    void run();
+
+private:
+    fs::path file;
+
+    std::mutex mutex;
+
+    /**
+     * Notified when data is queued, when a write is finished and on shutdown
+     */
+    std::condition_variable condition;
+
+    std::optional<std::string> pending;
+    bool writing = false;
+    bool stop = false;
+
+    std::thread thread;
+};
@@ -15,6 +15,9 @@ Inertia::Inertia() {
 
 Inertia::Inertia(const Inertia& inertia) { *this = inertia; }
 
+Inertia::Inertia(double mass, double sx, double sy, double sxx, double sxy, double syy):
+        mass(mass), sx(sx), sy(sy), sxx(sxx), sxy(sxy), syy(syy) {}
+
 Inertia::~Inertia() = default;
 
 auto Inertia::centerX() const -> double { return this->sx / this->mass; }
@@ -21,6 +21,7 @@ class Inertia {
 public:
     Inertia();
     Inertia(const Inertia& inertia);
+    Inertia(double mass, double sx, double sy, double sxx, double sxy, double syy);
     virtual ~Inertia();
 
 public:
@@ -0,0 +1,64 @@
+#include "InertiaTable.h"
+
+#include <cmath>
+
+#include "model/Point.h"
+
+void InertiaTable::update(const std::vector<Point>& points) {
+    if (points.empty()) {
+        return;
+    }
+
+    size_t i = this->prefix.size();
+    if (i == 0) {
+        this->originX = points.front().x;
+        this->originY = points.front().y;
+        this->lastX = 0;
+        this->lastY = 0;
+        this->prefix.push_back({});
+        i = 1;
+    }
+
+    this->prefix.reserve(points.size());
+    for (; i < points.size(); i++) {
+        double x = points[i].x - this->originX;
+        double y = points[i].y - this->originY;
+
+        // Same weighting as Inertia::increase, the mass is at the start of the segment
+        double dm = hypot(x - this->lastX, y - this->lastY);
+        Sums s = this->prefix.back();
+        s.mass += dm;
+        s.sx += dm * this->lastX;
+        s.sy += dm * this->lastY;
+        s.sxx += dm * this->lastX * this->lastX;
+        s.sxy += dm * this->lastX * this->lastY;
+        s.syy += dm * this->lastY * this->lastY;
+        this->prefix.push_back(s);
+
+        this->lastX = x;
+        this->lastY = y;
+    }
+}
+
+void InertiaTable::clear() { this->prefix.clear(); }
+
+auto InertiaTable::size() const -> int { return static_cast<int>(this->prefix.size()); }
+
+auto InertiaTable::get(int start, int end) const -> Inertia {
+    // Inertia::calc uses the segments start...end-2
+    if (end - 1 <= start) {
+        return Inertia();
+    }
+
+    const Sums& a = this->prefix[start];
+    const Sums& b = this->prefix[end - 1];
+    double m = b.mass - a.mass;
+    double sx = b.sx - a.sx;
+    double sy = b.sy - a.sy;
+
+    // Move the relative sums back to page coordinates
+    double ox = this->originX;
+    double oy = this->originY;
+    return Inertia(m, sx + m * ox, sy + m * oy, (b.sxx - a.sxx) + 2 * ox * sx + m * ox * ox,
+                   (b.sxy - a.sxy) + ox * sy + oy * sx + m * ox * oy, (b.syy - a.syy) + 2 * oy * sy + m * oy * oy);
+}
@@ -0,0 +1,63 @@
+/*
+ * Xournal++
+ *
+ * Part of the Xournal shape recognizer
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "Inertia.h"
+
+class Point;
+
+/**
+ * Prefix sums of the segment inertia of a stroke, so the inertia of any range of points is available in constant time.
+ *
+ * The sums are taken relative to the first point to keep the precision for long strokes.
+ */
+class InertiaTable {
+public:
+    /**
+     * Adds the points which were appended to the stroke since the last call, the other points must not have changed
+     */
+    void update(const std::vector<Point>& points);
+
+    void clear();
+
+    /**
+     * Number of points in the table
+     */
+    int size() const;
+
+    /**
+     * @return The same as Inertia::calc(pt, start, end)
+     */
+    Inertia get(int start, int end) const;
+
+private:
+    struct Sums {
+        double mass;
+        double sx;
+        double sy;
+        double sxx;
+        double sxy;
+        double syy;
+    };
+
+    /**
+     * Sums of the segments before each point
+     */
+    std::vector<Sums> prefix;
+
+    double originX = 0;
+    double originY = 0;
+    double lastX = 0;
+    double lastY = 0;
+};
@@ -9,6 +9,12 @@
 #include "CircleRecognizer.h"
 #include "Inertia.h"
 
+/**
+ * Shorter ranges are summed directly: their determinant is close to 0 / 0 and the difference of two prefix sums
+ * would only add noise
+ */
+constexpr int DIRECT_INERTIA_POINTS = 16;
+
 ShapeRecognizer::ShapeRecognizer() {
     resetRecognizer();
     this->stroke = nullptr;
@@ -21,8 +27,11 @@ void ShapeRecognizer::resetRecognizer() {
     RDEBUG("reset");
     this->queue = {};
     this->queueLength = 0;
+    this->inertia.clear();
 }
 
+void ShapeRecognizer::updateInertia(const Stroke* stroke) { this->inertia.update(stroke->getPointVector()); }
+
 /**
  *  Test if segments form standard shapes
  */
@@ -94,7 +103,8 @@ auto ShapeRecognizer::tryRectangle() -> Stroke* {
 /*
  * check if something is a polygonal line with at most nsides sides
  */
-auto ShapeRecognizer::findPolygonal(const Point* pt, int start, int end, int nsides, int* breaks, Inertia* ss) -> int {
+auto ShapeRecognizer::findPolygonal(const Point* pt, int start, int end, int nsides, int* breaks,
+                                     Inertia* ss) const -> int {
     Inertia s;
     int i1 = 0, i2 = 0, n1 = 0, n2 = 0;
 
@@ -115,7 +125,11 @@ auto ShapeRecognizer::findPolygonal(const Point* pt, int start, int end, int nsi
     for (; k < nsides; k++) {
         i1 = start + (k * (end - start)) / nsides;
         i2 = start + ((k + 1) * (end - start)) / nsides;
-        s.calc(pt, i1, i2);
+        if (i2 - i1 < DIRECT_INERTIA_POINTS) {
+            s.calc(pt, i1, i2);
+        } else {
+            s = this->inertia.get(i1, i2);
+        }
         if (s.det() < LINE_MAX_DET) {
             break;
         }
@@ -244,6 +258,8 @@ auto ShapeRecognizer::recognizePatterns(Stroke* stroke) -> Stroke* {
         return nullptr;
     }
 
+    updateInertia(stroke);
+
     Inertia ss[4];
     int brk[5] = {0};
 
@@ -318,7 +334,7 @@ auto ShapeRecognizer::recognizePatterns(Stroke* stroke) -> Stroke* {
     }
 
     // not a polygon: maybe a circle ?
-    Stroke* s = CircleRecognizer::recognize(stroke);
+    Stroke* s = CircleRecognizer::recognize(stroke, this->inertia.get(0, stroke->getPointCount()));
     if (s) {
         RDEBUG("return circle");
         return s;
@@ -14,6 +14,7 @@
 #include <array>
 
 #include "CircleRecognizer.h"
+#include "InertiaTable.h"
 #include "RecoSegment.h"
 #include "ShapeRecognizerConfig.h"
 
@@ -28,17 +29,25 @@ public:
     Stroke* recognizePatterns(Stroke* stroke);
     void resetRecognizer();
 
+    /**
+     * Adds the points drawn since the last call to the inertia table. Called while the stroke is drawn, so
+     * recognizePatterns() only has to process the last points.
+     */
+    void updateInertia(const Stroke* stroke);
+
 private:
     Stroke* tryRectangle();
     // function Stroke* tryArrow(); removed after commit a3f7a251282dcfea8b4de695f28ce52bf2035da2
 
     static void optimizePolygonal(const Point* pt, int nsides, int* breaks, Inertia* ss);
 
-    int findPolygonal(const Point* pt, int start, int end, int nsides, int* breaks, Inertia* ss);
+    int findPolygonal(const Point* pt, int start, int end, int nsides, int* breaks, Inertia* ss) const;
 
 private:
     std::array<RecoSegment, MAX_POLYGON_SIDES + 1> queue{};
     int queueLength;
 
     Stroke* stroke;
+
+    InertiaTable inertia;
 };
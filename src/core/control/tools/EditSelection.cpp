@@ -1041,6 +1041,11 @@ void EditSelection::drawDeleteRect(cairo_t* cr, double x, double y, double zoom)
 auto EditSelection::getView() -> XojPageView* { return this->view; }
 
 void EditSelection::serialize(ObjectOutputStream& out) const {
+    serializeBounds(out);
+    serializeElements(out, *this->getElements());
+}
+
+void EditSelection::serializeBounds(ObjectOutputStream& out) const {
     out.writeObject("EditSelection");
 
     out.writeDouble(this->x);
@@ -1055,9 +1060,21 @@ void EditSelection::serialize(ObjectOutputStream& out) const {
 
     this->contents->serialize(out);
     out.endObject();
+}
+
+void EditSelection::serializeElements(ObjectOutputStream& out, const std::vector<Element*>& elements) {
+    // Strokes make up most of the data, allocate it once
+    size_t bytes = 0;
+    for (Element* e: elements) {
+        bytes += 256;
+        if (e->getType() == ELEMENT_STROKE) {
+            bytes += static_cast<size_t>(dynamic_cast<Stroke*>(e)->getPointCount()) * sizeof(Point);
+        }
+    }
+    out.reserve(bytes);
 
-    out.writeInt(static_cast<int>(this->getElements()->size()));
-    for (Element* e: *this->getElements()) { e->serialize(out); }
+    out.writeInt(static_cast<int>(elements.size()));
+    for (Element* e: elements) { e->serialize(out); }
 }
 
 void EditSelection::readSerialized(ObjectInputStream& in) {
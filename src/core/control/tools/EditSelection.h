@@ -243,6 +243,17 @@ public:
     void serialize(ObjectOutputStream& out) const;
     void readSerialized(ObjectInputStream& in);
 
+    /**
+     * Writes the first part of serialize(), the position and size. serializeElements() has to follow, e.g. later with
+     * a copy of the elements.
+     */
+    void serializeBounds(ObjectOutputStream& out) const;
+
+    /**
+     * Writes the second part of serialize()
+     */
+    static void serializeElements(ObjectOutputStream& out, const std::vector<Element*>& elements);
+
 private:
     /**
      * Draws an indicator where you can scale the selection
@@ -1,7 +1,10 @@
 #include "EditSelectionContents.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <memory>
+#include <thread>
 
 #include "control/Control.h"
 #include "gui/PageView.h"
@@ -22,6 +25,7 @@
 #include "undo/ScaleUndoAction.h"
 #include "undo/SizeUndoAction.h"
 #include "undo/UndoRedoHandler.h"
+#include "util/Util.h"
 #include "util/serializing/ObjectInputStream.h"
 #include "util/serializing/ObjectOutputStream.h"
 #include "view/DocumentView.h"
@@ -30,6 +34,11 @@
 
 using std::vector;
 
+/**
+ * Number of stroke points per additional worker thread when a selection is finalized
+ */
+constexpr size_t PARALLEL_TRANSFORM_POINTS = 50000;
+
 EditSelectionContents::EditSelectionContents(Rectangle<double> bounds, Rectangle<double> snappedBounds,
                                              const PageRef& sourcePage, Layer* sourceLayer, XojPageView* sourceView):
         lastBounds(bounds),
@@ -44,11 +53,7 @@ EditSelectionContents::EditSelectionContents(Rectangle<double> bounds, Rectangle
 }
 
 EditSelectionContents::~EditSelectionContents() {
-    if (this->rescaleId) {
-        g_source_remove(this->rescaleId);
-        this->rescaleId = 0;
-    }
-
+    cancelRender();
     deleteViewBuffer();
 }
 
@@ -56,6 +61,7 @@ EditSelectionContents::~EditSelectionContents() {
  * Add an element to the this selection
  */
 void EditSelectionContents::addElement(Element* e, Layer::ElementIndex order) {
+    cancelRender();
     g_assert(this->selected.size() == this->insertOrder.size());
     this->selected.emplace_back(e);
     auto item = std::make_pair(e, order);
@@ -64,6 +70,7 @@ void EditSelectionContents::addElement(Element* e, Layer::ElementIndex order) {
 }
 
 void EditSelectionContents::replaceInsertOrder(std::deque<std::pair<Element*, Layer::ElementIndex>> newInsertOrder) {
+    cancelRender();
     this->selected.clear();
     this->selected.reserve(newInsertOrder.size());
     std::transform(begin(newInsertOrder), end(newInsertOrder), std::back_inserter(this->selected),
@@ -90,6 +97,8 @@ auto EditSelectionContents::getInsertOrder() const -> std::deque<std::pair<Eleme
  */
 auto EditSelectionContents::setSize(ToolSize size, const double* thicknessPen, const double* thicknessHighlighter,
                                     const double* thicknessEraser) -> UndoAction* {
+    cancelRender();
+
     auto* undo = new SizeUndoAction(this->sourcePage, this->sourceLayer);
 
     bool found = false;
@@ -141,6 +150,8 @@ auto EditSelectionContents::setSize(ToolSize size, const double* thicknessPen, c
  * (Or nullptr if nothing done, e.g. because there is only an image)
  */
 auto EditSelectionContents::setFill(int alphaPen, int alphaHighligther) -> UndoAction* {
+    cancelRender();
+
     auto* undo = new FillUndoAction(this->sourcePage, this->sourceLayer);
 
     bool found = false;
@@ -188,6 +199,8 @@ auto EditSelectionContents::setFill(int alphaPen, int alphaHighligther) -> UndoA
  * (or nullptr if there are no Text elements)
  */
 auto EditSelectionContents::setFont(XojFont& font) -> UndoAction* {
+    cancelRender();
+
     double x1 = 0.0 / 0.0;
     double x2 = 0.0 / 0.0;
     double y1 = 0.0 / 0.0;
@@ -239,6 +252,8 @@ auto EditSelectionContents::setFont(XojFont& font) -> UndoAction* {
  * (Or nullptr if nothing done)
  */
 auto EditSelectionContents::setLineStyle(LineStyle style) -> UndoActionPtr {
+    cancelRender();
+
     auto undo = std::make_unique<LineStyleUndoAction>(this->sourcePage, this->sourceLayer);
 
     bool found = false;
@@ -270,6 +285,8 @@ auto EditSelectionContents::setLineStyle(LineStyle style) -> UndoActionPtr {
  * (Or nullptr if nothing done, e.g. because there is only an image)
  */
 auto EditSelectionContents::setColor(Color color) -> UndoAction* {
+    cancelRender();
+
     auto* undo = new ColorUndoAction(this->sourcePage, this->sourceLayer);
 
     bool found = false;
@@ -314,35 +331,41 @@ void EditSelectionContents::fillUndoItem(DeleteUndoAction* undo) {
     this->insertOrder.clear();
 }
 
-/**
- * Callback to redrawing the buffer asynchron
- */
-auto EditSelectionContents::repaintSelection(EditSelectionContents* selection) -> bool {
-    // delete the selection buffer, force a redraw
-    selection->deleteViewBuffer();
-    selection->sourceView->getXournal()->repaintSelection();
-    selection->rescaleId = 0;
-
-    return false;
-}
-
 /**
  * Delete our internal View buffer,
  * it will be recreated when the selection is painted next time
  */
 void EditSelectionContents::deleteViewBuffer() {
+    std::lock_guard lock(this->bufferMutex);
     if (this->crBuffer) {
         cairo_surface_destroy(this->crBuffer);
         this->crBuffer = nullptr;
     }
 }
 
+void EditSelectionContents::cancelRender() {
+    {
+        std::lock_guard lock(this->bufferMutex);
+        if (this->renderJobs == 0) {
+            return;
+        }
+    }
+
+    // Jobs are only queued from the UI thread, so none can be added meanwhile
+    this->sourceView->getXournal()->getControl()->getScheduler()->removeSelection(this);
+
+    std::lock_guard lock(this->bufferMutex);
+    this->renderJobs = 0;
+}
+
 /**
  * The contents of the selection
  */
 void EditSelectionContents::finalizeSelection(Rectangle<double> bounds, Rectangle<double> snappedBounds,
                                               bool aspectRatio, Layer* layer, const PageRef& targetPage,
                                               XojPageView* targetView, UndoRedoHandler* undo) {
+    cancelRender();
+
     double fx = bounds.width / this->originalBounds.width;
     double fy = bounds.height / this->originalBounds.height;
 
@@ -360,17 +383,67 @@ void EditSelectionContents::finalizeSelection(Rectangle<double> bounds, Rectangl
     bool move = mx != 0 || my != 0;
 
     g_assert(this->selected.size() == this->insertOrder.size());
-    for (auto&& [e, index]: this->insertOrder) {
-        if (move) {
-            e->move(mx, my);
-        }
+
+    double rx = snappedBounds.x + this->lastSnappedBounds.width / 2;
+    double ry = snappedBounds.y + this->lastSnappedBounds.height / 2;
+
+    if (move || scale || rotate) {
+        // Strokes get the composed transformation in one pass over their points, split over worker threads for large
+        // selections. The other elements may use Pango and are transformed one after another on this thread.
+        cairo_matrix_t matrix;
+        cairo_matrix_init_translate(&matrix, mx, my);
         if (scale) {
-            e->scale(bounds.x, bounds.y, fx, fy, 0, this->restoreLineWidth);
+            cairo_matrix_t scaleMatrix;
+            cairo_matrix_init_translate(&scaleMatrix, bounds.x, bounds.y);
+            cairo_matrix_scale(&scaleMatrix, fx, fy);
+            cairo_matrix_translate(&scaleMatrix, -bounds.x, -bounds.y);
+            cairo_matrix_multiply(&matrix, &matrix, &scaleMatrix);
         }
         if (rotate) {
-            e->rotate(snappedBounds.x + this->lastSnappedBounds.width / 2,
-                      snappedBounds.y + this->lastSnappedBounds.height / 2, this->rotation);
+            cairo_matrix_t rotMatrix;
+            cairo_matrix_init_translate(&rotMatrix, rx, ry);
+            cairo_matrix_rotate(&rotMatrix, this->rotation);
+            cairo_matrix_translate(&rotMatrix, -rx, -ry);
+            cairo_matrix_multiply(&matrix, &matrix, &rotMatrix);
         }
+        double fz = (scale && !this->restoreLineWidth) ? sqrt(std::abs(fx * fy)) : 1;
+
+        vector<Stroke*> strokes;
+        size_t pointCount = 0;
+        for (auto&& [e, index]: this->insertOrder) {
+            if (e->getType() == ELEMENT_STROKE) {
+                auto* s = dynamic_cast<Stroke*>(e);
+                strokes.push_back(s);
+                pointCount += static_cast<size_t>(s->getPointCount());
+                continue;
+            }
+            if (move) {
+                e->move(mx, my);
+            }
+            if (scale) {
+                e->scale(bounds.x, bounds.y, fx, fy, 0, this->restoreLineWidth);
+            }
+            if (rotate) {
+                e->rotate(rx, ry, this->rotation);
+            }
+        }
+
+        size_t workers = std::min<size_t>(std::max<size_t>(std::thread::hardware_concurrency(), 1),
+                                          pointCount / PARALLEL_TRANSFORM_POINTS + 1);
+        workers = std::min(workers, std::max<size_t>(strokes.size(), 1));
+
+        std::atomic<size_t> next{0};
+        auto worker = [&]() {
+            for (size_t i = next++; i < strokes.size(); i = next++) { strokes[i]->transform(matrix, fz); }
+        };
+
+        vector<std::thread> threads;
+        for (size_t i = 1; i < workers; i++) { threads.emplace_back(worker); }
+        worker();
+        for (std::thread& t: threads) { t.join(); }
+    }
+
+    for (auto&& [e, index]: this->insertOrder) {
         if (index == Layer::InvalidElementIndex) {
             // if the element didn't have a source layer (e.g, clipboard)
             layer->addElement(e);
@@ -473,9 +546,6 @@ void EditSelectionContents::updateContent(Rectangle<double> bounds, Rectangle<do
  */
 void EditSelectionContents::paint(cairo_t* cr, double x, double y, double rotation, double width, double height,
                                   double zoom) {
-    double fx = width / this->originalBounds.width;
-    double fy = height / this->originalBounds.height;
-
     if (this->relativeX == -9999999999) {
         this->relativeX = x;
         this->relativeY = y;
@@ -485,22 +555,11 @@ void EditSelectionContents::paint(cairo_t* cr, double x, double y, double rotati
         this->rotation = rotation;
     }
 
+    std::lock_guard lock(this->bufferMutex);
+    bool skippedImages = false;
     if (this->crBuffer == nullptr) {
-        this->crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, static_cast<int>(std::abs(width) * zoom),
-                                                    static_cast<int>(std::abs(height) * zoom));
-        cairo_t* cr2 = cairo_create(this->crBuffer);
-
-        int dx = static_cast<int>(this->relativeX * zoom);
-        int dy = static_cast<int>(this->relativeY * zoom);
-
-        cairo_translate(cr2, fx < 0 ? -width * zoom : 0, fy < 0 ? -height * zoom : 0);
-        cairo_scale(cr2, fx, fy);
-        cairo_translate(cr2, -dx, -dy);
-        cairo_scale(cr2, zoom, zoom);
-        DocumentView view;
-        view.drawSelection(cr2, this);
-
-        cairo_destroy(cr2);
+        // Decoding images would block the UI, they are drawn by a SelectionRenderJob
+        this->crBuffer = renderBuffer(width, height, zoom, &skippedImages);
     }
 
     cairo_save(cr);
@@ -514,10 +573,18 @@ void EditSelectionContents::paint(cairo_t* cr, double x, double y, double rotati
     double sx = static_cast<double>(wTarget) / wImg;
     double sy = static_cast<double>(hTarget) / hImg;
 
-    if (wTarget != wImg || hTarget != hImg || std::abs(rotation) > __DBL_EPSILON__) {
-        if (!this->rescaleId) {
-            this->rescaleId = g_idle_add(reinterpret_cast<GSourceFunc>(repaintSelection), this);
+    bool scaled = wTarget != wImg || hTarget != hImg;
+    if (scaled || skippedImages) {
+        // Show the scaled buffer until the selection is rendered in the new size on a render thread. The rotation is
+        // applied by the caller, so the buffer does not depend on it.
+        this->renderWidth = width;
+        this->renderHeight = height;
+        this->renderZoom = zoom;
+        if (this->sourceView->getXournal()->getControl()->getScheduler()->addRenderSelection(this)) {
+            this->renderJobs++;
         }
+    }
+    if (scaled) {
         cairo_scale(cr, sx, sy);
     }
 
@@ -525,11 +592,77 @@ void EditSelectionContents::paint(cairo_t* cr, double x, double y, double rotati
     double dy = static_cast<int>(std::min(y, y + height) * zoom / sy);
 
     cairo_set_source_surface(cr, this->crBuffer, dx, dy);
+    if (scaled) {
+        // The stretched buffer is only shown for a few frames, keep it cheap
+        cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_FAST);
+    }
     cairo_paint(cr);
 
     cairo_restore(cr);
 }
 
+void EditSelectionContents::renderInBackground() {
+    double width = 0;
+    double height = 0;
+    double zoom = 1;
+    {
+        std::lock_guard lock(this->bufferMutex);
+        width = this->renderWidth;
+        height = this->renderHeight;
+        zoom = this->renderZoom;
+    }
+
+    // The buffer is still painted meanwhile, only the swap is locked
+    cairo_surface_t* buffer = renderBuffer(width, height, zoom);
+    {
+        std::lock_guard lock(this->bufferMutex);
+        if (this->crBuffer) {
+            cairo_surface_destroy(this->crBuffer);
+        }
+        this->crBuffer = buffer;
+    }
+
+    // The selection can be deleted before the callback runs, only the widget is referenced
+    GtkWidget* widget = this->sourceView->getXournal()->getWidget();
+    g_object_ref(widget);
+    Util::execInUiThread([widget]() {
+        gtk_widget_queue_draw(widget);
+        g_object_unref(widget);
+    });
+
+    std::lock_guard lock(this->bufferMutex);
+    if (this->renderJobs > 0) {
+        this->renderJobs--;
+    }
+}
+
+auto EditSelectionContents::renderBuffer(double width, double height, double zoom, bool* skippedImages)
+        -> cairo_surface_t* {
+    double fx = width / this->originalBounds.width;
+    double fy = height / this->originalBounds.height;
+
+    cairo_surface_t* buffer = cairo_image_surface_create(
+            CAIRO_FORMAT_ARGB32, static_cast<int>(std::abs(width) * zoom), static_cast<int>(std::abs(height) * zoom));
+    cairo_t* cr2 = cairo_create(buffer);
+
+    int dx = static_cast<int>(this->relativeX * zoom);
+    int dy = static_cast<int>(this->relativeY * zoom);
+
+    cairo_translate(cr2, fx < 0 ? -width * zoom : 0, fy < 0 ? -height * zoom : 0);
+    cairo_scale(cr2, fx, fy);
+    cairo_translate(cr2, -dx, -dy);
+    cairo_scale(cr2, zoom, zoom);
+    DocumentView view;
+    view.setSkipUndecodedImages(skippedImages != nullptr);
+    view.drawSelection(cr2, this);
+    if (skippedImages) {
+        *skippedImages = view.hasSkippedImages();
+    }
+
+    cairo_destroy(cr2);
+    return buffer;
+}
+
 auto EditSelectionContents::copySelection(PageRef page, XojPageView* view, double x, double y) -> UndoAction* {
     Layer* layer = page->getSelectedLayer();
 
@@ -12,6 +12,7 @@
 #pragma once
 
 #include <deque>
+#include <mutex>
 #include <utility>
 #include <vector>
 
@@ -107,6 +108,12 @@ public:
      */
     void paint(cairo_t* cr, double x, double y, double rotation, double width, double height, double zoom);
 
+    /**
+     * Renders the selection in the size of the last paint request and replaces the view buffer,
+     * called by the SelectionRenderJob on a render thread
+     */
+    void renderInBackground();
+
     /**
      * Finish the editing
      */
@@ -125,9 +132,18 @@ private:
     void deleteViewBuffer();
 
     /**
-     * Callback to redrawing the buffer asynchrony
+     * Removes a queued SelectionRenderJob and waits for a running one of this selection, call this before the elements
+     * are changed
+     */
+    void cancelRender();
+
+    /**
+     * Renders the elements into a new buffer of the given size
+     *
+     * @param skippedImages If not nullptr, images which are not decoded yet are skipped, and it is set to true if
+     *                      there were any
      */
-    static bool repaintSelection(EditSelectionContents* selection);
+    cairo_surface_t* renderBuffer(double width, double height, double zoom, bool* skippedImages = nullptr);
 
 public:
     /**
@@ -204,9 +220,22 @@ private:
     cairo_surface_t* crBuffer = nullptr;
 
     /**
-     * The source id for the rescaling task
+     * The size requested by the last paint, rendered by the next SelectionRenderJob
+     */
+    double renderWidth = 0;
+    double renderHeight = 0;
+    double renderZoom = 1;
+
+    /**
+     * Number of SelectionRenderJobs which are queued or running. Decremented when a job is done, reset by
+     * cancelRender().
+     */
+    size_t renderJobs = 0;
+
+    /**
+     * Protects the view buffer, the requested size and renderJobs, which are shared with the render thread
      */
-    int rescaleId = 0;
+    std::mutex bufferMutex;
 
     /**
      * Source Page for Undo operations
@@ -49,19 +49,25 @@ void EraseHandler::erase(double x, double y) {
 
     Layer* l = page->getSelectedLayer();
 
+    bool erased = false;
     for (Element* e: l->getElements()) {
         if (e->getType() == ELEMENT_STROKE && e->intersectsArea(&eraserRect)) {
-            eraseStroke(l, dynamic_cast<Stroke*>(e), x, y, range);
+            erased |= eraseStroke(l, dynamic_cast<Stroke*>(e), x, y, range);
         }
     }
 
+    if (erased) {
+        // The default eraser modifies the strokes in place, the layer caches have to render them again
+        l->markChanged();
+    }
+
     this->view->rerenderRange(*range);
     delete range;
 }
 
-void EraseHandler::eraseStroke(Layer* l, Stroke* s, double x, double y, Range* range) {
+auto EraseHandler::eraseStroke(Layer* l, Stroke* s, double x, double y, Range* range) -> bool {
     if (!s->intersects(x, y, halfEraserSize)) {
-        return;
+        return false;
     }
 
     // delete complete element
@@ -71,7 +77,7 @@ void EraseHandler::eraseStroke(Layer* l, Stroke* s, double x, double y, Range* r
         this->doc->unlock();
 
         if (pos == -1) {
-            return;
+            return false;
         }
         range->addPoint(s->getX(), s->getY());
         range->addPoint(s->getX() + s->getElementWidth(), s->getY() + s->getElementHeight());
@@ -90,7 +96,7 @@ void EraseHandler::eraseStroke(Layer* l, Stroke* s, double x, double y, Range* r
     {
         int pos = l->indexOf(s);
         if (pos == -1) {
-            return;
+            return false;
         }
 
         if (this->eraseUndoAction == nullptr) {
@@ -113,6 +119,7 @@ void EraseHandler::eraseStroke(Layer* l, Stroke* s, double x, double y, Range* r
 
         eraseable->erase(x, y, halfEraserSize, range);
     }
+    return true;
 }
 
 void EraseHandler::finalize() {
@@ -37,7 +37,10 @@ public:
     void finalize();
 
 private:
-    void eraseStroke(Layer* l, Stroke* s, double x, double y, Range* range);
+    /**
+     * @return true if the stroke was erased, completely or in parts
+     */
+    bool eraseStroke(Layer* l, Stroke* s, double x, double y, Range* range);
 
 private:
     PageRef page;
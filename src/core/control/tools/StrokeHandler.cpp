@@ -73,6 +73,8 @@ auto StrokeHandler::onMotionNotifyEvent(const PositionInputData& pos) -> bool {
     return true;
 }
 
+auto StrokeHandler::getStroke() -> Stroke* { return this->stroke; }
+
 void StrokeHandler::paintTo(const Point& point) {
 
     int pointCount = stroke->getPointCount();
@@ -133,6 +135,9 @@ void StrokeHandler::paintTo(const Point& point) {
 void StrokeHandler::drawSegmentTo(const Point& point) {
 
     stroke->addPoint(this->hasPressure ? point : Point(point.x, point.y));
+    if (this->reco) {
+        this->reco->updateInertia(stroke);
+    }
 
     double width = stroke->getWidth();
 
@@ -245,9 +250,11 @@ void StrokeHandler::onButtonReleaseEvent(const PositionInputData& pos) {
     ToolHandler* h = control->getToolHandler();
 
     if (h->getDrawingType() == DRAWING_TYPE_STROKE_RECOGNIZER) {
-        ShapeRecognizer reco;
+        if (!this->reco) {
+            this->reco = std::make_unique<ShapeRecognizer>();
+        }
 
-        Stroke* recognized = reco.recognizePatterns(stroke);
+        Stroke* recognized = this->reco->recognizePatterns(stroke);
 
         if (recognized) {
             strokeRecognizerDetected(recognized, layer);
@@ -326,6 +333,11 @@ void StrokeHandler::onButtonPressEvent(const PositionInputData& pos) {
         this->fullRedraw = this->stroke->getFill() != -1 || stroke->getLineStyle().hasDashes();
 
         stabilizer->initialize(this, zoom, pos);
+
+        if (xournal->getControl()->getToolHandler()->getDrawingType() == DRAWING_TYPE_STROKE_RECOGNIZER) {
+            this->reco = std::make_unique<ShapeRecognizer>();
+            this->reco->updateInertia(this->stroke);
+        }
     }
 
     {  // Initialize the mask
@@ -15,10 +15,12 @@
 
 #include "InputHandler.h"
 #include "SnapToGridInputHandler.h"
+#include "StrokeStabilizerOutput.h"
+
+class ShapeRecognizer;
 
 namespace StrokeStabilizer {
 class Base;
-class Active;
 }  // namespace StrokeStabilizer
 
 /**
@@ -30,7 +32,7 @@ class Active;
  * surface. The surface is used to mask the stroke
  * when drawing it to the XojPageView
  */
-class StrokeHandler: public InputHandler {
+class StrokeHandler: public InputHandler, public StrokeStabilizer::Output {
 public:
     StrokeHandler(XournalView* xournal, XojPageView* redrawable, const PageRef& page);
     virtual ~StrokeHandler();
@@ -49,7 +51,9 @@ public:
      * The line may be subdivided into smaller segments if the pressure variation is too big.
      * @param point The endpoint of the added line
      */
-    void paintTo(const Point& point);
+    void paintTo(const Point& point) override;
+
+    Stroke* getStroke() override;
 
     /**
      * @brief paints a single dot
@@ -62,7 +66,7 @@ protected:
      * Warning: it does not set the width properly nor test if the motion is valid. Use paintTo instead.
      * @param point The endpoint of the added segment
      */
-    void drawSegmentTo(const Point& point);
+    void drawSegmentTo(const Point& point) override;
 
     void strokeRecognizerDetected(Stroke* recognized, Layer* layer);
     void destroySurface();
@@ -94,12 +98,15 @@ private:
      */
     std::unique_ptr<StrokeStabilizer::Base> stabilizer;
 
+    /**
+     * Only set with the shape recognizer tool, it is kept up to date while the stroke is drawn
+     */
+    std::unique_ptr<ShapeRecognizer> reco;
+
     bool hasPressure;
     bool firstPointPressureChange = false;
 
     bool fullRedraw;
 
-    friend class StrokeStabilizer::Active;
-
     static constexpr double MAX_WIDTH_VARIATION = 0.3;
 };
@@ -1,9 +1,13 @@
 #include "StrokeStabilizer.h"
 
+#include <array>
+#include <cmath>
+#include <cstddef>
 #include <numeric>
 
 #include "control/settings/Settings.h"
 #include "model/SplineSegment.h"
+#include "model/Stroke.h"
 
 /**
  * StrokeStabilizer::get
@@ -79,7 +83,7 @@ void StrokeStabilizer::Active::quadraticSplineTo(const Event& ev) {
     /**
      * Using the last two points of the stroke, draw a spline quadratic segment to the coordinates of ev.
      */
-    Stroke* stroke = strokeHandler->getStroke();
+    Stroke* stroke = output->getStroke();
     int pointCount = stroke->getPointCount();
     if (pointCount <= 0) {
         return;
@@ -143,9 +147,9 @@ void StrokeStabilizer::Active::quadraticSplineTo(const Event& ev) {
 
     pointsToPaint.pop_front();  // Point B has already been painted
 
-    for (auto&& point: pointsToPaint) { strokeHandler->drawSegmentTo(point); }
+    for (auto&& point: pointsToPaint) { output->drawSegmentTo(point); }
     C.z = ev.pressure;  // Normal state after having added a segment. Useful?
-    strokeHandler->drawSegmentTo(C);
+    output->drawSegmentTo(C);
 }
 
 
@@ -223,7 +227,7 @@ void StrokeStabilizer::Deadzone::processEvent(const PositionInputData& pos) {
 }
 
 void StrokeStabilizer::Deadzone::rebalanceStrokePressures() {
-    Stroke* stroke = strokeHandler->getStroke();
+    Stroke* stroke = output->getStroke();
     int pointCount = stroke->getPointCount();
     if (pointCount >= 3) {
         /**
@@ -264,7 +268,7 @@ void StrokeStabilizer::Inertia::processEvent(const PositionInputData& pos) {
 }
 
 void StrokeStabilizer::Inertia::rebalanceStrokePressures() {
-    Stroke* stroke = strokeHandler->getStroke();
+    Stroke* stroke = output->getStroke();
     int pointCount = stroke->getPointCount();
     if (pointCount >= 3) {
         /**
@@ -278,94 +282,147 @@ void StrokeStabilizer::Inertia::rebalanceStrokePressures() {
 /**
  * StrokeStabilizer::Arithmetic
  */
-void StrokeStabilizer::Arithmetic::recordFirstEvent(const PositionInputData& pos) {
-    eventBuffer.assign(Event(pos));  // Fill the buffer with copies of Event(pos)
+void StrokeStabilizer::Arithmetic::recordFirstEvent(const PositionInputData& pos) { fillBuffer(Event(pos)); }
+
+void StrokeStabilizer::Arithmetic::fillBuffer(const Event& ev) {
+    eventBuffer.assign(ev);  // Replace the entire content of the buffer with copies of ev
+    double d = static_cast<double>(eventBuffer.size());
+    sum = Event(d * ev.x, d * ev.y, d * ev.pressure);
+    pushesUntilResum = eventBuffer.size();
+    uniform = true;
 }
 
 void StrokeStabilizer::Arithmetic::averageAndPaint(const Event& ev, guint32 timestamp) {
     /**
-     * Push the event and overwrite the oldest event in the buffer
+     * Push the event and overwrite the oldest event in the buffer, keeping the sum up to date
      */
+    Event oldest = eventBuffer.oldest();
     eventBuffer.push_front(ev);
+    uniform = false;
 
-    /**
-     * Average the coordinates using an arithmetic mean
-     */
-    Event sum = std::accumulate(begin(eventBuffer), end(eventBuffer), Event(0, 0, 0), [](auto&& lhs, auto&& rhs) {
-        return Event(lhs.x + rhs.x, lhs.y + rhs.y, lhs.pressure + rhs.pressure);
-    });
+    if (--pushesUntilResum == 0) {
+        sum = std::accumulate(begin(eventBuffer), end(eventBuffer), Event(0, 0, 0), [](auto&& lhs, auto&& rhs) {
+            return Event(lhs.x + rhs.x, lhs.y + rhs.y, lhs.pressure + rhs.pressure);
+        });
+        pushesUntilResum = eventBuffer.size();
+    } else {
+        sum.x += ev.x - oldest.x;
+        sum.y += ev.y - oldest.y;
+        sum.pressure += ev.pressure - oldest.pressure;
+    }
 
     /**
-     * Rescale the averaged coordinates and draw
+     * Average the coordinates using an arithmetic mean
      */
     double d = static_cast<double>(eventBuffer.size());
-    sum.pressure /= d;
-    sum.x /= d;
-    sum.y /= d;
-    setLastPaintedEvent(sum);
-    drawEvent(sum);
+    Event average(sum.x / d, sum.y / d, sum.pressure / d);
+    setLastPaintedEvent(average);
+    drawEvent(average);
 }
 
 auto StrokeStabilizer::Arithmetic::getLastEvent() -> Event { return eventBuffer.front(); }
 
 void StrokeStabilizer::Arithmetic::resetBuffer(Event& ev, guint32 timestamp) {
-    if (eventBuffer.back() != ev) {
-        eventBuffer.assign(ev);  // Replace the entire content of the buffer with copies of ev
+    if (!uniform || eventBuffer.front() != ev) {
+        fillBuffer(ev);
+    }
+}
+
+namespace {
+/**
+ * Events with a weight below 0.01 = exp(-MAX_WEIGHT_EXPONENT) are not used for the average
+ */
+const double MAX_WEIGHT_EXPONENT = std::log(100.0);
+constexpr size_t WEIGHT_TABLE_SIZE = 1024;
+
+/**
+ * exp(-x) for 0 <= x <= MAX_WEIGHT_EXPONENT, interpolated from a table
+ */
+auto gaussianWeight(double x) -> double {
+    static const std::array<double, WEIGHT_TABLE_SIZE + 1> table = [] {
+        std::array<double, WEIGHT_TABLE_SIZE + 1> t{};
+        for (size_t i = 0; i <= WEIGHT_TABLE_SIZE; i++) {
+            t[i] = std::exp(-MAX_WEIGHT_EXPONENT * static_cast<double>(i) / WEIGHT_TABLE_SIZE);
+        }
+        return t;
+    }();
+
+    double pos = x * (WEIGHT_TABLE_SIZE / MAX_WEIGHT_EXPONENT);
+    auto i = static_cast<size_t>(pos);
+    if (i >= WEIGHT_TABLE_SIZE) {
+        return table[WEIGHT_TABLE_SIZE];
     }
+    double f = pos - static_cast<double>(i);
+    return table[i] + f * (table[i + 1] - table[i]);
 }
+}  // namespace
 
 /**
  * StrokeStabilizer::VelocityGaussian
  */
 void StrokeStabilizer::VelocityGaussian::recordFirstEvent(const PositionInputData& pos) {
-    eventBuffer.emplace_front(pos);
+    eventBuffer.clear();
+    bufferStart = 0;
+    eventBuffer.emplace_back(pos);
     lastEventTimestamp = pos.timestamp;
 }
 
 void StrokeStabilizer::VelocityGaussian::averageAndPaint(const Event& ev, guint32 timestamp) {
 
+    if (bufferStart > 0 && eventBuffer.size() == eventBuffer.capacity()) {
+        // Drop the outdated events instead of growing the vector
+        eventBuffer.erase(eventBuffer.begin(), eventBuffer.begin() + static_cast<std::ptrdiff_t>(bufferStart));
+        bufferStart = 0;
+    }
+
     /**
      * Compute the velocity (if possible) and push the event to eventBuffer
      */
-    if (eventBuffer.empty()) {
-        eventBuffer.emplace_front(ev);
+    if (eventBuffer.size() == bufferStart) {
+        eventBuffer.emplace_back(ev);
     } else {
         /**
          * Issue: timestamps are in ms. They are not precise enough. Different events can have the same timestamp.
          */
-        VelocityEvent& last = eventBuffer.front();
+        const VelocityEvent& last = eventBuffer.back();
         guint32 timelaps = timestamp - lastEventTimestamp;
         if (timelaps == 0) {
             timelaps = 1;
         }
-        eventBuffer.emplace_front(ev, std::hypot(ev.x - last.x, ev.y - last.y) / static_cast<double>(timelaps));
+        double velocity = std::hypot(ev.x - last.x, ev.y - last.y) / static_cast<double>(timelaps);
+        eventBuffer.emplace_back(ev, velocity);
     }
     lastEventTimestamp = timestamp;
 
     /**
-     * Average the coordinates using the gimp-like weights
+     * Average the coordinates using the gimp-like weights, from the most recent event backwards
      */
     Event weightedSum = {0, 0, 0};
-    double weight;
     double sumOfWeights = 0;
     double sumOfVelocities = 0;
 
-    auto it = eventBuffer.cbegin();
-    for (; it != eventBuffer.cend(); ++it) {
+    size_t i = eventBuffer.size();
+    for (; i > bufferStart; i--) {
+        const VelocityEvent& e = eventBuffer[i - 1];
+
         /**
          * The first weight is always 1
          */
-        weight = exp(-sumOfVelocities * sumOfVelocities / twoSigmaSquared);
-        if (weight < 0.01) {
+        double exponent = sumOfVelocities * sumOfVelocities / twoSigmaSquared;
+        if (exponent > MAX_WEIGHT_EXPONENT) {
             break;
         }
-        sumOfVelocities += (*it).velocity;
-        weightedSum.x += weight * (*it).x;
-        weightedSum.y += weight * (*it).y;
-        weightedSum.pressure += weight * (*it).pressure;
+        double weight = gaussianWeight(exponent);
+        sumOfVelocities += e.velocity;
+        weightedSum.x += weight * e.x;
+        weightedSum.y += weight * e.y;
+        weightedSum.pressure += weight * e.pressure;
         sumOfWeights += weight;
     }
-    eventBuffer.erase(it, eventBuffer.cend());
+    if (i > bufferStart) {
+        // The event at i - 1 and all older ones are too old to get a weight again
+        bufferStart = i;
+    }
 
     weightedSum.x /= sumOfWeights;
     weightedSum.y /= sumOfWeights;
@@ -376,17 +433,18 @@ void StrokeStabilizer::VelocityGaussian::averageAndPaint(const Event& ev, guint3
 }
 
 auto StrokeStabilizer::VelocityGaussian::getLastEvent() -> Event {
-    if (eventBuffer.empty()) {
+    if (eventBuffer.size() == bufferStart) {
         g_warning("StrokeStabilizer::VelocityGaussian buffer empty. This should never be!");
         return Event(0, 0, 0);
     }
-    return eventBuffer.front();
+    return eventBuffer.back();
 }
 
 void StrokeStabilizer::VelocityGaussian::resetBuffer(Event& ev, guint32 timestamp) {
-    if (eventBuffer.size() != 1 || lastEventTimestamp != timestamp || eventBuffer.front() != ev) {
+    if (eventBuffer.size() - bufferStart != 1 || lastEventTimestamp != timestamp || eventBuffer.back() != ev) {
         eventBuffer.clear();
+        bufferStart = 0;
         lastEventTimestamp = timestamp;
-        eventBuffer.emplace_front(ev);
+        eventBuffer.emplace_back(ev);
     }
 }
@@ -12,13 +12,19 @@
 
 #include <array>
 #include <cmath>
-#include <deque>
 #include <functional>
+#include <memory>
+#include <string>
+#include <vector>
 
-#include "control/tools/StrokeHandler.h"
+#include "gui/inputdevices/PositionInputData.h"
+#include "model/Point.h"
 #include "util/CircularBuffer.h"
 
 #include "StrokeStabilizerEnum.h"
+#include "StrokeStabilizerOutput.h"
+
+class Settings;
 
 namespace StrokeStabilizer {
 
@@ -59,12 +65,12 @@ public:
 
     /**
      * @brief Initialize the stabilizer
-     * @param sH Pointer to the StrokeHandler instance handling the stroke
+     * @param out The stroke to draw to, usually the StrokeHandler handling the stroke
      * @param zoomValue The current zoom
      * @param pos The position of the button down event starting the stroke
      */
-    void initialize(StrokeHandler* sH, double zoomValue, const PositionInputData& pos) {
-        strokeHandler = sH;
+    void initialize(Output* out, double zoomValue, const PositionInputData& pos) {
+        output = out;
         zoom = zoomValue;
         recordFirstEvent(pos);
     }
@@ -74,7 +80,7 @@ public:
      * @param pos The MotionNotify event information
      */
     virtual void processEvent(const PositionInputData& pos) {
-        strokeHandler->paintTo(Point(pos.x / zoom, pos.y / zoom, pos.pressure));
+        output->paintTo(Point(pos.x / zoom, pos.y / zoom, pos.pressure));
     }
 
     /**
@@ -96,9 +102,9 @@ protected:
     virtual inline void recordFirstEvent(const PositionInputData& pos){};
 
     /**
-     * @brief Pointer to the StrokeHandler instance handling the stroke
+     * @brief The stroke to draw to
      */
-    StrokeHandler* strokeHandler;
+    Output* output;
 
     /**
      * @brief The zoom value to be applied on all painted points
@@ -134,7 +140,7 @@ protected:
      * @brief Add a segment to the stroke ending at the parameters coordinates
      * @param ev The event whose coordinates determine the stroke's new endpoint
      */
-    inline void drawEvent(const Event& ev) { strokeHandler->paintTo(Point(ev.x / zoom, ev.y / zoom, ev.pressure)); }
+    inline void drawEvent(const Event& ev) { output->paintTo(Point(ev.x / zoom, ev.y / zoom, ev.pressure)); }
 
     /**
      * @brief Record the event corresponding to last painted point
@@ -402,11 +408,12 @@ protected:
     };
 
     /**
-     * @brief A queue containing the relevant information on the last events
-     * The beginning of the queue contains the most recent event
-     * The end of the queue contains the most ancient event stored
+     * @brief The relevant information on the last events, from the most ancient to the most recent.
+     * Events before bufferStart are outdated, they are only removed when the vector would have to grow,
+     * so the buffer does not allocate once it reached its working size.
      */
-    std::deque<VelocityEvent> eventBuffer;
+    std::vector<VelocityEvent> eventBuffer;
+    size_t bufferStart = 0;
 
 private:
     /**
@@ -428,7 +435,8 @@ private:
 
 class Arithmetic: virtual public Active {
 public:
-    Arithmetic(bool finalize, size_t buffersize): Active(finalize), bufferLength(buffersize), eventBuffer(buffersize) {}
+    Arithmetic(bool finalize, size_t buffersize):
+            Active(finalize), bufferLength(buffersize), eventBuffer(buffersize), sum(0, 0, 0) {}
     virtual ~Arithmetic() = default;
 
     [[maybe_unused]] virtual auto getInfo() -> std::string override {
@@ -464,7 +472,7 @@ protected:
     /**
      * @brief A circular buffer containing the relevant information on the last events
      * The front of the buffer contains the most recent event
-     * The back of the buffer contains the most ancient event stored
+     * The oldest element of the buffer is the most ancient event stored
      */
     CircularBuffer<Event> eventBuffer;
 
@@ -474,6 +482,22 @@ private:
      * @return The last event received
      */
     virtual Event getLastEvent() override;
+
+    /**
+     * @brief Fill the buffer with copies of ev
+     */
+    void fillBuffer(const Event& ev);
+
+    /**
+     * @brief Running sum of the events in the buffer, recomputed once per buffer length to avoid drifting
+     */
+    Event sum;
+    size_t pushesUntilResum = 0;
+
+    /**
+     * @brief Whether the buffer only contains copies of its front event
+     */
+    bool uniform = false;
 };
 
 
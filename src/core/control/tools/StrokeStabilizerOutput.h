@@ -0,0 +1,45 @@
+/*
+ * Xournal++
+ *
+ * Receives the points computed by a stroke stabilizer
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+class Point;
+class Stroke;
+
+namespace StrokeStabilizer {
+
+/**
+ * @brief The stroke a stabilizer draws to. Implemented by the StrokeHandler, and by the benchmarks to drive the
+ * stabilizers without a page view.
+ */
+class Output {
+public:
+    virtual ~Output() = default;
+
+    /**
+     * @brief The stroke being drawn, its last points are used to smooth the end of the stroke
+     */
+    virtual Stroke* getStroke() = 0;
+
+    /**
+     * @brief Add a straight line to the stroke (if the movement is valid)
+     * @param point The endpoint of the added line
+     */
+    virtual void paintTo(const Point& point) = 0;
+
+    /**
+     * @brief Unconditionally add a segment to the stroke
+     * @param point The endpoint of the added segment
+     */
+    virtual void drawSegmentTo(const Point& point) = 0;
+};
+
+}  // namespace StrokeStabilizer
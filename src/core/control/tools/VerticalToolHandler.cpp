@@ -34,6 +34,8 @@ VerticalToolHandler::VerticalToolHandler(Redrawable* view, const PageRef& page,
     cairo_scale(cr, zoom, zoom);
     cairo_translate(cr, 0, -y);
     DocumentView v;
+    // This runs on the UI thread, images are almost always decoded already as the page was just shown
+    v.setSkipUndecodedImages(true);
     v.drawSelection(cr, this);
 
     cairo_destroy(cr);
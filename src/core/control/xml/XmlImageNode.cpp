@@ -1,5 +1,7 @@
 #include "XmlImageNode.h"
 
+#include <utility>
+
 XmlImageNode::XmlImageNode(const char* tag): XmlNode(tag) {
     this->img = nullptr;
     this->out = nullptr;
@@ -19,6 +21,8 @@ void XmlImageNode::setImage(cairo_surface_t* img) {
     this->img = cairo_surface_reference(img);
 }
 
+void XmlImageNode::setImageData(std::string png) { this->png = std::move(png); }
+
 auto XmlImageNode::pngWriteFunction(XmlImageNode* image, const unsigned char* data, unsigned int length)
         -> cairo_status_t {
     for (unsigned int i = 0; i < length; i++, image->pos++) {
@@ -41,7 +45,11 @@ void XmlImageNode::writeOut(OutputStream* out) {
 
     out->write(">");
 
-    if (this->img == nullptr) {
+    if (!this->png.empty()) {
+        gchar* base64_str = g_base64_encode(reinterpret_cast<const guchar*>(this->png.data()), this->png.length());
+        out->write(base64_str);
+        g_free(base64_str);
+    } else if (this->img == nullptr) {
         g_error("XmlImageNode::writeOut(); this->img == nullptr");
     } else {
         this->out = out;
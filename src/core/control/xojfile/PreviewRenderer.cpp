@@ -0,0 +1,58 @@
+#include "PreviewRenderer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "control/xojfile/LoadHandler.h"
+#include "util/i18n.h"
+#include "view/DocumentView.h"
+
+auto PreviewRenderer::renderPage(Document* doc, size_t page, int size) -> cairo_surface_t* {
+    if (page >= doc->getPageCount()) {
+        return nullptr;
+    }
+    PageRef p = doc->getPage(page);
+
+    double width = p->getWidth();
+    double height = p->getHeight();
+    double zoom = size / std::max(width, height);
+
+    int surfaceWidth = std::max(1, static_cast<int>(std::lround(width * zoom)));
+    int surfaceHeight = std::max(1, static_cast<int>(std::lround(height * zoom)));
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, surfaceWidth, surfaceHeight);
+
+    cairo_t* cr = cairo_create(surface);
+    cairo_scale(cr, zoom, zoom);
+
+    if (p->getBackgroundType().isPdfPage()) {
+        XojPdfPageSPtr popplerPage = doc->getPdfPage(p->getPdfPageNr());
+        if (popplerPage) {
+            popplerPage->render(cr, false);
+        }
+    }
+
+    DocumentView view;
+    view.drawPage(p, cr, true);
+    cairo_destroy(cr);
+
+    return surface;
+}
+
+auto PreviewRenderer::renderFile(const fs::path& file, int size, std::string& error) -> cairo_surface_t* {
+    // The document is released together with the loader
+    LoadHandler loader;
+    Document* doc = loader.loadDocument(file);
+    if (doc == nullptr) {
+        error = loader.getLastError();
+        return nullptr;
+    }
+
+    doc->lock();
+    cairo_surface_t* surface = renderPage(doc, 0, size);
+    doc->unlock();
+
+    if (surface == nullptr) {
+        error = _("The document has no pages");
+    }
+    return surface;
+}
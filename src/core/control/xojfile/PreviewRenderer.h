@@ -0,0 +1,44 @@
+/*
+ * Xournal++
+ *
+ * Renders the first page of a document as preview
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include <cairo.h>
+
+#include "model/Document.h"
+
+#include "filesystem.h"
+
+/**
+ * Used for the preview stored in saved files, and by xournalpp-thumbnailer for files which have no stored preview
+ * (e.g. files written by Xournal)
+ */
+namespace PreviewRenderer {
+
+/**
+ * Renders a page with its PDF background, scaled to fit into size x size pixels. The document has to be locked.
+ *
+ * @return A new image surface, nullptr if the page does not exist
+ */
+cairo_surface_t* renderPage(Document* doc, size_t page, int size);
+
+/**
+ * Loads the document and renders its first page, see renderPage()
+ *
+ * @param error Set if the document cannot be loaded or has no pages
+ * @return A new image surface, nullptr on error
+ */
+cairo_surface_t* renderFile(const fs::path& file, int size, std::string& error);
+
+}  // namespace PreviewRenderer
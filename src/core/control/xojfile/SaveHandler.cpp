@@ -156,11 +156,11 @@ void SaveHandler::visitLayer(XmlNode* page, Layer* l) {
             writeTimestamp(t, text);
         } else if (e->getType() == ELEMENT_IMAGE) {
             auto* i = dynamic_cast<Image*>(e);
+            // The image is stored PNG encoded already, no need to decode and encode it again
             auto* image = new XmlImageNode("image");
+            image->setImageData(i->getImageData());
             layer->addChild(image);
 
-            image->setImage(i->getImage());
-
             image->setAttrib("left", i->getX());
             image->setAttrib("top", i->getY());
             image->setAttrib("right", i->getX() + i->getElementWidth());
@@ -234,7 +234,7 @@ void SaveHandler::visitPage(XmlNode* root, PageRef p, Document* doc, int id) {
             char* filename = g_strdup_printf("%i", cloneId);
             background->setAttrib("filename", filename);
             g_free(filename);
-        } else if (p->getBackgroundImage().isAttached() && p->getBackgroundImage().getPixbuf()) {
+        } else if (p->getBackgroundImage().isAttached() && p->getBackgroundImage().getSurface()) {
             char* filename = g_strdup_printf("bg_%d.png", this->attachBgId++);
             background->setAttrib("domain", "attach");
             background->setAttrib("filename", filename);
@@ -281,8 +281,13 @@ void SaveHandler::writeBackgroundName(XmlNode* background, PageRef p) {
     }
 }
 
+void SaveHandler::setCompression(int level, size_t threads) {
+    this->compressionLevel = level;
+    this->compressionThreads = threads;
+}
+
 void SaveHandler::saveTo(const fs::path& filepath, ProgressListener* listener) {
-    GzOutputStream out(filepath);
+    GzOutputStream out(filepath, this->compressionLevel, this->compressionThreads);
 
     if (!out.getLastError().empty()) {
         this->errorMessage = out.getLastError();
@@ -306,7 +311,12 @@ void SaveHandler::saveTo(OutputStream* out, const fs::path& filepath, ProgressLi
 
     for (BackgroundImage const& img: backgroundImages) {
         auto tmpfn = (fs::path(filepath) += ".") += img.getFilepath();
-        if (!gdk_pixbuf_save(img.getPixbuf(), tmpfn.u8string().c_str(), "png", nullptr, nullptr)) {
+        GdkPixbuf* pixbuf = img.createPixbuf();
+        bool saved = pixbuf && gdk_pixbuf_save(pixbuf, tmpfn.u8string().c_str(), "png", nullptr, nullptr);
+        if (pixbuf) {
+            g_object_unref(pixbuf);
+        }
+        if (!saved) {
             if (!this->errorMessage.empty()) {
                 this->errorMessage += "\n";
             }
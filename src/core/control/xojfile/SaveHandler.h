@@ -32,6 +32,15 @@ public:
 
 public:
     void prepareSave(Document* doc);
+
+    /**
+     * Compression used by saveTo(const fs::path&, ProgressListener*), see GzOutputStream
+     *
+     * @param level zlib compression level (0-9), Z_DEFAULT_COMPRESSION for the default
+     * @param threads Number of compression threads, 0 for one per processor
+     */
+    void setCompression(int level, size_t threads = 0);
+
     void saveTo(const fs::path& filepath, ProgressListener* listener = nullptr);
     void saveTo(OutputStream* out, const fs::path& filepath, ProgressListener* listener = nullptr);
     std::string getErrorMessage();
@@ -60,5 +69,8 @@ protected:
 
     std::string errorMessage;
 
+    int compressionLevel = Z_DEFAULT_COMPRESSION;
+    size_t compressionThreads = 0;
+
     std::vector<BackgroundImage> backgroundImages{};
 };
@@ -102,6 +102,8 @@ void XojPageView::deleteViewBuffer() {
         this->crBuffer = nullptr;
     }
     this->drawingMutex.unlock();
+
+    this->layerCache.clear();
 }
 
 auto XojPageView::containsPoint(int x, int y, bool local) const -> bool {
@@ -179,6 +181,9 @@ void XojPageView::endText() {
         }
     }
 
+    // The text was edited in place, the layer caches have to render it again
+    layer->markChanged();
+
     delete this->textEditor;
     this->textEditor = nullptr;
     this->xournal->getControl()->getWindow()->setFontButtonFont(settings->getFont());
@@ -610,9 +615,16 @@ auto XojPageView::onKeyReleaseEvent(GdkEventKey* event) -> bool {
     return false;
 }
 
-void XojPageView::rerenderPage() {
+void XojPageView::rerenderPage() { rerenderPage(JOB_PRIORITY_URGENT); }
+
+void XojPageView::rerenderPage(JobPriority priority) {
+    this->repaintRectMutex.lock();
     this->rerenderComplete = true;
-    this->xournal->getControl()->getScheduler()->addRerenderPage(this);
+    // A complete rerender covers all pending rectangles
+    this->rerenderRegion.clear();
+    this->repaintRectMutex.unlock();
+
+    this->xournal->getControl()->getScheduler()->addRerenderPage(this, priority);
 }
 
 void XojPageView::repaintPage() { xournal->getRepaintHandler()->repaintPage(this); }
@@ -633,26 +645,16 @@ void XojPageView::rerenderRect(double x, double y, double width, double height)
 }
 
 void XojPageView::addRerenderRect(double x, double y, double width, double height) {
+    this->repaintRectMutex.lock();
+
     if (this->rerenderComplete) {
+        this->repaintRectMutex.unlock();
         return;
     }
 
-    auto rect = Rectangle<double>{x, y, width, height};
-
-    this->repaintRectMutex.lock();
-
-    for (auto&& r: this->rerenderRects) {
-        // its faster to redraw only one rect than repaint twice the same area
-        // so loop through the rectangles to be redrawn, if new rectangle
-        // intersects any of them, replace it by the union with the new one
-        if (r.intersects(rect)) {
-            r.unite(rect);
-            this->repaintRectMutex.unlock();
-            return;
-        }
-    }
+    // Overlapping and adjacent rectangles are merged, the RenderJob renders each area only once
+    this->rerenderRegion.add(Rectangle<double>{x, y, width, height});
 
-    this->rerenderRects.push_back(rect);
     this->repaintRectMutex.unlock();
 
     this->xournal->getControl()->getScheduler()->addRerenderPage(this);
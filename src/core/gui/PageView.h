@@ -14,12 +14,15 @@
 #include <mutex>
 #include <vector>
 
+#include "control/jobs/Scheduler.h"
 #include "gui/inputdevices/PositionInputData.h"
 #include "model/PageListener.h"
 #include "model/PageRef.h"
 #include "model/Stroke.h"
 #include "model/TexImage.h"
+#include "util/DamageRegion.h"
 #include "util/Range.h"
+#include "view/LayerRasterCache.h"
 
 #include "Layout.h"
 #include "Redrawable.h"
@@ -44,6 +47,11 @@ public:
     void updatePageSize(double width, double height);
 
     virtual void rerenderPage();
+
+    /**
+     * Rerenders the complete page with the given priority, e.g. for pages which are not visible
+     */
+    void rerenderPage(JobPriority priority);
     virtual void rerenderRect(double x, double y, double width, double height);
 
     virtual void repaintPage();
@@ -239,12 +247,20 @@ private:
      */
     int lastVisibleTime = -1;
 
+    /**
+     * Protects rerenderRegion and rerenderComplete
+     */
     std::mutex repaintRectMutex;
-    std::vector<Rectangle<double>> rerenderRects;
+    DamageRegion rerenderRegion;
     bool rerenderComplete = false;
 
     std::mutex drawingMutex;
 
+    /**
+     * The layers which are not edited, used by the RenderJob
+     */
+    LayerRasterCache layerCache;
+
     int dispX{};  // position on display - set in Layout::layoutPages
     int dispY{};
 
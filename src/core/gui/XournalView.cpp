@@ -500,6 +500,50 @@ void XournalView::zoomChanged() {
     control->getCursor()->updateCursor();
 
     this->control->getScheduler()->blockRerenderZoom();
+
+    rerenderPagesByVisibility();
+}
+
+void XournalView::rerenderPagesByVisibility() {
+    Layout* layout = gtk_xournal_get_layout(this->widget);
+    Rectangle<double> visibleRect = layout->getVisibleRect();
+    const auto& [pagesLower, pagesUpper] = preloadPageBounds(getCurrentPage(), this->viewPages.size());
+
+    std::vector<XojPageView*> preload;
+
+    for (size_t i = 0; i < this->viewPages.size(); i++) {
+        XojPageView* v = this->viewPages[i];
+        if (v->getRect().intersects(visibleRect)) {
+            v->rerenderPage(JOB_PRIORITY_URGENT);
+        } else if (pagesLower <= i && i < pagesUpper) {
+            preload.push_back(v);
+        } else if (v->getBufferPixels() > 0) {
+            // Rerendering pages far away on every zoom step is not worth it, they are rendered when they are
+            // scrolled into view again
+            v->deleteViewBuffer();
+        }
+    }
+
+    // Within a priority the jobs run in the order they were added
+    for (XojPageView* v: preload) { v->rerenderPage(JOB_PRIORITY_LOW); }
+}
+
+void XournalView::rerenderObsoletePage(XojPageView* view) {
+    auto it = std::find(this->viewPages.begin(), this->viewPages.end(), view);
+    if (it == this->viewPages.end()) {
+        // The page was deleted in the meantime
+        return;
+    }
+
+    auto i = static_cast<size_t>(it - this->viewPages.begin());
+    Layout* layout = gtk_xournal_get_layout(this->widget);
+    const auto& [pagesLower, pagesUpper] = preloadPageBounds(getCurrentPage(), this->viewPages.size());
+
+    if (view->getRect().intersects(layout->getVisibleRect())) {
+        view->rerenderPage(JOB_PRIORITY_URGENT);
+    } else if (pagesLower <= i && i < pagesUpper) {
+        view->rerenderPage(JOB_PRIORITY_LOW);
+    }
 }
 
 void XournalView::pageSizeChanged(size_t page) {
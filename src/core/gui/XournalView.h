@@ -55,6 +55,12 @@ public:
 
     void layerChanged(size_t page);
 
+    /**
+     * Called in the UI thread if a RenderJob of `view` was started before the zoom changed. Queues the page again if
+     * it is still visible or preloaded; `view` may have been deleted already.
+     */
+    void rerenderObsoletePage(XojPageView* view);
+
     void requestFocus();
 
     void forceUpdatePagenumbers();
@@ -146,6 +152,12 @@ private:
 
     void cleanupBufferCache();
 
+    /**
+     * Queues a rerender of the pages after zooming: the visible pages first, then the pages around the current page.
+     * The buffers of all other pages are dropped. Rerenders queued for the previous zoom are reordered.
+     */
+    void rerenderPagesByVisibility();
+
     static void staticLayoutPages(GtkWidget* widget, GtkAllocation* allocation, void* data);
 
 private:
@@ -8,9 +8,8 @@ ImageElementView::~ImageElementView() = default;
 
 void ImageElementView::calcSize() {
     if (this->width == -1) {
-        GdkPixbuf* p = backgroundImage.getPixbuf();
-        this->width = gdk_pixbuf_get_width(p);
-        this->height = gdk_pixbuf_get_height(p);
+        this->width = backgroundImage.getWidth();
+        this->height = backgroundImage.getHeight();
 
         if (this->width < this->height) {
             zoom = 128.0 / this->height;
@@ -25,8 +24,8 @@ void ImageElementView::calcSize() {
 void ImageElementView::paintContents(cairo_t* cr) {
     cairo_scale(cr, this->zoom, this->zoom);
 
-    GdkPixbuf* p = this->backgroundImage.getPixbuf();
-    gdk_cairo_set_source_pixbuf(cr, p, Shadow::getShadowTopLeftSize() + 2, Shadow::getShadowTopLeftSize() + 2);
+    cairo_surface_t* image = this->backgroundImage.getSurface();
+    cairo_set_source_surface(cr, image, Shadow::getShadowTopLeftSize() + 2, Shadow::getShadowTopLeftSize() + 2);
     cairo_paint(cr);
 }
 
@@ -88,6 +88,14 @@ auto InputContext::handle(GdkEvent* sourceEvent) -> bool {
         this->getSettings()->transactionEnd();
     }
 
+    if (this->recorder) {
+        this->recorder->write(event);
+    }
+
+    return dispatch(event);
+}
+
+auto InputContext::dispatch(InputEvent const& event) -> bool {
     // We do not handle scroll events manually but let GTK do it for us
     if (event.type == SCROLL_EVENT) {
         // Hand over to standard GTK Scroll / Zoom handling
@@ -142,6 +150,17 @@ auto InputContext::handle(GdkEvent* sourceEvent) -> bool {
     return false;
 }
 
+auto InputContext::startRecording(const fs::path& file) -> bool {
+    this->recorder = std::make_unique<InputTraceWriter>(file);
+    if (!this->recorder->isOpen()) {
+        this->recorder.reset();
+        return false;
+    }
+    return true;
+}
+
+void InputContext::stopRecording() { this->recorder.reset(); }
+
 auto InputContext::getXournal() -> GtkXournal* { return GTK_XOURNAL(widget); }
 
 auto InputContext::getView() -> XournalView* { return view; }
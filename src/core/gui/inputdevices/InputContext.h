@@ -12,6 +12,7 @@
 #pragma once
 
 
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -27,6 +28,7 @@
 
 #include "AbstractInputHandler.h"
 #include "HandRecognition.h"
+#include "InputTrace.h"
 #include "KeyboardInputHandler.h"
 #include "MouseInputHandler.h"
 #include "StylusInputHandler.h"
@@ -51,6 +53,11 @@ private:
 
     std::set<std::string> knownDevices;
 
+    /**
+     * Writes the handled events to a file, if recording
+     */
+    std::unique_ptr<InputTraceWriter> recorder;
+
 public:
     enum DeviceType {
         MOUSE,
@@ -90,6 +97,20 @@ public:
      */
     void connect(GtkWidget* widget);
 
+    /**
+     * Passes a translated event to the handlers of its device class, also used to replay recorded events
+     * @param event The event to handle
+     * @return Whether the event was handled
+     */
+    bool dispatch(InputEvent const& event);
+
+    /**
+     * Writes all following events to a trace file, which can be replayed with InputTracePlayer
+     * @return false if the file cannot be written
+     */
+    bool startRecording(const fs::path& file);
+    void stopRecording();
+
     GtkXournal* getXournal();
     XournalView* getView();
     ToolHandler* getToolHandler();
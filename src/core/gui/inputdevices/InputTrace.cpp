@@ -0,0 +1,226 @@
+#include "InputTrace.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <locale>
+#include <sstream>
+
+#include <gtk/gtk.h>
+
+#include "InputContext.h"
+
+namespace {
+constexpr auto TRACE_HEADER = "xournalpp-input-trace 1";
+
+auto toGdkEventType(InputEventType type) -> GdkEventType {
+    switch (type) {
+        case BUTTON_PRESS_EVENT:
+            return GDK_BUTTON_PRESS;
+        case BUTTON_2_PRESS_EVENT:
+            return GDK_2BUTTON_PRESS;
+        case BUTTON_3_PRESS_EVENT:
+            return GDK_3BUTTON_PRESS;
+        case BUTTON_RELEASE_EVENT:
+            return GDK_BUTTON_RELEASE;
+        case MOTION_EVENT:
+            return GDK_MOTION_NOTIFY;
+        case ENTER_EVENT:
+            return GDK_ENTER_NOTIFY;
+        case LEAVE_EVENT:
+            return GDK_LEAVE_NOTIFY;
+        case PROXIMITY_IN_EVENT:
+            return GDK_PROXIMITY_IN;
+        case PROXIMITY_OUT_EVENT:
+            return GDK_PROXIMITY_OUT;
+        case SCROLL_EVENT:
+            return GDK_SCROLL;
+        case GRAB_BROKEN_EVENT:
+            return GDK_GRAB_BROKEN;
+        case KEY_PRESS_EVENT:
+            return GDK_KEY_PRESS;
+        case KEY_RELEASE_EVENT:
+            return GDK_KEY_RELEASE;
+        default:
+            return GDK_NOTHING;
+    }
+}
+
+auto toMicroseconds(std::chrono::nanoseconds time) -> double { return static_cast<double>(time.count()) / 1000.0; }
+}  // namespace
+
+auto InputTraceEvent::toInputEvent() const -> InputEvent {
+    InputEvent event{};
+
+    GdkEvent* source = gdk_event_new(toGdkEventType(this->type));
+    if (this->type == KEY_PRESS_EVENT || this->type == KEY_RELEASE_EVENT) {
+        // The keyboard handler reads the key from the GdkEvent
+        source->key.keyval = this->button;
+        source->key.state = this->state;
+        source->key.time = this->timestamp;
+    }
+    event.sourceEvent = source;
+    gdk_event_free(source);
+
+    event.type = this->type;
+    event.deviceClass = this->deviceClass;
+    event.deviceName = const_cast<gchar*>(this->deviceName.c_str());
+    event.absoluteX = this->absoluteX;
+    event.absoluteY = this->absoluteY;
+    event.relativeX = this->relativeX;
+    event.relativeY = this->relativeY;
+    event.button = this->button;
+    event.state = static_cast<GdkModifierType>(this->state);
+    event.pressure = this->pressure;
+    // The handlers only compare sequences, so the number can stand in for the pointer
+    event.sequence = reinterpret_cast<GdkEventSequence*>(static_cast<uintptr_t>(this->sequence));
+    event.timestamp = this->timestamp;
+    return event;
+}
+
+InputTraceWriter::InputTraceWriter(const fs::path& file): out(file, std::ios::trunc) {
+    // Independent of the locale of the user, so traces can be exchanged
+    this->out.imbue(std::locale::classic());
+    this->out << std::setprecision(std::numeric_limits<double>::max_digits10);
+    this->out << TRACE_HEADER << "\n";
+}
+
+auto InputTraceWriter::isOpen() const -> bool { return this->out.good(); }
+
+void InputTraceWriter::write(const InputEvent& event) {
+    size_t sequence = 0;
+    if (event.sequence) {
+        auto it = this->sequences.find(event.sequence);
+        if (it == this->sequences.end()) {
+            it = this->sequences.emplace(event.sequence, this->nextSequence++).first;
+        }
+        sequence = it->second;
+        if (event.type == BUTTON_RELEASE_EVENT) {
+            // GDK may reuse the pointer for the next touch
+            this->sequences.erase(it);
+        }
+    }
+
+    this->out << static_cast<int>(event.type) << '\t' << static_cast<int>(event.deviceClass) << '\t'
+              << event.absoluteX << '\t' << event.absoluteY << '\t' << event.relativeX << '\t' << event.relativeY
+              << '\t' << event.button << '\t' << static_cast<guint>(event.state) << '\t' << event.pressure << '\t'
+              << sequence << '\t' << event.timestamp << '\t' << (event.deviceName ? event.deviceName : "") << '\n';
+}
+
+auto InputTrace::read(const fs::path& file, std::vector<InputTraceEvent>& events) -> bool {
+    std::ifstream in(file);
+    std::string line;
+    if (!std::getline(in, line) || line != TRACE_HEADER) {
+        return false;
+    }
+
+    while (std::getline(in, line)) {
+        if (line.empty()) {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        fields.imbue(std::locale::classic());
+
+        InputTraceEvent event;
+        int type = 0;
+        int deviceClass = 0;
+        fields >> type >> deviceClass >> event.absoluteX >> event.absoluteY >> event.relativeX >> event.relativeY >>
+                event.button >> event.state >> event.pressure >> event.sequence >> event.timestamp;
+        if (!fields || type < UNKNOWN || type > KEY_RELEASE_EVENT || deviceClass < INPUT_DEVICE_MOUSE ||
+            deviceClass > INPUT_DEVICE_IGNORE) {
+            g_warning("Invalid event in input trace %s: %s", file.u8string().c_str(), line.c_str());
+            return false;
+        }
+        event.type = static_cast<InputEventType>(type);
+        event.deviceClass = static_cast<InputDeviceClass>(deviceClass);
+
+        // The name may contain spaces and is the rest of the line
+        if (fields.get() == '\t') {
+            std::getline(fields, event.deviceName);
+        }
+        events.push_back(std::move(event));
+    }
+    return true;
+}
+
+auto InputTrace::typeName(InputEventType type) -> const char* {
+    switch (type) {
+        case BUTTON_PRESS_EVENT:
+            return "press";
+        case BUTTON_2_PRESS_EVENT:
+            return "double-press";
+        case BUTTON_3_PRESS_EVENT:
+            return "triple-press";
+        case BUTTON_RELEASE_EVENT:
+            return "release";
+        case MOTION_EVENT:
+            return "motion";
+        case ENTER_EVENT:
+            return "enter";
+        case LEAVE_EVENT:
+            return "leave";
+        case PROXIMITY_IN_EVENT:
+            return "proximity-in";
+        case PROXIMITY_OUT_EVENT:
+            return "proximity-out";
+        case SCROLL_EVENT:
+            return "scroll";
+        case GRAB_BROKEN_EVENT:
+            return "grab-broken";
+        case KEY_PRESS_EVENT:
+            return "key-press";
+        case KEY_RELEASE_EVENT:
+            return "key-release";
+        default:
+            return "unknown";
+    }
+}
+
+InputTracePlayer::InputTracePlayer(InputContext* context): context(context) {}
+
+void InputTracePlayer::play(const std::vector<InputTraceEvent>& events) {
+    this->times.reserve(this->times.size() + events.size());
+
+    for (const InputTraceEvent& traceEvent: events) {
+        InputEvent event = traceEvent.toInputEvent();
+
+        auto start = std::chrono::steady_clock::now();
+        this->context->dispatch(event);
+        this->times.emplace_back(traceEvent.type, std::chrono::steady_clock::now() - start);
+
+        // Let GTK repaint and run the idle callbacks queued by the handlers, as between real events
+        while (gtk_events_pending()) { gtk_main_iteration(); }
+    }
+}
+
+void InputTracePlayer::printReport(std::ostream& out) const {
+    std::map<std::string, std::vector<std::chrono::nanoseconds>> groups;
+    for (const auto& [type, time]: this->times) {
+        groups[InputTrace::typeName(type)].push_back(time);
+        groups["all"].push_back(time);
+    }
+
+    out << std::left << std::setw(16) << "event" << std::right << std::setw(10) << "count" << std::setw(14)
+        << "total [ms]" << std::setw(12) << "mean [us]" << std::setw(12) << "p50 [us]" << std::setw(12) << "p95 [us]"
+        << std::setw(12) << "max [us]" << "\n";
+    auto flags = out.flags();
+    auto precision = out.precision();
+    out << std::fixed << std::setprecision(1);
+
+    for (auto& [name, times]: groups) {
+        std::sort(times.begin(), times.end());
+        std::chrono::nanoseconds total{0};
+        for (auto time: times) { total += time; }
+
+        out << std::left << std::setw(16) << name << std::right << std::setw(10) << times.size() << std::setw(14)
+            << toMicroseconds(total) / 1000.0 << std::setw(12) << toMicroseconds(total) / times.size()
+            << std::setw(12) << toMicroseconds(times[times.size() / 2]) << std::setw(12)
+            << toMicroseconds(times[std::min(times.size() - 1, times.size() * 95 / 100)]) << std::setw(12)
+            << toMicroseconds(times.back()) << "\n";
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,129 @@
+/*
+ * Xournal++
+ *
+ * Recording and replaying of input events
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gdk/gdk.h>
+#include <glib.h>
+
+#include "model/Point.h"
+
+#include "InputEvents.h"
+#include "filesystem.h"
+
+class InputContext;
+
+/**
+ * An input event as stored in a trace file
+ */
+struct InputTraceEvent {
+    InputEventType type{UNKNOWN};
+    InputDeviceClass deviceClass{INPUT_DEVICE_IGNORE};
+    std::string deviceName;
+
+    double absoluteX{0};
+    double absoluteY{0};
+    double relativeX{0};
+    double relativeY{0};
+
+    guint button{0};
+    guint state{0};
+    double pressure{Point::NO_PRESSURE};
+
+    /**
+     * Touch sequences are numbered in the order they appear, 0 for events without a sequence
+     */
+    size_t sequence{0};
+    guint32 timestamp{0};
+
+    /**
+     * Creates the event passed to the input handlers, with a GdkEvent of the matching type as source. The device name
+     * is not copied, the InputEvent must not outlive this object.
+     */
+    InputEvent toInputEvent() const;
+};
+
+/**
+ * Writes the events processed by an InputContext to a text file.
+ *
+ * The file starts with a header line, followed by one line per event with the tab separated fields of InputTraceEvent
+ * in declaration order, the device name last.
+ */
+class InputTraceWriter {
+public:
+    InputTraceWriter(const fs::path& file);
+
+public:
+    bool isOpen() const;
+
+    void write(const InputEvent& event);
+
+private:
+    std::ofstream out;
+
+    /**
+     * Number of the active touch sequences
+     */
+    std::map<GdkEventSequence*, size_t> sequences;
+    size_t nextSequence = 1;
+};
+
+namespace InputTrace {
+
+/**
+ * Reads a trace written by InputTraceWriter
+ *
+ * @return false if the file cannot be read or is no input trace
+ */
+bool read(const fs::path& file, std::vector<InputTraceEvent>& events);
+
+/**
+ * @return The name of the event type, as used in reports
+ */
+const char* typeName(InputEventType type);
+
+}  // namespace InputTrace
+
+/**
+ * Feeds a recorded trace through the input handlers of an InputContext and measures the time spent on each event.
+ * The time includes the tool handlers (strokes, eraser, selection...) but not the rendering of the view, which GTK
+ * does later in the main loop.
+ */
+class InputTracePlayer {
+public:
+    InputTracePlayer(InputContext* context);
+
+public:
+    /**
+     * Replays all events as fast as possible, must be called in the UI thread
+     */
+    void play(const std::vector<InputTraceEvent>& events);
+
+    /**
+     * Prints the number of events, the total, mean, median, 95th percentile and maximum processing time per event
+     * type and of all events
+     */
+    void printReport(std::ostream& out) const;
+
+private:
+    InputContext* context;
+
+    std::vector<std::pair<InputEventType, std::chrono::nanoseconds>> times;
+};
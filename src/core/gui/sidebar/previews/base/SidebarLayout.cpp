@@ -44,7 +44,7 @@ public:
 
     auto getWidth() const -> int { return this->currentWidth; }
 
-    auto placeAt(int y, GtkLayout* layout) -> int {
+    auto placeAt(int y) -> int {
         int height = 0;
         int x = 0;
 
@@ -54,7 +54,8 @@ public:
         for (SidebarPreviewBaseEntry* p: this->list) {
             int currentY = (height - p->getHeight()) / 2;
 
-            gtk_layout_move(layout, p->getWidget(), x, y + currentY);
+            // Also moves the widget, if the preview has one
+            p->setPosition(x, y + currentY);
 
             x += p->getWidth();
         }
@@ -84,7 +85,7 @@ void SidebarLayout::layout(SidebarPreviewBase* sidebar) {
         if (row.isSpaceFor(p)) {
             row.add(p);
         } else {
-            y += row.placeAt(y, GTK_LAYOUT(sidebar->iconViewPreview));
+            y += row.placeAt(y);
 
             width = std::max(width, row.getWidth());
 
@@ -94,7 +95,7 @@ void SidebarLayout::layout(SidebarPreviewBase* sidebar) {
     }
 
     if (row.getCount() != 0) {
-        y += row.placeAt(y, GTK_LAYOUT(sidebar->iconViewPreview));
+        y += row.placeAt(y);
 
         width = std::max(width, row.getWidth());
 
@@ -5,6 +5,12 @@
 
 #include "SidebarLayout.h"
 #include "SidebarPreviewBaseEntry.h"
+#include "SidebarPreviewCache.h"
+
+/**
+ * Size of the previews kept for scrolling back, in bytes. The most recently stored ones may not be compressed yet.
+ */
+constexpr size_t PREVIEW_CACHE_SIZE = 8 * 1024 * 1024;
 
 
 SidebarPreviewBase::SidebarPreviewBase(Control* control, GladeGui* gui, SidebarToolbar* toolbar):
@@ -12,6 +18,7 @@ SidebarPreviewBase::SidebarPreviewBase(Control* control, GladeGui* gui, SidebarT
     this->layoutmanager = new SidebarLayout();
 
     this->cache = new PdfCache(control->getSettings()->getPdfPageCacheSize());
+    this->previewCache = new SidebarPreviewCache(PREVIEW_CACHE_SIZE);
 
     this->iconViewPreview = gtk_layout_new(nullptr, nullptr);
     g_object_ref(this->iconViewPreview);
@@ -32,23 +39,34 @@ SidebarPreviewBase::SidebarPreviewBase(Control* control, GladeGui* gui, SidebarT
 
     g_signal_connect(this->scrollPreview, "size-allocate", G_CALLBACK(sizeChanged), this);
 
+    GtkAdjustment* vadj = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(this->scrollPreview));
+    g_signal_connect(vadj, "value-changed", G_CALLBACK(scrollChanged), this);
+    g_signal_connect(vadj, "changed", G_CALLBACK(scrollChanged), this);
+
     gtk_widget_show_all(this->scrollPreview);
 }
 
 SidebarPreviewBase::~SidebarPreviewBase() {
+    // The previews remove themselves from the preview cache
+    for (SidebarPreviewBaseEntry* p: this->previews) { delete p; }
+    this->previews.clear();
+
+    GtkAdjustment* vadj = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(this->scrollPreview));
+    g_signal_handlers_disconnect_by_data(vadj, this);
+
     gtk_widget_destroy(this->iconViewPreview);
     this->iconViewPreview = nullptr;
 
     delete this->cache;
     this->cache = nullptr;
 
+    delete this->previewCache;
+    this->previewCache = nullptr;
+
     delete this->layoutmanager;
     this->layoutmanager = nullptr;
 
     this->scrollPreview = nullptr;
-
-    for (SidebarPreviewBaseEntry* p: this->previews) { delete p; }
-    this->previews.clear();
 }
 
 void SidebarPreviewBase::enableSidebar() { enabled = true; }
@@ -68,11 +86,43 @@ void SidebarPreviewBase::sizeChanged(GtkWidget* widget, GtkAllocation* allocatio
     }
 }
 
+void SidebarPreviewBase::scrollChanged(GtkAdjustment* adjustment, SidebarPreviewBase* sidebar) {
+    sidebar->updateVisiblePreviews();
+}
+
 auto SidebarPreviewBase::getZoom() const -> double { return this->zoom; }
 
 auto SidebarPreviewBase::getCache() -> PdfCache* { return this->cache; }
 
-void SidebarPreviewBase::layout() { SidebarLayout::layout(this); }
+auto SidebarPreviewBase::getPreviewCache() -> SidebarPreviewCache* { return this->previewCache; }
+
+void SidebarPreviewBase::layout() {
+    SidebarLayout::layout(this);
+    updateVisiblePreviews();
+}
+
+void SidebarPreviewBase::updateVisiblePreviews() {
+    if (!this->virtualized) {
+        return;
+    }
+
+    GtkAdjustment* vadj = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(this->scrollPreview));
+    double pageSize = gtk_adjustment_get_page_size(vadj);
+
+    // Keep one screen above and below, so short scrolls do not show unrendered previews
+    double top = gtk_adjustment_get_value(vadj) - pageSize;
+    double bottom = gtk_adjustment_get_value(vadj) + 2 * pageSize;
+
+    for (SidebarPreviewBaseEntry* p: this->previews) {
+        bool visible = p->getY() < bottom && p->getY() + p->getHeight() > top;
+        if (visible && p->getWidget() == nullptr) {
+            p->createWidget();
+            gtk_layout_put(GTK_LAYOUT(this->iconViewPreview), p->getWidget(), p->getX(), p->getY());
+        } else if (!visible && p->getWidget() != nullptr) {
+            p->destroyWidget();
+        }
+    }
+}
 
 auto SidebarPreviewBase::hasData() -> bool { return true; }
 
@@ -81,6 +131,7 @@ auto SidebarPreviewBase::getWidget() -> GtkWidget* { return this->scrollPreview;
 void SidebarPreviewBase::documentChanged(DocumentChangeType type) {
     if (type == DOCUMENT_CHANGE_COMPLETE || type == DOCUMENT_CHANGE_CLEARED) {
         this->cache->clearCache();
+        this->previewCache->clear();
         updatePreviews();
     }
 }
@@ -106,20 +157,17 @@ auto SidebarPreviewBase::scrollToPreview(SidebarPreviewBase* sidebar) -> bool {
         // scroll to preview
         GtkAdjustment* hadj = gtk_scrolled_window_get_hadjustment(GTK_SCROLLED_WINDOW(sidebar->scrollPreview));
         GtkAdjustment* vadj = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(sidebar->scrollPreview));
-        GtkWidget* widget = p->getWidget();
-
-        GtkAllocation allocation;
-        gtk_widget_get_allocation(widget, &allocation);
-        int x = allocation.x;
-        int y = allocation.y;
 
-        if (x == -1) {
+        // The previews are placed by layout(), which needs the size of the sidebar
+        if (!gtk_widget_get_mapped(sidebar->iconViewPreview)) {
             g_idle_add(reinterpret_cast<GSourceFunc>(scrollToPreview), sidebar);
             return false;
         }
 
-        gtk_adjustment_clamp_page(vadj, y, y + allocation.height);
-        gtk_adjustment_clamp_page(hadj, x, x + allocation.width);
+        int x = p->getX();
+        int y = p->getY();
+        gtk_adjustment_clamp_page(vadj, y, y + p->getHeight());
+        gtk_adjustment_clamp_page(hadj, x, x + p->getWidth());
     }
     return false;
 }
@@ -23,6 +23,7 @@
 class PdfCache;
 class SidebarLayout;
 class SidebarPreviewBaseEntry;
+class SidebarPreviewCache;
 class SidebarToolbar;
 
 class SidebarPreviewBase: public AbstractSidebarPage {
@@ -39,6 +40,12 @@ public:
      */
     void layout();
 
+    /**
+     * Creates the widgets of the previews near the visible area and destroys the others, if the sidebar is
+     * virtualized
+     */
+    void updateVisiblePreviews();
+
     /**
      * Update the preview images
      */
@@ -64,6 +71,11 @@ public:
      */
     PdfCache* getCache();
 
+    /**
+     * Gets the cache for previews which are scrolled out of view
+     */
+    SidebarPreviewCache* getPreviewCache();
+
 public:
     // DocumentListener interface (only the part handled by SidebarPreviewBase)
     virtual void documentChanged(DocumentChangeType type);
@@ -81,6 +93,11 @@ protected:
      */
     static void sizeChanged(GtkWidget* widget, GtkAllocation* allocation, SidebarPreviewBase* sidebar);
 
+    /**
+     * The sidebar was scrolled or resized
+     */
+    static void scrollChanged(GtkAdjustment* adjustment, SidebarPreviewBase* sidebar);
+
 private:
     /**
      * The scrollbar with the icons
@@ -97,6 +114,11 @@ private:
      */
     PdfCache* cache = nullptr;
 
+    /**
+     * Compressed previews, which are not visible
+     */
+    SidebarPreviewCache* previewCache = nullptr;
+
     /**
      * The layouting class for the prviews
      */
@@ -126,5 +148,11 @@ protected:
      */
     bool enabled = false;
 
+    /**
+     * Only the previews near the visible area have a widget. The previews are created without one and are put into
+     * iconViewPreview by updateVisiblePreviews().
+     */
+    bool virtualized = false;
+
     friend class SidebarLayout;
 };
@@ -5,10 +5,44 @@
 #include "util/i18n.h"
 
 #include "SidebarPreviewBase.h"
+#include "SidebarPreviewCache.h"
 
-SidebarPreviewBaseEntry::SidebarPreviewBaseEntry(SidebarPreviewBase* sidebar, const PageRef& page):
+SidebarPreviewBaseEntry::SidebarPreviewBaseEntry(SidebarPreviewBase* sidebar, const PageRef& page,
+                                                 bool lazyWidget):
         sidebar(sidebar), page(page) {
-    this->widget = gtk_button_new();  // re: issue 1072
+    if (!lazyWidget) {
+        createWidget();
+    }
+}
+
+SidebarPreviewBaseEntry::~SidebarPreviewBaseEntry() {
+    this->sidebar->getControl()->getScheduler()->removeSidebar(this);
+    this->sidebar->getPreviewCache()->remove(this);
+    this->page = nullptr;
+
+    if (this->widget) {
+        gtk_widget_destroy(this->widget);
+        g_object_unref(this->widget);
+        this->widget = nullptr;
+    }
+
+    if (this->crBuffer) {
+        cairo_surface_destroy(this->crBuffer);
+        this->crBuffer = nullptr;
+    }
+}
+
+void SidebarPreviewBaseEntry::createWidget() {
+    if (this->widget) {
+        return;
+    }
+
+    GtkWidget* button = gtk_button_new();  // re: issue 1072
+    {
+        // repaint() checks the widget under the lock, like destroyWidget() resets it
+        std::lock_guard lock(this->drawingMutex);
+        this->widget = button;
+    }
 
     gtk_widget_show(this->widget);
     g_object_ref(this->widget);
@@ -23,21 +57,49 @@ SidebarPreviewBaseEntry::SidebarPreviewBaseEntry(SidebarPreviewBase* sidebar, co
                          return true;
                      }),
                      this);
+
+    widgetCreated();
 }
 
-SidebarPreviewBaseEntry::~SidebarPreviewBaseEntry() {
-    this->sidebar->getControl()->getScheduler()->removeSidebar(this);
-    this->page = nullptr;
+void SidebarPreviewBaseEntry::widgetCreated() {}
 
-    gtk_widget_destroy(this->widget);
-    this->widget = nullptr;
+void SidebarPreviewBaseEntry::destroyWidget() {
+    if (this->widget == nullptr) {
+        return;
+    }
+
+    // A running job stores its result in the cache, see PreviewJob::finishPaint()
+    this->sidebar->getControl()->getScheduler()->removePendingSidebar(this);
 
+    std::lock_guard lock(this->drawingMutex);
     if (this->crBuffer) {
+        if (!this->outdated) {
+            // Only queued for compression, this does not block scrolling
+            this->sidebar->getPreviewCache()->store(this, this->crBuffer);
+        }
         cairo_surface_destroy(this->crBuffer);
         this->crBuffer = nullptr;
     }
+
+    gtk_widget_destroy(this->widget);
+    g_object_unref(this->widget);
+    this->widget = nullptr;
 }
 
+void SidebarPreviewBaseEntry::setPosition(int x, int y) {
+    this->x = x;
+    this->y = y;
+
+    GtkWidget* w = getWidget();
+    if (w && gtk_widget_get_parent(w)) {
+        gtk_layout_move(GTK_LAYOUT(gtk_widget_get_parent(w)), w, x, y);
+    }
+}
+
+auto SidebarPreviewBaseEntry::getX() const -> int { return this->x; }
+
+auto SidebarPreviewBaseEntry::getY() const -> int { return this->y; }
+
 auto SidebarPreviewBaseEntry::drawCallback(GtkWidget* widget, cairo_t* cr, SidebarPreviewBaseEntry* preview)
         -> gboolean {
     preview->paint(cr);
@@ -50,16 +112,32 @@ void SidebarPreviewBaseEntry::setSelected(bool selected) {
     }
     this->selected = selected;
 
-    gtk_widget_queue_draw(this->widget);
+    if (this->widget) {
+        gtk_widget_queue_draw(this->widget);
+    }
 }
 
-void SidebarPreviewBaseEntry::repaint() { sidebar->getControl()->getScheduler()->addRepaintSidebar(this); }
+void SidebarPreviewBaseEntry::repaint() {
+    this->drawingMutex.lock();
+    // A running job may have rendered the page before the change, see PreviewJob::finishPaint()
+    this->generation++;
+    this->outdated = true;
+    bool visible = this->widget != nullptr;
+    this->drawingMutex.unlock();
+
+    this->sidebar->getPreviewCache()->remove(this);
 
-void SidebarPreviewBaseEntry::drawLoadingPage() {
-    GtkAllocation alloc;
-    gtk_widget_get_allocation(widget, &alloc);
+    if (!visible) {
+        // Rendered when it is scrolled into view
+        return;
+    }
 
-    this->crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, alloc.width, alloc.height);
+    sidebar->getControl()->getScheduler()->addRepaintSidebar(this);
+}
+
+void SidebarPreviewBaseEntry::drawLoadingPage() {
+    this->crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, getWidgetWidth(), getWidgetHeight());
+    this->outdated = true;
 
     double zoom = sidebar->getZoom();
 
@@ -90,6 +168,14 @@ void SidebarPreviewBaseEntry::paint(cairo_t* cr) {
 
     this->drawingMutex.lock();
 
+    if (this->crBuffer == nullptr) {
+        this->crBuffer = this->sidebar->getPreviewCache()->take(this);
+        if (this->crBuffer) {
+            // The cache only contains current previews
+            this->outdated = false;
+        }
+    }
+
     if (this->crBuffer == nullptr) {
         drawLoadingPage();
         doRepaint = true;
@@ -128,6 +214,9 @@ void SidebarPreviewBaseEntry::paint(cairo_t* cr) {
 }
 
 void SidebarPreviewBaseEntry::updateSize() {
+    if (this->widget == nullptr) {
+        return;
+    }
     gtk_widget_set_size_request(this->widget, getWidgetWidth(), getWidgetHeight());
 }
 
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -42,14 +43,37 @@ typedef enum {
 
 class SidebarPreviewBaseEntry {
 public:
-    SidebarPreviewBaseEntry(SidebarPreviewBase* sidebar, const PageRef& page);
+    /**
+     * @param lazyWidget Do not create the widget yet, the sidebar calls createWidget() once the preview is visible
+     */
+    SidebarPreviewBaseEntry(SidebarPreviewBase* sidebar, const PageRef& page, bool lazyWidget = false);
     virtual ~SidebarPreviewBaseEntry();
 
 public:
+    /**
+     * @return The widget, nullptr if it is not created
+     */
     virtual GtkWidget* getWidget();
     virtual int getWidth();
     virtual int getHeight();
 
+    /**
+     * Creates the widget, if it does not exist yet
+     */
+    void createWidget();
+
+    /**
+     * Destroys the widget and its buffer, the rendered preview is kept compressed in the cache of the sidebar
+     */
+    void destroyWidget();
+
+    /**
+     * Sets the position in the sidebar, the widget is moved if it exists
+     */
+    void setPosition(int x, int y);
+    int getX() const;
+    int getY() const;
+
     virtual void setSelected(bool selected);
 
     virtual void repaint();
@@ -66,6 +90,11 @@ private:
 protected:
     virtual void mouseButtonPressCallback() = 0;
 
+    /**
+     * Called after the widget was created
+     */
+    virtual void widgetCreated();
+
     virtual int getWidgetWidth();
     virtual int getWidgetHeight();
 
@@ -95,14 +124,30 @@ protected:
     std::mutex drawingMutex{};
 
     /**
-     * The Widget which is used for drawing
+     * The Widget which is used for drawing, nullptr while the preview is not visible
      */
-    GtkWidget* widget;
+    GtkWidget* widget = nullptr;
 
     /**
      * Buffer because of performance reasons
      */
     cairo_surface_t* crBuffer = nullptr;
 
+    /**
+     * The buffer does not show the current page, it is not stored in the cache
+     */
+    bool outdated = false;
+
+    /**
+     * Incremented on each repaint(), a PreviewJob started before discards its result
+     */
+    size_t generation = 0;
+
+    /**
+     * Position in the sidebar
+     */
+    int x = 0;
+    int y = 0;
+
     friend class PreviewJob;
 };
@@ -0,0 +1,208 @@
+#include "SidebarPreviewCache.h"
+
+#include <utility>
+
+#include <zlib.h>
+
+namespace {
+/**
+ * The previews are compressed while scrolling, speed matters more than size
+ */
+constexpr int COMPRESSION_LEVEL = Z_BEST_SPEED;
+
+auto rawSize(cairo_surface_t* surface) -> size_t {
+    return static_cast<size_t>(cairo_image_surface_get_stride(surface)) *
+           static_cast<size_t>(cairo_image_surface_get_height(surface));
+}
+}  // namespace
+
+SidebarPreviewCache::SidebarPreviewCache(size_t maxSize): maxSize(maxSize) {}
+
+SidebarPreviewCache::~SidebarPreviewCache() {
+    {
+        std::lock_guard lock(this->mutex);
+        this->stop = true;
+    }
+    this->condition.notify_all();
+
+    if (this->thread.joinable()) {
+        this->thread.join();
+    }
+    clear();
+}
+
+void SidebarPreviewCache::store(const void* key, cairo_surface_t* surface) {
+    size_t previewSize = rawSize(surface);
+    {
+        std::lock_guard lock(this->mutex);
+        removeLocked(key);
+        if (previewSize > this->maxSize) {
+            return;
+        }
+
+        this->size += previewSize;
+        this->previews.push_front({key, cairo_surface_reference(surface), {}, previewSize});
+        this->index[key] = this->previews.begin();
+
+        while (this->size > this->maxSize) { removeLocked(this->previews.back().key); }
+
+        this->pending.push_back(key);
+        if (!this->thread.joinable()) {
+            this->thread = std::thread(&SidebarPreviewCache::run, this);
+        }
+    }
+    this->condition.notify_all();
+}
+
+void SidebarPreviewCache::run() {
+    std::unique_lock lock(this->mutex);
+    while (true) {
+        this->condition.wait(lock, [this]() { return !this->pending.empty() || this->stop; });
+        if (this->stop) {
+            return;
+        }
+
+        const void* key = this->pending.front();
+        this->pending.pop_front();
+
+        auto it = this->index.find(key);
+        if (it == this->index.end() || it->second->surface == nullptr) {
+            // Removed or replaced and already compressed
+            continue;
+        }
+
+        cairo_surface_t* surface = cairo_surface_reference(it->second->surface);
+        this->compressing = true;
+
+        lock.unlock();
+        Compressed data = compressSurface(surface);
+        lock.lock();
+
+        // The preview may have been taken, removed or replaced meanwhile
+        it = this->index.find(key);
+        if (it != this->index.end() && it->second->surface == surface) {
+            if (!data.pixels.empty()) {
+                Preview& preview = *it->second;
+                cairo_surface_destroy(preview.surface);
+                preview.surface = nullptr;
+
+                this->size -= preview.size;
+                preview.data = std::move(data);
+                preview.size = preview.data.pixels.length();
+                this->size += preview.size;
+            } else {
+                removeLocked(key);
+            }
+        }
+        cairo_surface_destroy(surface);
+
+        this->compressing = false;
+        this->condition.notify_all();
+    }
+}
+
+auto SidebarPreviewCache::take(const void* key) -> cairo_surface_t* {
+    Compressed data;
+    {
+        std::lock_guard lock(this->mutex);
+        auto it = this->index.find(key);
+        if (it == this->index.end()) {
+            return nullptr;
+        }
+
+        cairo_surface_t* surface = it->second->surface;
+        if (surface) {
+            // Not compressed yet, the reference of the cache is handed over
+            it->second->surface = nullptr;
+            removeLocked(key);
+            return surface;
+        }
+
+        data = std::move(it->second->data);
+        removeLocked(key);
+    }
+    return decompressSurface(data);
+}
+
+auto SidebarPreviewCache::compressSurface(cairo_surface_t* surface) -> Compressed {
+    cairo_surface_flush(surface);
+
+    Compressed data;
+    data.format = cairo_image_surface_get_format(surface);
+    data.width = cairo_image_surface_get_width(surface);
+    data.height = cairo_image_surface_get_height(surface);
+    data.stride = cairo_image_surface_get_stride(surface);
+
+    uLong length = rawSize(surface);
+    uLongf compressedLength = compressBound(length);
+    data.pixels.resize(compressedLength);
+    if (compress2(reinterpret_cast<Bytef*>(data.pixels.data()), &compressedLength,
+                  cairo_image_surface_get_data(surface), length, COMPRESSION_LEVEL) != Z_OK) {
+        data.pixels.clear();
+        return data;
+    }
+    data.pixels.resize(compressedLength);
+    data.pixels.shrink_to_fit();
+    return data;
+}
+
+auto SidebarPreviewCache::decompressSurface(const Compressed& data) -> cairo_surface_t* {
+    cairo_surface_t* surface = cairo_image_surface_create(data.format, data.width, data.height);
+    if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS ||
+        cairo_image_surface_get_stride(surface) != data.stride) {
+        cairo_surface_destroy(surface);
+        return nullptr;
+    }
+
+    cairo_surface_flush(surface);
+    uLongf length = rawSize(surface);
+    if (uncompress(cairo_image_surface_get_data(surface), &length,
+                     reinterpret_cast<const Bytef*>(data.pixels.data()), data.pixels.length()) != Z_OK ||
+        length != rawSize(surface)) {
+        cairo_surface_destroy(surface);
+        return nullptr;
+    }
+    cairo_surface_mark_dirty(surface);
+    return surface;
+}
+
+void SidebarPreviewCache::remove(const void* key) {
+    std::lock_guard lock(this->mutex);
+    removeLocked(key);
+}
+
+void SidebarPreviewCache::removeLocked(const void* key) {
+    auto it = this->index.find(key);
+    if (it == this->index.end()) {
+        return;
+    }
+    this->size -= it->second->size;
+    if (it->second->surface) {
+        cairo_surface_destroy(it->second->surface);
+    }
+    this->previews.erase(it->second);
+    this->index.erase(it);
+}
+
+void SidebarPreviewCache::clear() {
+    std::lock_guard lock(this->mutex);
+    for (Preview& preview: this->previews) {
+        if (preview.surface) {
+            cairo_surface_destroy(preview.surface);
+        }
+    }
+    this->previews.clear();
+    this->index.clear();
+    this->pending.clear();
+    this->size = 0;
+}
+
+void SidebarPreviewCache::flush() {
+    std::unique_lock lock(this->mutex);
+    this->condition.wait(lock, [this]() { return (this->pending.empty() && !this->compressing) || this->stop; });
+}
+
+auto SidebarPreviewCache::getSize() const -> size_t {
+    std::lock_guard lock(this->mutex);
+    return this->size;
+}
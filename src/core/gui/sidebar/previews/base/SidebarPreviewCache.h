@@ -0,0 +1,144 @@
+/*
+ * Xournal++
+ *
+ * Compressed previews of the sidebar
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include <cairo.h>
+
+/**
+ * Keeps the rendered previews which are scrolled out of the sidebar, so they do not need to be rendered again when
+ * they are scrolled back in. The pixels of the previews are stored zlib compressed, so they are restored exactly (a PNG
+ * would lose precision when un-premultiplying the alpha). The least recently stored previews are dropped when the
+ * cache exceeds its size.
+ *
+ * Storing a preview does not compress it, so it is cheap enough for the UI thread. The previews are compressed on a
+ * worker thread, until then they count with their raw size.
+ *
+ * All methods are thread safe.
+ */
+class SidebarPreviewCache {
+public:
+    /**
+     * @param maxSize Maximum size of the stored previews, in bytes
+     */
+    SidebarPreviewCache(size_t maxSize);
+    SidebarPreviewCache(const SidebarPreviewCache&) = delete;
+    void operator=(const SidebarPreviewCache&) = delete;
+
+    /**
+     * Stops the worker thread
+     */
+    ~SidebarPreviewCache();
+
+public:
+    /**
+     * Stores a preview, replacing the one stored before for the key, and queues its compression. The cache takes its
+     * own reference of the surface, which must not be changed afterwards.
+     */
+    void store(const void* key, cairo_surface_t* surface);
+
+    /**
+     * Removes the preview from the cache
+     *
+     * @return An image surface with the preview, nullptr if it is not cached
+     */
+    cairo_surface_t* take(const void* key);
+
+    void remove(const void* key);
+    void clear();
+
+    /**
+     * Blocks until all stored previews are compressed
+     */
+    void flush();
+
+    /**
+     * @return The size of all stored previews, in bytes
+     */
+    size_t getSize() const;
+
+private:
+    /**
+     * The raw data of an image surface, zlib compressed
+     */
+    struct Compressed {
+        cairo_format_t format = CAIRO_FORMAT_ARGB32;
+        int width = 0;
+        int height = 0;
+        int stride = 0;
+
+        /**
+         * Empty if the compression failed
+         */
+        std::string pixels;
+    };
+
+    struct Preview {
+        const void* key;
+
+        /**
+         * The raw preview while it waits for compression, nullptr once it is compressed
+         */
+        cairo_surface_t* surface;
+
+        Compressed data;
+
+        /**
+         * Size of the raw or the compressed preview, in bytes
+         */
+        size_t size;
+    };
+
+    void removeLocked(const void* key);
+    void run();
+
+    static Compressed compressSurface(cairo_surface_t* surface);
+
+    /**
+     * @return A new image surface, nullptr if the data is invalid
+     */
+    static cairo_surface_t* decompressSurface(const Compressed& data);
+
+private:
+    size_t maxSize;
+    size_t size = 0;
+
+    mutable std::mutex mutex;
+
+    /**
+     * Notified when a preview is stored, when a compression is finished and on shutdown
+     */
+    std::condition_variable condition;
+
+    /**
+     * Most recently stored first
+     */
+    std::list<Preview> previews;
+    std::unordered_map<const void*, std::list<Preview>::iterator> index;
+
+    /**
+     * Keys of the previews to compress
+     */
+    std::deque<const void*> pending;
+    bool compressing = false;
+    bool stop = false;
+
+    std::thread thread;
+};
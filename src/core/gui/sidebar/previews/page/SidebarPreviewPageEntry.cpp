@@ -4,7 +4,11 @@
 #include "gui/sidebar/previews/base/SidebarPreviewBase.h"
 
 SidebarPreviewPageEntry::SidebarPreviewPageEntry(SidebarPreviewPages* sidebar, const PageRef& page):
-        SidebarPreviewBaseEntry(sidebar, page), sidebar(sidebar) {
+        SidebarPreviewBaseEntry(sidebar, page, true), sidebar(sidebar) {}
+
+SidebarPreviewPageEntry::~SidebarPreviewPageEntry() = default;
+
+void SidebarPreviewPageEntry::widgetCreated() {
     const auto clickCallback = G_CALLBACK(+[](GtkWidget* widget, GdkEvent* event, SidebarPreviewPageEntry* self) {
         // Open context menu on right mouse click
         if (event->type == GDK_BUTTON_PRESS) {
@@ -20,8 +24,6 @@ SidebarPreviewPageEntry::SidebarPreviewPageEntry(SidebarPreviewPages* sidebar, c
     g_signal_connect_after(this->widget, "button-press-event", clickCallback, this);
 }
 
-SidebarPreviewPageEntry::~SidebarPreviewPageEntry() = default;
-
 auto SidebarPreviewPageEntry::getRenderType() -> PreviewRenderType { return RENDER_TYPE_PAGE_PREVIEW; }
 
 void SidebarPreviewPageEntry::mouseButtonPressCallback() {
@@ -34,6 +34,7 @@ public:
 protected:
     SidebarPreviewPages* sidebar;
     virtual void mouseButtonPressCallback();
+    virtual void widgetCreated();
 
 private:
     friend class PreviewJob;
@@ -15,6 +15,9 @@ SidebarPreviewPages::SidebarPreviewPages(Control* control, GladeGui* gui, Sideba
         SidebarPreviewBase(control, gui, toolbar),
         contextMenu(gui->get("sidebarPreviewContextMenu")),
         iconNameHelper(control->getSettings()) {
+    // Documents can have thousands of pages, only the visible previews get a widget
+    this->virtualized = true;
+
     // Connect the context menu actions
     const std::map<std::string, SidebarActions> ctxMenuActions = {
             {"sidebarPreviewDuplicate", SIDEBAR_ACTION_COPY},
@@ -193,7 +196,6 @@ void SidebarPreviewPages::updatePreviews() {
     for (size_t i = 0; i < len; i++) {
         SidebarPreviewBaseEntry* p = new SidebarPreviewPageEntry(this, doc->getPage(i));
         this->previews.push_back(p);
-        gtk_layout_put(GTK_LAYOUT(this->iconViewPreview), p->getWidget(), 0, 0);
     }
 
     layout();
@@ -244,8 +246,6 @@ void SidebarPreviewPages::pageInserted(size_t page) {
 
     this->previews.insert(this->previews.begin() + page, p);
 
-    gtk_layout_put(GTK_LAYOUT(this->iconViewPreview), p->getWidget(), 0, 0);
-
     // Unselect page, to prevent double selection displaying
     unselectPage();
 
@@ -1,27 +1,53 @@
 #include "BackgroundImage.h"
 
+#include <string>
+
 #include "util/Stacktrace.h"
 
+#include "BackgroundImagePool.h"
+
+namespace {
+auto readStream(GInputStream* stream, GError** error) -> std::string {
+    std::string data;
+    char buffer[64 * 1024];
+    gssize read = 0;
+    while ((read = g_input_stream_read(stream, buffer, sizeof(buffer), nullptr, error)) > 0) {
+        data.append(buffer, static_cast<size_t>(read));
+    }
+    return data;
+}
+}  // namespace
+
 /*
  * The contents of a background image
  *
  * Internal impl object, dont move this to an external header/source file due this is the best way to reduce code
  * bloat and increase encapsulation. This object is only used in this source scope and is a RAII Container for the
- * GdkPixbuf*
+ * decoded image, which is shared with all other background images with the same content
  * No xournal memory leak tests necessary, because we use smart ptrs to ensure memory correctness
  */
 
 struct BackgroundImage::Content {
-    Content(fs::path path, GError** error):
-            path(std::move(path)), pixbuf(gdk_pixbuf_new_from_file(this->path.u8string().c_str(), error)) {}
+    Content(fs::path path, GError** error): path(std::move(path)) {
+        gchar* contents = nullptr;
+        gsize length = 0;
+        if (g_file_get_contents(this->path.u8string().c_str(), &contents, &length, error)) {
+            this->image = BackgroundImagePool::getInstance().get(std::string(contents, length), error);
+            g_free(contents);
+        }
+    }
 
-    Content(GInputStream* stream, fs::path path, GError** error):
-            path(std::move(path)), pixbuf(gdk_pixbuf_new_from_stream(stream, nullptr, error)) {}
+    Content(GInputStream* stream, fs::path path, GError** error): path(std::move(path)) {
+        GError* readError = nullptr;
+        std::string data = readStream(stream, &readError);
+        if (readError) {
+            g_propagate_error(error, readError);
+            return;
+        }
+        this->image = BackgroundImagePool::getInstance().get(data, error);
+    }
 
-    ~Content() {
-        g_object_unref(this->pixbuf);
-        this->pixbuf = nullptr;
-    };
+    ~Content() = default;
 
     Content(const Content&) = delete;
     Content(Content&&) = default;
@@ -29,7 +55,7 @@ struct BackgroundImage::Content {
     auto operator=(Content&&) -> Content& = default;
 
     fs::path path;
-    GdkPixbuf* pixbuf = nullptr;
+    std::shared_ptr<const DecodedBackgroundImage> image;
     int pageId = -1;
     bool attach = false;
 };
@@ -83,6 +109,24 @@ void BackgroundImage::setAttach(bool attach) {
     this->img->attach = attach;
 }
 
-auto BackgroundImage::getPixbuf() const -> GdkPixbuf* { return this->img ? this->img->pixbuf : nullptr; }
+auto BackgroundImage::createPixbuf() const -> GdkPixbuf* {
+    return this->img && this->img->image ? this->img->image->createPixbuf() : nullptr;
+}
+
+auto BackgroundImage::getWidth() const -> int {
+    return this->img && this->img->image ? this->img->image->getWidth() : 0;
+}
+
+auto BackgroundImage::getHeight() const -> int {
+    return this->img && this->img->image ? this->img->image->getHeight() : 0;
+}
+
+auto BackgroundImage::getSurface() const -> cairo_surface_t* {
+    return this->img && this->img->image ? this->img->image->getSurface() : nullptr;
+}
+
+auto BackgroundImage::getHash() const -> std::string {
+    return this->img && this->img->image ? this->img->image->getHash() : std::string{};
+}
 
 auto BackgroundImage::isEmpty() const -> bool { return !this->img; }
@@ -46,7 +46,26 @@ struct BackgroundImage {
     bool isAttached() const;
     void setAttach(bool attach);
 
-    GdkPixbuf* getPixbuf() const;
+    /**
+     * @return A new pixbuf of the image, nullptr if no image is loaded. The caller has to unref it.
+     */
+    GdkPixbuf* createPixbuf() const;
+
+    /**
+     * @return The size of the image in pixels, 0 if no image is loaded
+     */
+    int getWidth() const;
+    int getHeight() const;
+
+    /**
+     * @return The image in CAIRO_FORMAT_ARGB32, ready for painting
+     */
+    cairo_surface_t* getSurface() const;
+
+    /**
+     * @return A hash of the image content (see BackgroundImagePool), empty if no image is loaded
+     */
+    std::string getHash() const;
 
     bool isEmpty() const;
 
@@ -0,0 +1,109 @@
+#include "BackgroundImagePool.h"
+
+#include <utility>
+
+DecodedBackgroundImage::DecodedBackgroundImage(std::string hash, GdkPixbuf* pixbuf): hash(std::move(hash)) {
+    // gdk_cairo_set_source_pixbuf() would convert the pixbuf for every paint, do it only once
+    int width = gdk_pixbuf_get_width(pixbuf);
+    int height = gdk_pixbuf_get_height(pixbuf);
+    this->surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+
+    cairo_t* cr = cairo_create(this->surface);
+    gdk_cairo_set_source_pixbuf(cr, pixbuf, 0, 0);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_paint(cr);
+    cairo_destroy(cr);
+    cairo_surface_flush(this->surface);
+}
+
+DecodedBackgroundImage::~DecodedBackgroundImage() {
+    cairo_surface_destroy(this->surface);
+    this->surface = nullptr;
+}
+
+auto DecodedBackgroundImage::getHash() const -> const std::string& { return this->hash; }
+
+auto DecodedBackgroundImage::createPixbuf() const -> GdkPixbuf* {
+    return gdk_pixbuf_get_from_surface(this->surface, 0, 0, getWidth(), getHeight());
+}
+
+auto DecodedBackgroundImage::getSurface() const -> cairo_surface_t* { return this->surface; }
+
+auto DecodedBackgroundImage::getWidth() const -> int { return cairo_image_surface_get_width(this->surface); }
+
+auto DecodedBackgroundImage::getHeight() const -> int { return cairo_image_surface_get_height(this->surface); }
+
+BackgroundImagePool::BackgroundImagePool() = default;
+
+BackgroundImagePool::~BackgroundImagePool() = default;
+
+auto BackgroundImagePool::getInstance() -> BackgroundImagePool& {
+    static BackgroundImagePool instance;
+    return instance;
+}
+
+auto BackgroundImagePool::hash(const std::string& data) -> std::string {
+    gchar* checksum = g_compute_checksum_for_data(G_CHECKSUM_SHA256, reinterpret_cast<const guchar*>(data.data()),
+                                                  data.length());
+    std::string result = checksum;
+    g_free(checksum);
+    return result;
+}
+
+auto BackgroundImagePool::decode(const std::string& data, GError** error) -> GdkPixbuf* {
+    GdkPixbufLoader* loader = gdk_pixbuf_loader_new();
+    bool success = gdk_pixbuf_loader_write(loader, reinterpret_cast<const guchar*>(data.data()), data.length(), error);
+    // Always close the loader, but only report the first error
+    success = gdk_pixbuf_loader_close(loader, success ? error : nullptr) && success;
+
+    GdkPixbuf* pixbuf = nullptr;
+    if (success) {
+        pixbuf = gdk_pixbuf_loader_get_pixbuf(loader);
+        if (pixbuf) {
+            g_object_ref(pixbuf);
+        }
+    }
+    g_object_unref(loader);
+    return pixbuf;
+}
+
+auto BackgroundImagePool::get(const std::string& data, GError** error) -> std::shared_ptr<const DecodedBackgroundImage> {
+    std::string key = hash(data);
+
+    {
+        std::lock_guard lock(this->mutex);
+        if (auto it = this->images.find(key); it != this->images.end()) {
+            if (auto image = it->second.lock()) {
+                return image;
+            }
+        }
+    }
+
+    // Decode without holding the lock, loading a document must not block painting other pages
+    GdkPixbuf* pixbuf = decode(data, error);
+    if (pixbuf == nullptr) {
+        return nullptr;
+    }
+    auto image = std::make_shared<const DecodedBackgroundImage>(key, pixbuf);
+    g_object_unref(pixbuf);
+
+    std::lock_guard lock(this->mutex);
+
+    auto& entry = this->images[key];
+    if (auto existing = entry.lock()) {
+        // Decoded by another thread meanwhile
+        return existing;
+    }
+    entry = image;
+
+    // Forget the images which were freed
+    for (auto it = this->images.begin(); it != this->images.end();) {
+        if (it->second.expired()) {
+            it = this->images.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    return image;
+}
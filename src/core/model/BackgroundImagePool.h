@@ -0,0 +1,94 @@
+/*
+ * Xournal++
+ *
+ * Decoded background images, shared by all pages
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <gtk/gtk.h>
+
+/**
+ * A decoded background image. Immutable, so it can be shared by any number of pages and threads.
+ *
+ * Only the converted surface is kept, large backgrounds would otherwise be in memory twice.
+ */
+class DecodedBackgroundImage {
+public:
+    /**
+     * @param pixbuf The decoded image, converted for painting. The caller keeps its reference.
+     */
+    DecodedBackgroundImage(std::string hash, GdkPixbuf* pixbuf);
+    ~DecodedBackgroundImage();
+
+    DecodedBackgroundImage(const DecodedBackgroundImage&) = delete;
+    DecodedBackgroundImage& operator=(const DecodedBackgroundImage&) = delete;
+
+public:
+    const std::string& getHash() const;
+
+    /**
+     * @return A new pixbuf of the image, used for saving. The caller has to unref it.
+     */
+    GdkPixbuf* createPixbuf() const;
+
+    /**
+     * @return The image converted once to CAIRO_FORMAT_ARGB32, used for painting
+     */
+    cairo_surface_t* getSurface() const;
+
+    int getWidth() const;
+    int getHeight() const;
+
+private:
+    std::string hash;
+    cairo_surface_t* surface = nullptr;
+};
+
+/**
+ * Background images are identified by a hash of their encoded content, so the same image file used by several pages
+ * (e.g. a template applied to all pages, or attached several times) is only decoded and kept in memory once.
+ *
+ * The pool only holds weak references: an image is freed as soon as no page (or undo action) uses it anymore.
+ */
+class BackgroundImagePool {
+private:
+    BackgroundImagePool();
+    ~BackgroundImagePool();
+
+public:
+    BackgroundImagePool(const BackgroundImagePool&) = delete;
+    void operator=(const BackgroundImagePool&) = delete;
+
+    static BackgroundImagePool& getInstance();
+
+    /**
+     * @param data The encoded image (any format supported by GdkPixbuf)
+     * @return The shared decoded image, nullptr if `data` cannot be decoded (`error` is set in this case)
+     */
+    std::shared_ptr<const DecodedBackgroundImage> get(const std::string& data, GError** error);
+
+    /**
+     * @return A SHA-256 hash of `data`, hex encoded
+     */
+    static std::string hash(const std::string& data);
+
+private:
+    static GdkPixbuf* decode(const std::string& data, GError** error);
+
+private:
+    mutable std::mutex mutex;
+
+    std::map<std::string, std::weak_ptr<const DecodedBackgroundImage>> images;
+};
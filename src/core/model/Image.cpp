@@ -1,20 +1,35 @@
 #include "Image.h"
 
+#include <cstring>
 #include <utility>
 
 #include "util/pixbuf-utils.h"
 #include "util/serializing/ObjectInputStream.h"
 #include "util/serializing/ObjectOutputStream.h"
 
-Image::Image(): Element(ELEMENT_IMAGE) {}
+#include "ImageCache.h"
 
-Image::~Image() {
-    if (this->image) {
-        cairo_surface_destroy(this->image);
-        this->image = nullptr;
-    }
+namespace {
+auto writePng(std::string* png, const unsigned char* data, unsigned int length) -> cairo_status_t {
+    png->append(reinterpret_cast<const char*>(data), length);
+    return CAIRO_STATUS_SUCCESS;
 }
 
+/**
+ * The decoded surfaces are dropped together with the last Image using the data
+ */
+auto makeData(std::string data, size_t id) -> std::shared_ptr<const std::string> {
+    return std::shared_ptr<const std::string>(new std::string(std::move(data)), [id](const std::string* png) {
+        ImageCache::getInstance().remove(id);
+        delete png;
+    });
+}
+}  // namespace
+
+Image::Image(): Element(ELEMENT_IMAGE) {}
+
+Image::~Image() = default;
+
 auto Image::clone() -> Element* {
     auto* img = new Image();
 
@@ -24,11 +39,10 @@ auto Image::clone() -> Element* {
     img->width = this->width;
     img->height = this->height;
     img->data = this->data;
+    img->dataId = this->dataId;
 
-    img->image = cairo_surface_reference(this->image);
     img->snappedBounds = this->snappedBounds;
     img->sizeCalculated = this->sizeCalculated;
-    img->read = this->read;
 
     return img;
 }
@@ -43,45 +57,50 @@ void Image::setHeight(double height) {
     this->calcSize();
 }
 
-auto Image::cairoReadFunction(const Image* image, unsigned char* data, unsigned int length) -> cairo_status_t {
-    for (unsigned int i = 0; i < length; i++, image->read++) {
-        if (image->read >= image->data.length()) {
-            return CAIRO_STATUS_READ_ERROR;
-        }
-
-        data[i] = image->data[image->read];
-    }
-
-    return CAIRO_STATUS_SUCCESS;
-}
-
 void Image::setImage(std::string data) {
-    if (this->image) {
-        cairo_surface_destroy(this->image);
-        this->image = nullptr;
-    }
-    this->data = std::move(data);
+    this->dataId = ImageCache::createId();
+    this->data = makeData(std::move(data), this->dataId);
 }
 
 void Image::setImage(GdkPixbuf* img) { setImage(f_pixbuf_to_cairo_surface(img)); }
 
 void Image::setImage(cairo_surface_t* image) {
-    if (this->image) {
-        cairo_surface_destroy(this->image);
-        this->image = nullptr;
+    std::string png;
+    cairo_surface_write_to_png_stream(image, reinterpret_cast<cairo_write_func_t>(&writePng), &png);
+    this->dataId = ImageCache::createId();
+    this->data = makeData(std::move(png), this->dataId);
+
+    // Already decoded, no need to decode it again for drawing
+    ImageCache::getInstance().insert(this->dataId, image);
+    cairo_surface_destroy(image);
+}
+
+auto Image::getImage(int width, int height, bool decode) const -> cairo_surface_t* {
+    if (!this->data || this->data->empty()) {
+        return nullptr;
     }
 
-    this->image = image;
+    return ImageCache::getInstance().get(this->dataId, *this->data, width, height, decode);
 }
 
-auto Image::getImage() const -> cairo_surface_t* {
-    if (this->image == nullptr && this->data.length()) {
-        this->read = 0;
-        this->image = cairo_image_surface_create_from_png_stream(
-                reinterpret_cast<cairo_read_func_t>(&cairoReadFunction), const_cast<Image*>(this));
+auto Image::decodeImage() const -> cairo_surface_t* {
+    if (!this->data || this->data->empty()) {
+        return nullptr;
     }
 
-    return this->image;
+    cairo_surface_t* image = ImageCache::decode(*this->data);
+    if (image) {
+        gchar* hash = g_compute_checksum_for_data(G_CHECKSUM_SHA1, reinterpret_cast<const guchar*>(this->data->data()),
+                                                  this->data->length());
+        cairo_surface_set_mime_data(image, CAIRO_MIME_TYPE_UNIQUE_ID, reinterpret_cast<const unsigned char*>(hash),
+                                    strlen(hash), g_free, hash);
+    }
+    return image;
+}
+
+auto Image::getImageData() const -> const std::string& {
+    static const std::string empty;
+    return this->data ? *this->data : empty;
 }
 
 void Image::scale(double x0, double y0, double fx, double fy, double rotation,
@@ -108,7 +127,7 @@ void Image::serialize(ObjectOutputStream& out) const {
     out.writeDouble(this->width);
     out.writeDouble(this->height);
 
-    out.writeImage(this->image);
+    out.writeImageData(getImageData());
 
     out.endObject();
 }
@@ -121,12 +140,7 @@ void Image::readSerialized(ObjectInputStream& in) {
     this->width = in.readDouble();
     this->height = in.readDouble();
 
-    if (this->image) {
-        cairo_surface_destroy(this->image);
-        this->image = nullptr;
-    }
-
-    this->image = in.readImage();
+    setImage(in.readImageData());
 
     in.endObject();
     this->calcSize();
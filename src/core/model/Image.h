@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -27,9 +28,34 @@ public:
     void setHeight(double height);
 
     void setImage(std::string data);
+
+    /**
+     * Takes the ownership of `image`, which is PNG encoded for storage
+     */
     void setImage(cairo_surface_t* image);
     void setImage(GdkPixbuf* img);
-    cairo_surface_t* getImage() const;
+
+    /**
+     * @param decode If false, only an already decoded image is returned, e.g. for drawing on the UI thread
+     *
+     * @return A new reference to the decoded image with a resolution of at least width x height pixels (if available),
+     *         nullptr if the image cannot be decoded. The surfaces are shared and may be smaller than the original.
+     */
+    cairo_surface_t* getImage(int width, int height, bool decode = true) const;
+
+    /**
+     * Decodes the full resolution without caching it, for vector output (PDF export, printing) which keeps the surface
+     * only until the page is finished. The surface is tagged with a content hash, so the same image is only embedded
+     * once per file.
+     *
+     * @return The new surface, nullptr if the image cannot be decoded
+     */
+    cairo_surface_t* decodeImage() const;
+
+    /**
+     * @return The PNG encoded image
+     */
+    const std::string& getImageData() const;
 
     virtual void scale(double x0, double y0, double fx, double fy, double rotation, bool restoreLineWidth);
     virtual void rotate(double x0, double y0, double th);
@@ -47,12 +73,14 @@ public:
 private:
     void calcSize() const override;
 
-    static cairo_status_t cairoReadFunction(const Image* image, unsigned char* data, unsigned int length);
-
 private:
-    mutable cairo_surface_t* image = nullptr;
-
-    std::string data;
+    /**
+     * PNG encoded, shared by the clones of this Image. The decoded image is kept in the ImageCache.
+     */
+    std::shared_ptr<const std::string> data;
 
-    mutable std::string::size_type read = false;
+    /**
+     * Identifies the data in the ImageCache
+     */
+    size_t dataId = 0;
 };
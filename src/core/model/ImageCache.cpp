@@ -0,0 +1,175 @@
+#include "ImageCache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+
+#include <glib.h>
+
+namespace {
+struct PngReader {
+    const std::string& data;
+    size_t pos = 0;
+};
+
+auto readPng(PngReader* reader, unsigned char* data, unsigned int length) -> cairo_status_t {
+    if (reader->data.length() - reader->pos < length) {
+        return CAIRO_STATUS_READ_ERROR;
+    }
+    std::copy_n(reader->data.data() + reader->pos, length, data);
+    reader->pos += length;
+    return CAIRO_STATUS_SUCCESS;
+}
+
+}  // namespace
+
+ImageCache::ImageCache() = default;
+
+ImageCache::~ImageCache() = default;
+
+auto ImageCache::getInstance() -> ImageCache& {
+    static ImageCache instance;
+    return instance;
+}
+
+auto ImageCache::getLevel(int imageWidth, int imageHeight, int width, int height) -> int {
+    int level = 0;
+    while ((imageWidth >> (level + 1)) >= std::max(width, 1) && (imageHeight >> (level + 1)) >= std::max(height, 1)) {
+        level++;
+    }
+    return level;
+}
+
+auto ImageCache::decode(const std::string& png) -> cairo_surface_t* {
+    PngReader reader{png};
+    cairo_surface_t* image =
+            cairo_image_surface_create_from_png_stream(reinterpret_cast<cairo_read_func_t>(&readPng), &reader);
+    if (cairo_surface_status(image) != CAIRO_STATUS_SUCCESS) {
+        g_warning("Could not decode image: %s", cairo_status_to_string(cairo_surface_status(image)));
+        cairo_surface_destroy(image);
+        return nullptr;
+    }
+    return image;
+}
+
+auto ImageCache::halve(cairo_surface_t* image) -> cairo_surface_t* {
+    int imageWidth = cairo_image_surface_get_width(image);
+    int imageHeight = cairo_image_surface_get_height(image);
+    int width = std::max(imageWidth / 2, 1);
+    int height = std::max(imageHeight / 2, 1);
+
+    cairo_surface_t* result = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+    cairo_t* cr = cairo_create(result);
+    cairo_scale(cr, static_cast<double>(width) / imageWidth, static_cast<double>(height) / imageHeight);
+    cairo_set_source_surface(cr, image, 0, 0);
+    cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_GOOD);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_paint(cr);
+    cairo_destroy(cr);
+
+    return result;
+}
+
+auto ImageCache::createId() -> size_t {
+    static std::atomic<size_t> nextId{1};
+    return nextId++;
+}
+
+auto ImageCache::get(size_t id, const std::string& png, int width, int height, bool allowDecode) -> cairo_surface_t* {
+    cairo_surface_t* source = nullptr;
+    int sourceLevel = 0;
+    int level = 0;
+
+    {
+        std::lock_guard lock(this->mutex);
+
+        if (auto size = this->sizes.find(id); size != this->sizes.end()) {
+            level = getLevel(size->second.first, size->second.second, width, height);
+
+            // Use the requested level, or build it from the next larger one which is still cached
+            for (int l = level; l >= 0 && !source; l--) {
+                source = this->surfaces.get({id, l});
+                sourceLevel = l;
+            }
+
+            // Without decoding, a larger level is used as it is and a smaller one is better than nothing
+            if (source && (sourceLevel == level || !allowDecode)) {
+                return source;
+            }
+            if (!allowDecode) {
+                int smallest = getLevel(size->second.first, size->second.second, 1, 1);
+                for (int l = level + 1; l <= smallest; l++) {
+                    if (cairo_surface_t* smaller = this->surfaces.get({id, l})) {
+                        return smaller;
+                    }
+                }
+            }
+
+            // All levels may have been dropped by the budget, then the image is decoded again (if allowed)
+            if (!source) {
+                this->sizes.erase(size);
+            }
+        }
+
+        if (!source && !allowDecode) {
+            return nullptr;
+        }
+    }
+
+    bool decoded = false;
+    if (!source) {
+        source = decode(png);
+        if (!source) {
+            return nullptr;
+        }
+        decoded = true;
+        sourceLevel = 0;
+        level = getLevel(cairo_image_surface_get_width(source), cairo_image_surface_get_height(source), width,
+                         height);
+    }
+
+    cairo_surface_t* result = cairo_surface_reference(source);
+    for (int l = sourceLevel; l < level; l++) {
+        cairo_surface_t* next = halve(result);
+        cairo_surface_destroy(result);
+        result = next;
+    }
+
+    {
+        std::lock_guard lock(this->mutex);
+
+        // If the data was removed meanwhile, the surfaces are inserted anyway. The ID is not used again, so they are
+        // only dropped as least recently used.
+        if (decoded) {
+            this->sizes[id] = {cairo_image_surface_get_width(source), cairo_image_surface_get_height(source)};
+            // If only a smaller level is needed, the full resolution is the first to be dropped
+            this->surfaces.insert({id, 0}, source, level > 0);
+        }
+        if (level != sourceLevel) {
+            this->surfaces.insert({id, level}, result);
+        }
+    }
+
+    cairo_surface_destroy(source);
+    return result;
+}
+
+void ImageCache::insert(size_t id, cairo_surface_t* image) {
+    std::lock_guard lock(this->mutex);
+    this->sizes[id] = {cairo_image_surface_get_width(image), cairo_image_surface_get_height(image)};
+    this->surfaces.insert({id, 0}, image);
+}
+
+void ImageCache::remove(size_t id) {
+    std::lock_guard lock(this->mutex);
+    this->surfaces.removeRange({id, 0}, {id, INT_MAX});
+    this->sizes.erase(id);
+}
+
+void ImageCache::clear() {
+    std::lock_guard lock(this->mutex);
+    this->surfaces.clear();
+    this->sizes.clear();
+}
+
+auto ImageCache::getMemoryUsage() const -> size_t { return this->surfaces.getMemoryUsage(); }
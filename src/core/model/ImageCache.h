@@ -0,0 +1,107 @@
+/*
+ * Xournal++
+ *
+ * Decoded images, shared by all Image elements
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include <cairo.h>
+
+#include "util/RasterCache.h"
+
+/**
+ * Images are stored PNG encoded and only decoded for drawing. For every image the cache keeps mip levels (each level
+ * half the size of the previous one), so an image shown small does not need its full resolution in memory, and the
+ * least recently used surfaces are dropped when the budget shared with the other caches is exceeded (see
+ * RasterBudget).
+ *
+ * The encoded data is identified by an ID from createId(), Images sharing the same data share the decoded surfaces.
+ * Unlike the address of the data, an ID is never reused, so a surface which is inserted after its data was removed
+ * can never be returned for other data. Decoding happens in the calling thread (a render thread) without holding the
+ * lock of the cache.
+ */
+class ImageCache {
+private:
+    ImageCache();
+    ~ImageCache();
+
+public:
+    ImageCache(const ImageCache&) = delete;
+    void operator=(const ImageCache&) = delete;
+
+    static ImageCache& getInstance();
+
+    /**
+     * @return A new ID for encoded image data
+     */
+    static size_t createId();
+
+    /**
+     * @param id The ID of `png`
+     * @param allowDecode If false, nullptr is returned instead of decoding `png`, e.g. on the UI thread. A cached
+     *                    smaller mip level is returned if there is no larger one.
+     *
+     * @return A new reference to the smallest mip level with at least width x height pixels (or the full
+     *         resolution), nullptr if `png` cannot be decoded
+     */
+    cairo_surface_t* get(size_t id, const std::string& png, int width, int height, bool allowDecode = true);
+
+    /**
+     * Adds the full resolution of the image `id`, if it was decoded elsewhere (e.g. a pasted image). Takes a new
+     * reference.
+     */
+    void insert(size_t id, cairo_surface_t* image);
+
+    /**
+     * Drops all surfaces of the image `id`, e.g. when its data is freed
+     */
+    void remove(size_t id);
+
+    void clear();
+
+    size_t getMemoryUsage() const;
+
+    /**
+     * @return The mip level to use for drawing an image of the given size with width x height pixels
+     */
+    static int getLevel(int imageWidth, int imageHeight, int width, int height);
+
+    /**
+     * Decodes `png` without caching it
+     *
+     * @return The new surface, nullptr if `png` cannot be decoded
+     */
+    static cairo_surface_t* decode(const std::string& png);
+
+private:
+    static cairo_surface_t* halve(cairo_surface_t* image);
+
+private:
+    /**
+     * Protects `sizes` and keeps the lookup of the levels of an image consistent
+     */
+    std::mutex mutex;
+
+    /**
+     * The mip levels, keyed by ID and level
+     */
+    RasterCache<std::pair<size_t, int>> surfaces;
+
+    /**
+     * The full resolution of the decoded images, dropped when the image is removed or a lookup finds none of its
+     * levels anymore
+     */
+    std::map<size_t, std::pair<int, int>> sizes;
+};
@@ -2,7 +2,11 @@
 
 #include "util/Stacktrace.h"
 
-Layer::Layer() = default;
+namespace {
+std::atomic<size_t> nextLayerId{1};
+}
+
+Layer::Layer(): id(nextLayerId++) {}
 
 Layer::~Layer() {
     for (Element* e: this->elements) { delete e; }
@@ -36,6 +40,7 @@ void Layer::addElement(Element* e) {
     }
 
     this->elements.push_back(e);
+    this->revision++;
 }
 
 void Layer::insertElement(Element* e, ElementIndex pos) {
@@ -65,6 +70,7 @@ void Layer::insertElement(Element* e, ElementIndex pos) {
     } else {
         this->elements.insert(this->elements.begin() + pos, e);
     }
+    this->revision++;
 }
 
 auto Layer::indexOf(Element* e) const -> ElementIndex {
@@ -81,6 +87,7 @@ auto Layer::removeElement(Element* e, bool free) -> ElementIndex {
     for (unsigned int i = 0; i < this->elements.size(); i++) {
         if (e == this->elements[i]) {
             this->elements.erase(this->elements.begin() + i);
+            this->revision++;
 
             if (free) {
                 delete e;
@@ -104,7 +111,12 @@ auto Layer::isVisible() const -> bool { return visible; }
 /**
  * @return true if the layer is visible
  */
-void Layer::setVisible(bool visible) { this->visible = visible; }
+void Layer::setVisible(bool visible) {
+    if (this->visible != visible) {
+        this->visible = visible;
+        this->revision++;
+    }
+}
 
 auto Layer::getElements() const -> const std::vector<Element*>& { return this->elements; }
 
@@ -113,3 +125,9 @@ auto Layer::hasName() const -> bool { return name.has_value(); }
 auto Layer::getName() const -> std::string { return name.value_or(""); }
 
 void Layer::setName(const std::string& newName) { this->name = newName; }
+
+auto Layer::getRevision() const -> size_t { return this->revision; }
+
+void Layer::markChanged() { this->revision++; }
+
+auto Layer::getId() const -> size_t { return this->id; }
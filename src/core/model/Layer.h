@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <string>
 #include <vector>
 
@@ -93,9 +95,33 @@ public:
      */
     void setName(const std::string& newName);
 
+    /**
+     * Incremented whenever an Element is added or removed, the visibility changes or markChanged() is called.
+     * Views compare it to decide whether a cached rendering of this Layer is still up to date.
+     */
+    size_t getRevision() const;
+
+    /**
+     * Notifies views that an Element on this Layer was modified in place
+     */
+    void markChanged();
+
+    /**
+     * @return An ID which is unique for the lifetime of the process. Unlike the address of the Layer, it is not
+     * reused after the Layer is deleted.
+     */
+    size_t getId() const;
+
 private:
     std::vector<Element*> elements;
 
+    const size_t id;
+
+    /**
+     * Written by the UI thread, read by the render threads
+     */
+    std::atomic<size_t> revision{0};
+
     bool visible = true;
 
     optional<std::string> name;
@@ -79,7 +79,7 @@ void Stroke::serialize(ObjectOutputStream& out) const {
 
     out.writeInt(fill);
 
-    out.writeData(this->points.data(), this->points.size(), sizeof(Point));
+    out.writeData(this->points);
 
     this->lineStyle.serialize(out);
 
@@ -97,11 +97,7 @@ void Stroke::readSerialized(ObjectInputStream& in) {
 
     this->fill = in.readInt();
 
-    Point* p{};
-    int count{};
-    in.readData(reinterpret_cast<void**>(&p), &count);
-    this->points = std::vector<Point>{p, p + count};
-    g_free(p);
+    in.readData(this->points);
     this->lineStyle.readSerialized(in);
 
     in.endObject();
@@ -246,6 +242,21 @@ void Stroke::scale(double x0, double y0, double fx, double fy, double rotation,
     this->sizeCalculated = false;
 }
 
+void Stroke::transform(const cairo_matrix_t& matrix, double fz) {
+    for (auto&& p: points) {
+        cairo_matrix_transform_point(&matrix, &p.x, &p.y);
+
+        if (p.z != Point::NO_PRESSURE) {
+            p.z *= fz;
+        }
+    }
+    this->width *= fz;
+
+    // Calculated here, so the bounds are ready when the stroke is transformed on a worker thread
+    this->sizeCalculated = true;
+    calcSize();
+}
+
 auto Stroke::hasPressure() const -> bool {
     if (!this->points.empty()) {
         return this->points[0].z != Point::NO_PRESSURE;
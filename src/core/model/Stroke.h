@@ -95,6 +95,14 @@ public:
     void scale(double x0, double y0, double fx, double fy, double rotation, bool restoreLineWidth) override;
     void rotate(double x0, double y0, double th) override;
 
+    /**
+     * Applies an affine transformation to all points in a single pass and updates the bounds
+     *
+     * @param matrix The transformation of the point coordinates
+     * @param fz The factor for the line width and the pressure values
+     */
+    void transform(const cairo_matrix_t& matrix, double fz);
+
     bool isInSelection(ShapeContainer* container) override;
 
     ErasableStroke* getErasable();
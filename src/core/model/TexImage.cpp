@@ -1,27 +1,58 @@
 #include "TexImage.h"
 
+#include <cmath>
 #include <utility>
 
 #include "util/pixbuf-utils.h"
 #include "util/serializing/ObjectInputStream.h"
 #include "util/serializing/ObjectOutputStream.h"
 
+#include "TexRasterCache.h"
+
+namespace {
+/**
+ * Rasters are rendered in steps of 2^(1/ZOOM_BUCKETS_PER_OCTAVE)
+ */
+constexpr double ZOOM_BUCKETS_PER_OCTAVE = 4;
+
+/**
+ * Larger rasters are not cached, this size is only reached at extreme zoom levels
+ */
+constexpr double MAX_RASTER_PIXELS = 4096.0 * 4096.0;
+
+auto zoomBucket(double scale) -> int { return static_cast<int>(std::ceil(std::log2(scale) * ZOOM_BUCKETS_PER_OCTAVE)); }
+
+auto bucketScale(int bucket) -> double { return std::exp2(bucket / ZOOM_BUCKETS_PER_OCTAVE); }
+}  // namespace
+
 TexImage::TexImage(): Element(ELEMENT_TEXIMAGE) { this->sizeCalculated = true; }
 
 TexImage::~TexImage() { freeImageAndPdf(); }
 
 void TexImage::freeImageAndPdf() {
+    freeRasters();
+
     if (this->image) {
         cairo_surface_destroy(this->image);
         this->image = nullptr;
     }
 
+    if (this->pdfPage) {
+        g_object_unref(this->pdfPage);
+        this->pdfPage = nullptr;
+    }
+
     if (this->pdf) {
         g_object_unref(this->pdf);
         this->pdf = nullptr;
     }
 }
 
+void TexImage::freeRasters() {
+    std::lock_guard lock(this->rasterMutex);
+    TexRasterCache::getInstance().remove(this);
+}
+
 auto TexImage::clone() -> Element* {
     auto* img = new TexImage();
     img->x = this->x;
@@ -86,10 +117,11 @@ auto TexImage::loadData(std::string&& bytes, GError** err) -> bool {
         if (!pdf || poppler_document_get_n_pages(this->pdf) < 1) {
             return false;
         }
+        this->pdfPage = poppler_document_get_page(this->pdf, 0);
+        poppler_page_get_size(this->pdfPage, &this->pdfPageWidth, &this->pdfPageHeight);
         if (!this->width && !this->height) {
-            PopplerPage* page = poppler_document_get_page(this->pdf, 0);
-            poppler_page_get_size(page, &this->width, &this->height);
-            g_object_unref(page);
+            this->width = this->pdfPageWidth;
+            this->height = this->pdfPageHeight;
         }
     } else if (type == "PNG") {
         this->image = cairo_image_surface_create_from_png_stream(
@@ -105,6 +137,48 @@ auto TexImage::getImage() const -> cairo_surface_t* { return this->image; }
 
 auto TexImage::getPdf() const -> PopplerDocument* { return this->pdf; }
 
+auto TexImage::getPdfPage() const -> PopplerPage* { return this->pdfPage; }
+
+auto TexImage::getRaster(double width, double height) const -> cairo_surface_t* {
+    if (this->pdfPage == nullptr || this->pdfPageWidth <= 0 || this->pdfPageHeight <= 0 || width <= 0 ||
+        height <= 0) {
+        return nullptr;
+    }
+
+    int xBucket = zoomBucket(width / this->pdfPageWidth);
+    int yBucket = zoomBucket(height / this->pdfPageHeight);
+
+    std::lock_guard lock(this->rasterMutex);
+    TexRasterCache& cache = TexRasterCache::getInstance();
+    if (cairo_surface_t* raster = cache.get(this, xBucket, yBucket)) {
+        return raster;
+    }
+
+    double xScale = bucketScale(xBucket);
+    double yScale = bucketScale(yBucket);
+    double rasterWidth = std::ceil(this->pdfPageWidth * xScale);
+    double rasterHeight = std::ceil(this->pdfPageHeight * yScale);
+    if (rasterWidth * rasterHeight > MAX_RASTER_PIXELS) {
+        return nullptr;
+    }
+
+    // Rendering under the lock: poppler may not render the same page from two threads at the same time
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, static_cast<int>(rasterWidth),
+                                                          static_cast<int>(rasterHeight));
+    cairo_t* cr = cairo_create(surface);
+    cairo_scale(cr, xScale, yScale);
+    poppler_page_render(this->pdfPage, cr);
+    cairo_destroy(cr);
+
+    cache.insert(this, xBucket, yBucket, surface);
+    return surface;
+}
+
+void TexImage::renderPdf(cairo_t* cr) const {
+    std::lock_guard lock(this->rasterMutex);
+    poppler_page_render(this->pdfPage, cr);
+}
+
 void TexImage::scale(double x0, double y0, double fx, double fy, double rotation,
                      bool) {  // line width scaling option is not used
 
@@ -150,6 +224,7 @@ void TexImage::readSerialized(ObjectInputStream& in) {
     in.readData(reinterpret_cast<void**>(&data), &len);
 
     this->loadData(std::string(data, len), nullptr);
+    g_free(data);
 
     in.endObject();
     this->calcSize();
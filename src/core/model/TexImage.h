@@ -12,6 +12,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -50,6 +51,26 @@ public:
      */
     PopplerDocument* getPdf() const;
 
+    /**
+     * @return The first page of the PDF, parsed once when the data is loaded, nullptr if not rendered as a PDF.
+     */
+    PopplerPage* getPdfPage() const;
+
+    /**
+     * Rasterizes the PDF for drawing at a size of about width x height device pixels. The raster is rendered for a
+     * zoom bucket (steps of a quarter octave, rounded up) and kept in the TexRasterCache until the data changes, so
+     * redrawing at a similar zoom only paints the cached surface instead of interpreting the PDF again.
+     *
+     * @return A new reference to the raster, nullptr if not rendered as a PDF or if the size is too large to cache
+     */
+    cairo_surface_t* getRaster(double width, double height) const;
+
+    /**
+     * Renders the PDF page to `cr` as vectors (export, printing, extreme zoom levels). Must only be called if rendered
+     * as a PDF.
+     */
+    void renderPdf(cairo_t* cr) const;
+
     virtual void scale(double x0, double y0, double fx, double fy, double rotation, bool restoreLineWidth);
     virtual void rotate(double x0, double y0, double th);
 
@@ -79,12 +100,30 @@ private:
      */
     void freeImageAndPdf();
 
+    /**
+     * Remove the rasters created by getRaster() from the cache
+     */
+    void freeRasters();
+
 private:
     /**
      * Tex PDF Document, if rendered as PDF
      */
     PopplerDocument* pdf = nullptr;
 
+    /**
+     * First page of the PDF, and its size
+     */
+    PopplerPage* pdfPage = nullptr;
+    double pdfPageWidth = 0;
+    double pdfPageHeight = 0;
+
+    /**
+     * Locked while rendering the PDF page, see getRaster() and renderPdf(). The rendering threads and the main view may
+     * draw the same element at the same time.
+     */
+    mutable std::mutex rasterMutex;
+
     /**
      * Tex image, if rendered as image. Note: this is deprecated and subject to removal in a later version.
      */
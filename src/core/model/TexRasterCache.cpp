@@ -0,0 +1,28 @@
+#include "TexRasterCache.h"
+
+#include <climits>
+
+TexRasterCache::TexRasterCache() = default;
+
+TexRasterCache::~TexRasterCache() = default;
+
+auto TexRasterCache::getInstance() -> TexRasterCache& {
+    static TexRasterCache instance;
+    return instance;
+}
+
+auto TexRasterCache::get(const TexImage* image, int xBucket, int yBucket) -> cairo_surface_t* {
+    return this->rasters.get({image, xBucket, yBucket});
+}
+
+void TexRasterCache::insert(const TexImage* image, int xBucket, int yBucket, cairo_surface_t* raster) {
+    this->rasters.insert({image, xBucket, yBucket}, raster);
+}
+
+void TexRasterCache::remove(const TexImage* image) {
+    this->rasters.removeRange({image, INT_MIN, INT_MIN}, {image, INT_MAX, INT_MAX});
+}
+
+void TexRasterCache::clear() { this->rasters.clear(); }
+
+auto TexRasterCache::getMemoryUsage() const -> size_t { return this->rasters.getMemoryUsage(); }
@@ -0,0 +1,59 @@
+/*
+ * Xournal++
+ *
+ * Rasters of the TeX images, shared by all TexImage elements
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+
+#include <cairo.h>
+
+#include "util/RasterCache.h"
+
+class TexImage;
+
+/**
+ * Keeps the rasters which TexImage::getRaster() renders for the zoom buckets of the elements. The least recently used
+ * rasters are dropped when the budget shared with the other caches is exceeded, see RasterBudget.
+ */
+class TexRasterCache {
+private:
+    TexRasterCache();
+    ~TexRasterCache();
+
+public:
+    TexRasterCache(const TexRasterCache&) = delete;
+    void operator=(const TexRasterCache&) = delete;
+
+    static TexRasterCache& getInstance();
+
+    /**
+     * @return A new reference to the raster of `image` for the zoom bucket, nullptr if it is not cached
+     */
+    cairo_surface_t* get(const TexImage* image, int xBucket, int yBucket);
+
+    /**
+     * Adds the raster of `image` for the zoom bucket. Takes a new reference.
+     */
+    void insert(const TexImage* image, int xBucket, int yBucket, cairo_surface_t* raster);
+
+    /**
+     * Drops all rasters of `image`, has to be called before the image is freed or its data changes
+     */
+    void remove(const TexImage* image);
+
+    void clear();
+
+    size_t getMemoryUsage() const;
+
+private:
+    RasterCache<std::tuple<const TexImage*, int, int>> rasters;
+};
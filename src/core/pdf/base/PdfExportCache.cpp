@@ -0,0 +1,150 @@
+#include "PdfExportCache.h"
+
+#include <algorithm>
+#include <fstream>
+#include <system_error>
+#include <utility>
+
+#include <glib.h>
+
+#include "model/Layer.h"
+#include "model/XojPage.h"
+#include "util/PathUtil.h"
+#include "util/serializing/BinObjectEncoding.h"
+#include "util/serializing/ObjectOutputStream.h"
+
+namespace {
+constexpr auto CACHE_HEADER = "xournalpp-pdf-export 1";
+constexpr auto CACHE_EXTENSION = ".cache";
+
+/**
+ * Limits of the cache folder, an entry is rewritten on every export of its file
+ */
+constexpr size_t MAX_ENTRIES = 256;
+constexpr std::chrono::hours MAX_AGE{24 * 30};
+
+auto hashString(const std::string& data) -> std::string {
+    gchar* checksum = g_compute_checksum_for_data(G_CHECKSUM_SHA256, reinterpret_cast<const guchar*>(data.data()),
+                                                  data.length());
+    std::string result = checksum;
+    g_free(checksum);
+    return result;
+}
+}  // namespace
+
+PdfExportCache::PdfExportCache(fs::path file): file(std::move(file)) {}
+
+auto PdfExportCache::getCacheFile() const -> fs::path {
+    std::error_code ec;
+    fs::path absolute = fs::absolute(this->file, ec);
+    return Util::getCacheSubfolder("export") / (hashString((ec ? this->file : absolute).u8string()) + CACHE_EXTENSION);
+}
+
+auto PdfExportCache::getFileStamp() const -> std::string {
+    std::error_code ec;
+    auto size = fs::file_size(this->file, ec);
+    if (ec) {
+        return {};
+    }
+    auto time = fs::last_write_time(this->file, ec);
+    if (ec) {
+        return {};
+    }
+    return std::to_string(size) + " " + std::to_string(time.time_since_epoch().count());
+}
+
+auto PdfExportCache::load(const std::string& settings) -> bool {
+    this->pageHashes.clear();
+
+    std::string stamp = getFileStamp();
+    if (stamp.empty()) {
+        return false;
+    }
+
+    std::ifstream in(getCacheFile());
+    std::string line;
+    if (!std::getline(in, line) || line != CACHE_HEADER) {
+        return false;
+    }
+    if (!std::getline(in, line) || line != settings) {
+        return false;
+    }
+    if (!std::getline(in, line) || line != stamp) {
+        // The file was changed or replaced since the last export
+        return false;
+    }
+
+    while (std::getline(in, line)) { this->pageHashes.push_back(line); }
+    return !this->pageHashes.empty();
+}
+
+auto PdfExportCache::getPageHashes() const -> const std::vector<std::string>& { return this->pageHashes; }
+
+void PdfExportCache::store(const std::string& settings, std::vector<std::string> pageHashes) {
+    this->pageHashes = std::move(pageHashes);
+
+    std::string stamp = getFileStamp();
+    fs::path cacheFile = getCacheFile();
+    if (stamp.empty()) {
+        std::error_code ec;
+        fs::remove(cacheFile, ec);
+        return;
+    }
+
+    std::ofstream out(cacheFile, std::ios::trunc);
+    out << CACHE_HEADER << "\n" << settings << "\n" << stamp << "\n";
+    for (const std::string& hash: this->pageHashes) { out << hash << "\n"; }
+    out.close();
+    if (!out) {
+        g_warning("Could not write PDF export cache %s", cacheFile.u8string().c_str());
+    }
+
+    removeOldEntries(cacheFile.parent_path(), MAX_ENTRIES, MAX_AGE);
+}
+
+void PdfExportCache::removeOldEntries(const fs::path& folder, size_t maxEntries, std::chrono::hours maxAge) {
+    std::vector<std::pair<fs::file_time_type, fs::path>> entries;
+    std::error_code ec;
+    for (const auto& entry: fs::directory_iterator(folder, ec)) {
+        std::error_code timeEc;
+        auto time = fs::last_write_time(entry.path(), timeEc);
+        if (!timeEc && entry.path().extension() == CACHE_EXTENSION) {
+            entries.emplace_back(time, entry.path());
+        }
+    }
+
+    // Newest first
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    auto oldest = fs::file_time_type::clock::now() - maxAge;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (i >= maxEntries || entries[i].first < oldest) {
+            fs::remove(entries[i].second, ec);
+        }
+    }
+}
+
+auto PdfExportCache::hashPage(const PageRef& page) -> std::string {
+    ObjectOutputStream out(new BinObjectEncoding());
+
+    out.writeDouble(page->getWidth());
+    out.writeDouble(page->getHeight());
+
+    PageType type = page->getBackgroundType();
+    out.writeInt(static_cast<int>(type.format));
+    out.writeString(type.config);
+    out.writeInt(static_cast<int>(uint32_t(page->getBackgroundColor())));
+    out.writeSizeT(page->getPdfPageNr());
+    out.writeString(page->getBackgroundImage().getHash());
+    out.writeInt(page->isLayerVisible(0));
+
+    for (Layer* l: *page->getLayers()) {
+        out.writeInt(l->isVisible());
+        for (Element* e: l->getElements()) { e->serialize(out); }
+    }
+
+    GString* data = out.getStr();
+    std::string result = hashString(std::string(data->str, data->len));
+    g_string_free(data, true);
+    return result;
+}
@@ -0,0 +1,72 @@
+/*
+ * Xournal++
+ *
+ * Remembers the pages of the last PDF export to a file
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "model/PageRef.h"
+
+#include "filesystem.h"
+
+/**
+ * Stores a content hash of every page written by the last export to a file, in the cache folder. When the same file
+ * is exported again, only the pages whose hash changed need to be rendered, the other ones are taken from the
+ * previous output.
+ *
+ * The entry is only valid as long as the exported file was not modified by anything else, this is checked with its
+ * size and modification time. Entries of files which were not exported for a long time are removed, as well as the
+ * oldest ones if there are too many.
+ */
+class PdfExportCache {
+public:
+    explicit PdfExportCache(fs::path file);
+
+public:
+    /**
+     * Loads the entry of the last export
+     *
+     * @param settings Everything besides the pages which changes the output (see hashSettings())
+     * @return false if there is no valid entry for these settings
+     */
+    bool load(const std::string& settings);
+
+    /**
+     * @return The page hashes of the last export, in the order of the pages in the file
+     */
+    const std::vector<std::string>& getPageHashes() const;
+
+    /**
+     * Records a successful export, has to be called after the file was written
+     */
+    void store(const std::string& settings, std::vector<std::string> pageHashes);
+
+    /**
+     * @return A hash of all elements, the background and the size of the page
+     */
+    static std::string hashPage(const PageRef& page);
+
+    /**
+     * Removes the entries in `folder` which were stored before `maxAge`, and the oldest ones beyond `maxEntries`
+     */
+    static void removeOldEntries(const fs::path& folder, size_t maxEntries, std::chrono::hours maxAge);
+
+private:
+    fs::path getCacheFile() const;
+    std::string getFileStamp() const;
+
+private:
+    fs::path file;
+    std::vector<std::string> pageHashes;
+};
@@ -0,0 +1,48 @@
+#include "Qpdf.h"
+
+#include <gio/gio.h>
+
+#include "util/i18n.h"
+
+auto Qpdf::isAvailable() -> bool {
+    gchar* qpdf = g_find_program_in_path("qpdf");
+    g_free(qpdf);
+    return qpdf != nullptr;
+}
+
+auto Qpdf::run(const std::vector<std::string>& args, std::string& error) -> bool {
+    gchar* qpdf = g_find_program_in_path("qpdf");
+    if (qpdf == nullptr) {
+        error = _("qpdf is not installed");
+        return false;
+    }
+
+    std::vector<const gchar*> argv;
+    argv.push_back(qpdf);
+    for (const std::string& arg: args) { argv.push_back(arg.c_str()); }
+    argv.push_back(nullptr);
+
+    bool success = true;
+    GError* err = nullptr;
+    GSubprocess* proc = g_subprocess_newv(argv.data(), G_SUBPROCESS_FLAGS_STDOUT_SILENCE, &err);
+    if (proc == nullptr || !g_subprocess_wait(proc, nullptr, &err)) {
+        error = FS(_F("Could not run qpdf: {1}") % err->message);
+        g_error_free(err);
+        success = false;
+    } else if (int status = g_subprocess_get_exit_status(proc); status != 0 && status != 3) {
+        // Exit status 3 only reports warnings, the file is written anyway
+        error = FS(_F("qpdf failed with exit status {1}") % status);
+        success = false;
+    }
+
+    if (proc) {
+        g_object_unref(proc);
+    }
+    g_free(qpdf);
+    return success;
+}
+
+auto Qpdf::getMissingMessage() -> std::string {
+    return _("qpdf is not installed, so all pages of the PDF were rendered. Install qpdf to reuse the background PDF "
+             "and the unchanged pages of previous exports.");
+}
@@ -0,0 +1,41 @@
+/*
+ * Xournal++
+ *
+ * Runs the optional qpdf program
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * qpdf is an optional runtime dependency. It merges PDF files without rendering them again, which is used to reuse the
+ * background PDF and the pages of a previous export. Without it, PDFs are always exported by rendering every page.
+ */
+namespace Qpdf {
+
+/**
+ * @return true if qpdf is found in PATH
+ */
+bool isAvailable();
+
+/**
+ * Runs qpdf with `args` and waits until it is finished
+ *
+ * @param error Set if qpdf is not installed or failed
+ * @return true on success (warnings of qpdf are ignored)
+ */
+bool run(const std::vector<std::string>& args, std::string& error);
+
+/**
+ * @return The message shown to the user when an export is slower because qpdf is missing
+ */
+std::string getMissingMessage();
+
+}  // namespace Qpdf
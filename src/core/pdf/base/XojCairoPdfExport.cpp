@@ -1,8 +1,17 @@
 #include "XojCairoPdfExport.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
 #include <map>
+#include <numeric>
 #include <sstream>
 #include <stack>
+#include <string>
+#include <system_error>
+#include <vector>
 
 #include <cairo-pdf.h>
 #include <config.h>
@@ -12,8 +21,52 @@
 #include "util/serdesstream.h"
 #include "view/DocumentView.h"
 
+#include "PdfExportCache.h"
+#include "Qpdf.h"
 #include "filesystem.h"
 
+namespace {
+/**
+ * A temporary folder which belongs to a single export, so exports running at the same time do not overwrite each
+ * other's files. It is removed together with its contents.
+ */
+class ExportTmpDir {
+public:
+    ExportTmpDir() {
+        GError* error = nullptr;
+        gchar* dir = g_dir_make_tmp("xournalpp-export-XXXXXX", &error);
+        if (dir == nullptr) {
+            this->error = error->message;
+            g_error_free(error);
+            return;
+        }
+        this->path = fs::u8path(dir);
+        g_free(dir);
+    }
+
+    ~ExportTmpDir() {
+        if (!this->path.empty()) {
+            std::error_code ec;
+            fs::remove_all(this->path, ec);
+        }
+    }
+
+    ExportTmpDir(const ExportTmpDir&) = delete;
+    ExportTmpDir& operator=(const ExportTmpDir&) = delete;
+
+    /**
+     * Empty if the folder could not be created, see error
+     */
+    fs::path path;
+    std::string error;
+};
+
+/**
+ * Maximum difference between the size of a page and its PDF page, in points
+ */
+constexpr double PAGE_SIZE_EPSILON = 0.01;
+}  // namespace
+
 XojCairoPdfExport::XojCairoPdfExport(Document* doc, ProgressListener* progressListener):
         doc(doc), progressListener(progressListener) {}
 
@@ -30,6 +83,10 @@ void XojCairoPdfExport::setExportBackground(ExportBackgroundType exportBackgroun
     this->exportBackground = exportBackground;
 }
 
+void XojCairoPdfExport::setReuseBackgroundPdf(bool reuse) { this->reuseBackgroundPdf = reuse; }
+
+void XojCairoPdfExport::setIncremental(bool incremental) { this->incremental = incremental; }
+
 auto XojCairoPdfExport::startPdf(const fs::path& file) -> bool {
     this->surface = cairo_pdf_surface_create(file.u8string().c_str(), 0, 0);
     this->cr = cairo_create(surface);
@@ -109,6 +166,14 @@ void XojCairoPdfExport::exportPage(size_t page) {
     DocumentView view;
 
     cairo_save(this->cr);
+    if (this->overlayOnly) {
+        view.drawPage(p, this->cr, true /* dont render eraseable */, true, true, true);
+
+        cairo_show_page(this->cr);
+        cairo_restore(this->cr);
+        return;
+    }
+
     if (p->getBackgroundType().isPdfPage() && (exportBackground >= EXPORT_BACKGROUND_UNRULED)) {
         int pgNo = p->getPdfPageNr();
         XojPdfPageSPtr popplerPage = doc->getPdfPage(pgNo);
@@ -146,55 +211,207 @@ void XojCairoPdfExport::exportPageLayers(size_t page) {
     for (const auto& layer: *p->getLayers()) layer->setVisible(initialVisibility[layer]);
 }
 
-auto XojCairoPdfExport::createPdf(fs::path const& file, PageRangeVector& range, bool progressiveMode) -> bool {
-    if (range.empty()) {
-        this->lastError = _("No pages to export!");
+auto XojCairoPdfExport::canReuseBackgroundPdf(const std::vector<size_t>& pages, bool progressiveMode) -> bool {
+    if (progressiveMode || exportBackground == EXPORT_BACKGROUND_NONE || !doc->getPdfDocument().isLoaded()) {
         return false;
     }
 
-    if (!startPdf(file)) {
-        this->lastError = _("Failed to initialize PDF Cairo surface");
-        this->lastError += "\nCairo error: ";
-        this->lastError += cairo_status_to_string(cairo_surface_status(this->surface));
+    // qpdf scales and centers an underlay page of a different size, while the background is drawn unscaled at the
+    // top left corner of the page. So the pages are only reused if their size did not change.
+    return std::all_of(pages.begin(), pages.end(), [this](size_t i) {
+        PageRef p = doc->getPage(i);
+        if (!p->getBackgroundType().isPdfPage() || !p->isLayerVisible(0) || p->getPdfPageNr() == npos) {
+            return false;
+        }
+        XojPdfPageSPtr pdfPage = doc->getPdfPage(p->getPdfPageNr());
+        return pdfPage && std::abs(pdfPage->getWidth() - p->getWidth()) < PAGE_SIZE_EPSILON &&
+               std::abs(pdfPage->getHeight() - p->getHeight()) < PAGE_SIZE_EPSILON;
+    });
+}
+
+auto XojCairoPdfExport::exportOverlay(fs::path const& file, const std::vector<size_t>& pages) -> bool {
+    ExportTmpDir tmpDir;
+    if (tmpDir.path.empty()) {
+        this->lastError = FS(_F("Could not create a temporary folder: {1}") % tmpDir.error);
         return false;
     }
+    fs::path overlay = tmpDir.path / "overlay.pdf";
+
+    this->overlayOnly = true;
+    bool success = renderPages(overlay, pages, false);
+    this->overlayOnly = false;
+
+    // The background PDF is only written if it is not available as file, e.g. if it is attached to the document
+    std::error_code ec;
+    fs::path background = doc->getPdfFilepath();
+    if (success && (background.empty() || !fs::is_regular_file(background, ec))) {
+        background = tmpDir.path / "background.pdf";
+
+        GError* error = nullptr;
+        if (!doc->getPdfDocument().save(background, &error)) {
+            this->lastError = FS(_F("Could not write the background PDF: {1}") % error->message);
+            g_error_free(error);
+            success = false;
+        }
+    }
+
+    if (success) {
+        // The overlay is the primary file, so the outline and metadata written by cairo are kept
+        auto from = serdes_stream<std::ostringstream>();
+        from << "--from=";
+        for (size_t i = 0; i < pages.size(); i++) {
+            from << (i ? "," : "") << doc->getPage(pages[i])->getPdfPageNr() + 1;
+        }
+        success = Qpdf::run({overlay.u8string(), "--underlay", background.u8string(), from.str(), "--", file.u8string()},
+                            this->lastError);
+    }
 
-    int count = 0;
-    for (PageRangeEntry* e: range) { count += e->getLast() - e->getFirst() + 1; }
+    return success;
+}
 
-    if (this->progressListener) {
-        this->progressListener->setMaximumState(count);
+auto XojCairoPdfExport::getExportSettings(const std::vector<size_t>& pages) -> std::string {
+    auto settings = serdes_stream<std::ostringstream>();
+    settings << this->exportBackground << " " << pages.size();
+
+    // The outline refers to pages of the document, it changes if any PDF page is moved
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        settings << " " << static_cast<int64_t>(doc->getPage(i)->getPdfPageNr());
     }
 
-    int c = 0;
-    for (PageRangeEntry* e: range) {
-        for (int i = e->getFirst(); i <= e->getLast(); i++) {
-            if (i < 0 || i >= static_cast<int>(doc->getPageCount())) {
-                continue;
+    // The background PDF may be replaced by a different file with the same name
+    std::error_code ec;
+    fs::path pdf = doc->getPdfFilepath();
+    if (!pdf.empty() && fs::exists(pdf, ec)) {
+        settings << " " << fs::file_size(pdf, ec) << " " << fs::last_write_time(pdf, ec).time_since_epoch().count();
+    }
+    return settings.str();
+}
+
+auto XojCairoPdfExport::exportIncremental(fs::path const& file, const std::vector<size_t>& pages) -> bool {
+    PdfExportCache cache(file);
+    std::string settings = getExportSettings(pages);
+
+    std::vector<std::string> hashes;
+    hashes.reserve(pages.size());
+    for (size_t page: pages) { hashes.push_back(PdfExportCache::hashPage(doc->getPage(page))); }
+
+    bool exported = false;
+    bool success = false;
+    if (cache.load(settings) && cache.getPageHashes().size() == pages.size()) {
+        const std::vector<std::string>& previous = cache.getPageHashes();
+
+        std::vector<size_t> changed;
+        for (size_t i = 0; i < pages.size(); i++) {
+            if (hashes[i] != previous[i]) {
+                changed.push_back(i);
             }
+        }
 
-            if (progressiveMode) {
-                exportPageLayers(i);
-            } else {
-                exportPage(i);
+        if (changed.empty()) {
+            // The file is still up to date
+            exported = true;
+            success = true;
+        } else if (changed.size() < pages.size() && !Qpdf::isAvailable()) {
+            missingQpdf();
+        } else if (changed.size() < pages.size()) {
+            exported = true;
+            success = mergeChangedPages(file, pages, changed);
+            if (!success) {
+                g_warning("Could not update the exported PDF, exporting all pages: %s", this->lastError.c_str());
+                this->lastError.clear();
+                exported = false;
             }
+        }
+    }
+
+    if (!exported) {
+        success = renderPages(file, pages, false);
+    }
+
+    if (success) {
+        cache.store(settings, std::move(hashes));
+    }
+    return success;
+}
+
+auto XojCairoPdfExport::mergeChangedPages(fs::path const& file, const std::vector<size_t>& pages,
+                                          const std::vector<size_t>& changed) -> bool {
+    ExportTmpDir tmpDir;
+    if (tmpDir.path.empty()) {
+        this->lastError = FS(_F("Could not create a temporary folder: {1}") % tmpDir.error);
+        return false;
+    }
+    fs::path previous = tmpDir.path / "previous.pdf";
+    fs::path rendered = tmpDir.path / "changed.pdf";
+
+    std::error_code ec;
+    fs::copy_file(file, previous, fs::copy_options::overwrite_existing, ec);
+    if (ec) {
+        this->lastError = FS(_F("Could not copy the previous export: {1}") % ec.message());
+        return false;
+    }
 
-            if (this->progressListener) {
-                this->progressListener->setCurrentState(c++);
+    std::vector<size_t> changedPages;
+    changedPages.reserve(changed.size());
+    for (size_t i: changed) { changedPages.push_back(pages[i]); }
+
+    bool success = renderPages(rendered, changedPages, false);
+
+    if (success) {
+        // The previous export is the primary file, so its outline and metadata are kept. The pages are taken in runs
+        // from either file: the unchanged ones from the previous export, the changed ones from the new rendering.
+        std::vector<std::string> args = {previous.u8string(), "--pages"};
+        size_t nextChanged = 0;
+        for (size_t i = 0; i < pages.size();) {
+            bool isChanged = nextChanged < changed.size() && changed[nextChanged] == i;
+            size_t first = isChanged ? nextChanged : i;
+            size_t count = 0;
+            while (i < pages.size() && (nextChanged < changed.size() && changed[nextChanged] == i) == isChanged) {
+                if (isChanged) {
+                    nextChanged++;
+                }
+                i++;
+                count++;
             }
+            args.push_back(isChanged ? rendered.u8string() : previous.u8string());
+            args.push_back(std::to_string(first + 1) + "-" + std::to_string(first + count));
         }
+        args.emplace_back("--");
+        args.push_back(file.u8string());
+
+        success = Qpdf::run(args, this->lastError);
     }
 
-    endPdf();
-    return true;
+    return success;
 }
 
-auto XojCairoPdfExport::createPdf(fs::path const& file, bool progressiveMode) -> bool {
-    if (doc->getPageCount() < 1) {
-        lastError = _("No pages to export!");
+auto XojCairoPdfExport::exportPages(fs::path const& file, const std::vector<size_t>& pages, bool progressiveMode)
+        -> bool {
+    if (pages.empty()) {
+        this->lastError = _("No pages to export!");
         return false;
     }
 
+    if (this->reuseBackgroundPdf && canReuseBackgroundPdf(pages, progressiveMode)) {
+        if (!Qpdf::isAvailable()) {
+            missingQpdf();
+        } else if (exportOverlay(file, pages)) {
+            return true;
+        } else {
+            g_warning("Could not reuse the background PDF, rendering it instead: %s", this->lastError.c_str());
+            this->lastError.clear();
+        }
+    }
+
+    if (this->incremental && !progressiveMode) {
+        return exportIncremental(file, pages);
+    }
+
+    return renderPages(file, pages, progressiveMode);
+}
+
+auto XojCairoPdfExport::renderPages(fs::path const& file, const std::vector<size_t>& pages, bool progressiveMode)
+        -> bool {
     if (!startPdf(file)) {
         this->lastError = _("Failed to initialize PDF Cairo surface");
         this->lastError += "\nCairo error: ";
@@ -202,21 +419,41 @@ auto XojCairoPdfExport::createPdf(fs::path const& file, bool progressiveMode) ->
         return false;
     }
 
-    int count = doc->getPageCount();
     if (this->progressListener) {
-        this->progressListener->setMaximumState(count);
+        this->progressListener->setMaximumState(static_cast<int>(pages.size()));
     }
 
-    for (int i = 0; i < count; i++) {
-
+    auto start = std::chrono::steady_clock::now();
+    int done = 0;
+    for (size_t page: pages) {
         if (progressiveMode) {
-            exportPageLayers(i);
+            exportPageLayers(page);
         } else {
-            exportPage(i);
+            exportPage(page);
         }
 
+        // Cairo writes every finished page directly to the file, stop at the first write error (e.g. a full disk)
+        cairo_surface_flush(this->surface);
+        if (cairo_surface_status(this->surface) != CAIRO_STATUS_SUCCESS) {
+            this->lastError = _("Failed to write the PDF file");
+            this->lastError += "\nCairo error: ";
+            this->lastError += cairo_status_to_string(cairo_surface_status(this->surface));
+            endPdf();
+            return false;
+        }
+
+        done++;
         if (this->progressListener) {
-            this->progressListener->setCurrentState(i);
+            this->progressListener->setCurrentState(done);
+
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            auto text = serdes_stream<std::ostringstream>();
+            text << done << " / " << pages.size();
+            if (elapsed.count() > 0) {
+                text << " (" << std::fixed << std::setprecision(1) << done / elapsed.count() << " " << _("pages/s")
+                     << ")";
+            }
+            this->progressListener->setStatusText(text.str());
         }
     }
 
@@ -224,4 +461,31 @@ auto XojCairoPdfExport::createPdf(fs::path const& file, bool progressiveMode) ->
     return true;
 }
 
+auto XojCairoPdfExport::createPdf(fs::path const& file, PageRangeVector& range, bool progressiveMode) -> bool {
+    std::vector<size_t> pages;
+    for (PageRangeEntry* e: range) {
+        for (int i = e->getFirst(); i <= e->getLast(); i++) {
+            if (i >= 0 && i < static_cast<int>(doc->getPageCount())) {
+                pages.push_back(static_cast<size_t>(i));
+            }
+        }
+    }
+
+    return exportPages(file, pages, progressiveMode);
+}
+
+auto XojCairoPdfExport::createPdf(fs::path const& file, bool progressiveMode) -> bool {
+    std::vector<size_t> pages(doc->getPageCount());
+    std::iota(pages.begin(), pages.end(), 0);
+
+    return exportPages(file, pages, progressiveMode);
+}
+
+void XojCairoPdfExport::missingQpdf() {
+    this->lastWarning = Qpdf::getMissingMessage();
+    g_warning("%s", this->lastWarning.c_str());
+}
+
 auto XojCairoPdfExport::getLastError() -> std::string { return lastError; }
+
+auto XojCairoPdfExport::getLastWarning() -> std::string { return lastWarning; }
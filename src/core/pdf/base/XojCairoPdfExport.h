@@ -11,6 +11,9 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "control/jobs/BaseExportJob.h"
 #include "control/jobs/ProgressListener.h"
 #include "model/Document.h"
@@ -27,12 +30,28 @@ public:
     virtual bool createPdf(fs::path const& file, bool progressiveMode);
     virtual bool createPdf(fs::path const& file, PageRangeVector& range, bool progressiveMode);
     virtual std::string getLastError();
+    std::string getLastWarning() override;
 
     /**
      * Export without background
      */
     virtual void setExportBackground(ExportBackgroundType exportBackground);
 
+    /**
+     * Place the pages of the background PDF unchanged below the annotations. Only the annotations are rendered and
+     * merged with the background pages by qpdf, which copies their content streams and resources as they are. Falls
+     * back to rendering the background if qpdf is not available (see getLastWarning()), or not all pages have a PDF
+     * background of their size.
+     */
+    void setReuseBackgroundPdf(bool reuse) override;
+
+    /**
+     * Only render the pages which changed since the last export to the same file (see PdfExportCache), the other
+     * pages are copied from the previous file with qpdf. Falls back to a full export if that is not possible, e.g. if
+     * qpdf is not available (see getLastWarning()).
+     */
+    void setIncremental(bool incremental) override;
+
 private:
     bool startPdf(const fs::path& file);
 #if CAIRO_VERSION >= CAIRO_VERSION_ENCODE(1, 16, 0)
@@ -47,6 +66,42 @@ private:
     void populatePdfOutline(GtkTreeModel* tocModel);
 #endif
     void endPdf();
+
+    /**
+     * Exports the pages one after another. Every page is written to the file as soon as it is complete, and its
+     * resources (e.g. decoded images) are released afterwards, so the memory used does not grow with the number of
+     * pages.
+     */
+    bool exportPages(fs::path const& file, const std::vector<size_t>& pages, bool progressiveMode);
+    bool renderPages(fs::path const& file, const std::vector<size_t>& pages, bool progressiveMode);
+
+    /**
+     * @return true if all pages have a visible PDF background with the size of the page, which can be reused as it is
+     */
+    bool canReuseBackgroundPdf(const std::vector<size_t>& pages, bool progressiveMode);
+
+    /**
+     * Renders only the annotations and places the background PDF pages below them
+     */
+    bool exportOverlay(fs::path const& file, const std::vector<size_t>& pages);
+
+    /**
+     * @return Everything besides the page contents which changes the exported file
+     */
+    std::string getExportSettings(const std::vector<size_t>& pages);
+
+    bool exportIncremental(fs::path const& file, const std::vector<size_t>& pages);
+
+    /**
+     * Replaces the pages at the indices `changed` of the previous export with newly rendered ones
+     */
+    bool mergeChangedPages(fs::path const& file, const std::vector<size_t>& pages, const std::vector<size_t>& changed);
+
+    /**
+     * Sets the warning that the export was slower because qpdf is not installed
+     */
+    void missingQpdf();
+
     void exportPage(size_t page);
     /**
      * Export as a PDF document where each additional layer creates a
@@ -62,5 +117,14 @@ private:
 
     ExportBackgroundType exportBackground = EXPORT_BACKGROUND_ALL;
 
+    bool reuseBackgroundPdf = false;
+    bool incremental = false;
+
+    /**
+     * Only render the annotations, while exporting with reuseBackgroundPdf
+     */
+    bool overlayOnly = false;
+
     std::string lastError;
+    std::string lastWarning;
 };
@@ -4,9 +4,19 @@ XojPdfExport::XojPdfExport() = default;
 
 XojPdfExport::~XojPdfExport() = default;
 
+auto XojPdfExport::getLastWarning() -> std::string { return std::string(); }
+
 /**
  * Export without background
  */
 void XojPdfExport::setExportBackground(ExportBackgroundType exportBackground) {
     // Does nothing in the base class
 }
+
+void XojPdfExport::setReuseBackgroundPdf(bool reuse) {
+    // Does nothing in the base class
+}
+
+void XojPdfExport::setIncremental(bool incremental) {
+    // Does nothing in the base class
+}
@@ -29,10 +29,25 @@ public:
     virtual bool createPdf(fs::path const& file, PageRangeVector& range, bool progressiveMode) = 0;
     virtual std::string getLastError() = 0;
 
+    /**
+     * @return A message for the user about a successful export, e.g. if it took a slower path, empty if there is none
+     */
+    virtual std::string getLastWarning();
+
     /**
      * Export without background
      */
     virtual void setExportBackground(ExportBackgroundType exportBackground);
 
+    /**
+     * Place the pages of the background PDF unchanged below the annotations, instead of rendering them again
+     */
+    virtual void setReuseBackgroundPdf(bool reuse);
+
+    /**
+     * Only render the pages which changed since the last export to the same file
+     */
+    virtual void setIncremental(bool incremental);
+
 private:
 };
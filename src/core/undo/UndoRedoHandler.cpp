@@ -4,6 +4,8 @@
 #include <cinttypes>
 
 #include "control/Control.h"
+#include "model/Layer.h"
+#include "model/XojPage.h"
 #include "util/XojMsgBox.h"
 #include "util/i18n.h"
 
@@ -102,6 +104,7 @@ void UndoRedoHandler::undo() {
     Document* doc = control->getDocument();
     doc->lock();
     bool undoResult = undoAction.undo(this->control);
+    markLayersChanged(undoAction.getPages());
     doc->unlock();
 
     if (!undoResult) {
@@ -131,6 +134,7 @@ void UndoRedoHandler::redo() {
     Document* doc = control->getDocument();
     doc->lock();
     bool redoResult = redoAction.redo(this->control);
+    markLayersChanged(redoAction.getPages());
     doc->unlock();
 
     if (!redoResult) {
@@ -215,6 +219,16 @@ auto UndoRedoHandler::redoDescription() -> string {
     return _("Redo");
 }
 
+void UndoRedoHandler::markLayersChanged(const std::vector<PageRef>& pages) {
+    // Undo actions modify elements in place, also on layers which are not selected
+    for (const PageRef& page: pages) {
+        if (!page) {
+            continue;
+        }
+        for (Layer* l: *page->getLayers()) { l->markChanged(); }
+    }
+}
+
 void UndoRedoHandler::fireUpdateUndoRedoButtons(const std::vector<PageRef>& pages) {
     for (auto&& undoRedoListener: this->listener) { undoRedoListener->undoRedoChanged(); }
 
@@ -62,6 +62,11 @@ private:
     void clearRedo();
     void printContents();
 
+    /**
+     * Invalidates cached renderings of all layers of the pages an undo or redo touched
+     */
+    static void markLayersChanged(const std::vector<PageRef>& pages);
+
 private:
     std::deque<UndoActionPtr> undoList;
     std::deque<UndoActionPtr> redoList;
@@ -1,5 +1,7 @@
 #include "DocumentView.h"
 
+#include <cmath>
+
 #include "control/tools/EditSelection.h"
 #include "control/tools/Selection.h"
 #include "model/Layer.h"
@@ -22,6 +24,12 @@ DocumentView::~DocumentView() {
  */
 void DocumentView::setMarkAudioStroke(bool markAudioStroke) { this->markAudioStroke = markAudioStroke; }
 
+auto DocumentView::isMarkAudioStroke() const -> bool { return this->markAudioStroke; }
+
+void DocumentView::setSkipUndecodedImages(bool skip) { this->skipUndecodedImages = skip; }
+
+auto DocumentView::hasSkippedImages() const -> bool { return this->skippedImages; }
+
 void DocumentView::applyColor(cairo_t* cr, Stroke* s) {
     if (s->getToolType() == STROKE_TOOL_HIGHLIGHTER) {
         if (s->getFill() != -1) {
@@ -75,7 +83,26 @@ void DocumentView::drawImage(cairo_t* cr, Image* i) const {
     cairo_matrix_t defaultMatrix = {0};
     cairo_get_matrix(cr, &defaultMatrix);
 
-    cairo_surface_t* img = i->getImage();
+    cairo_surface_t* img = nullptr;
+    if (cairo_surface_get_type(cairo_get_group_target(cr)) == CAIRO_SURFACE_TYPE_IMAGE) {
+        // Only decode the resolution which is actually visible
+        double deviceWidth = i->getElementWidth();
+        double deviceHeight = i->getElementHeight();
+        cairo_user_to_device_distance(cr, &deviceWidth, &deviceHeight);
+
+        img = i->getImage(static_cast<int>(std::ceil(std::abs(deviceWidth))),
+                          static_cast<int>(std::ceil(std::abs(deviceHeight))), !this->skipUndecodedImages);
+        if (img == nullptr && this->skipUndecodedImages) {
+            this->skippedImages = true;
+        }
+    } else {
+        // Vector output (export, printing) keeps the full resolution, and it should not fill the cache
+        img = i->decodeImage();
+    }
+    if (img == nullptr) {
+        return;
+    }
+
     int width = cairo_image_surface_get_width(img);
     int height = cairo_image_surface_get_height(img);
 
@@ -95,6 +122,7 @@ void DocumentView::drawImage(cairo_t* cr, Image* i) const {
     }
 
     cairo_set_matrix(cr, &defaultMatrix);
+    cairo_surface_destroy(img);
 }
 
 void DocumentView::drawTexImage(cairo_t* cr, TexImage* texImage) const {
@@ -105,13 +133,40 @@ void DocumentView::drawTexImage(cairo_t* cr, TexImage* texImage) const {
     cairo_surface_t* img = texImage->getImage();
 
     if (pdf != nullptr) {
-        if (poppler_document_get_n_pages(pdf) < 1) {
+        PopplerPage* page = texImage->getPdfPage();
+        if (page == nullptr) {
             g_warning("Got latex PDf without pages!: %s", texImage->getText().c_str());
             return;
         }
 
-        PopplerPage* page = poppler_document_get_page(pdf, 0);
+        if (cairo_surface_get_type(cairo_get_group_target(cr)) == CAIRO_SURFACE_TYPE_IMAGE) {
+            // On screen, paint the raster of the current zoom instead of interpreting the PDF on every redraw
+            double deviceWidth = texImage->getElementWidth();
+            double deviceHeight = texImage->getElementHeight();
+            cairo_user_to_device_distance(cr, &deviceWidth, &deviceHeight);
+
+            if (cairo_surface_t* raster = texImage->getRaster(std::abs(deviceWidth), std::abs(deviceHeight))) {
+                double xFactor = texImage->getElementWidth() / cairo_image_surface_get_width(raster);
+                double yFactor = texImage->getElementHeight() / cairo_image_surface_get_height(raster);
+
+                cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+                cairo_translate(cr, texImage->getX(), texImage->getY());
+                cairo_scale(cr, xFactor, yFactor);
+                cairo_set_source_surface(cr, raster, 0, 0);
+                // Make TeX images translucent when highlighting audio strokes as they can not have audio
+                if (this->markAudioStroke) {
+                    cairo_paint_with_alpha(cr, AudioElement::OPACITY_NO_AUDIO);
+                } else {
+                    cairo_paint(cr);
+                }
+
+                cairo_surface_destroy(raster);
+                cairo_set_matrix(cr, &defaultMatrix);
+                return;
+            }
+        }
 
+        // Vector output (export, printing) and extreme zoom levels render the PDF itself
         double pageWidth = 0;
         double pageHeight = 0;
         poppler_page_get_size(page, &pageWidth, &pageHeight);
@@ -129,16 +184,14 @@ void DocumentView::drawTexImage(cairo_t* cr, TexImage* texImage) const {
              * This sets the current pattern to the temporary surface.
              */
             cairo_push_group(cr);
-            poppler_page_render(page, cr);
+            texImage->renderPdf(cr);
             cairo_pop_group_to_source(cr);
 
             // paint the temporary surface with opacity level
             cairo_paint_with_alpha(cr, AudioElement::OPACITY_NO_AUDIO);
         } else {
-            poppler_page_render(page, cr);
+            texImage->renderPdf(cr);
         }
-
-        g_clear_object(&page);
     } else if (img != nullptr) {
         int width = cairo_image_surface_get_width(img);
         int height = cairo_image_surface_get_height(img);
@@ -222,20 +275,20 @@ void DocumentView::drawLayer(cairo_t* cr, Layer* l) {
 }
 
 void DocumentView::paintBackgroundImage() {
-    GdkPixbuf* pixbuff = page->getBackgroundImage().getPixbuf();
-    if (pixbuff) {
+    cairo_surface_t* image = page->getBackgroundImage().getSurface();
+    if (image) {
         cairo_matrix_t matrix = {0};
         cairo_get_matrix(cr, &matrix);
 
-        int width = gdk_pixbuf_get_width(pixbuff);
-        int height = gdk_pixbuf_get_height(pixbuff);
+        int width = cairo_image_surface_get_width(image);
+        int height = cairo_image_surface_get_height(image);
 
         double sx = page->getWidth() / width;
         double sy = page->getHeight() / height;
 
         cairo_scale(cr, sx, sy);
 
-        gdk_cairo_set_source_pixbuf(cr, pixbuff, 0, 0);
+        cairo_set_source_surface(cr, image, 0, 0);
         cairo_paint(cr);
 
         cairo_set_matrix(cr, &matrix);
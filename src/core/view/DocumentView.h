@@ -62,6 +62,17 @@ public:
      * Mark stroke with Audio
      */
     void setMarkAudioStroke(bool markAudioStroke);
+    bool isMarkAudioStroke() const;
+
+    /**
+     * Images which are not decoded yet are skipped instead of decoding them, for drawing on the UI thread
+     */
+    void setSkipUndecodedImages(bool skip);
+
+    /**
+     * @return true if an image was skipped since the DocumentView was created
+     */
+    bool hasSkippedImages() const;
 
     // API for special drawing, usually you won't call this methods
 public:
@@ -112,6 +123,8 @@ private:
     double height = 0;
     bool dontRenderEditingStroke = false;
     bool markAudioStroke = false;
+    bool skipUndecodedImages = false;
+    mutable bool skippedImages = false;
 
     double lX = -1;
     double lY = -1;
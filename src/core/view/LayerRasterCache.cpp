@@ -0,0 +1,174 @@
+#include "LayerRasterCache.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+
+#include "DocumentView.h"
+
+LayerRasterCache::Raster::Raster(LayerRasterCache* owner, int slot): owner(owner), slot(slot) {}
+
+void LayerRasterCache::Raster::reset() {
+    this->owner->rasters.remove(this->slot);
+    this->revisions.clear();
+}
+
+LayerRasterCache::LayerRasterCache(): below(this, 0), above(this, 1) {}
+
+LayerRasterCache::~LayerRasterCache() { clear(); }
+
+void LayerRasterCache::clear() {
+    std::lock_guard lock(this->mutex);
+    this->below.reset();
+    this->above.reset();
+}
+
+auto LayerRasterCache::getRevisions(const std::vector<Layer*>& layers) -> std::vector<std::pair<size_t, size_t>> {
+    std::vector<std::pair<size_t, size_t>> revisions;
+    revisions.reserve(layers.size());
+    for (Layer* l: layers) { revisions.emplace_back(l->getId(), l->getRevision()); }
+    return revisions;
+}
+
+auto LayerRasterCache::isWorthCaching(const std::vector<Layer*>& layers) -> bool {
+    return std::any_of(layers.begin(), layers.end(), [](Layer* l) { return l->isVisible() && l->isAnnotated(); });
+}
+
+auto LayerRasterCache::canBeComposited(const std::vector<Layer*>& layers) -> bool {
+    for (Layer* l: layers) {
+        if (!l->isVisible()) {
+            continue;
+        }
+        for (Element* e: l->getElements()) {
+            if (e->getType() == ELEMENT_STROKE &&
+                dynamic_cast<Stroke*>(e)->getToolType() == STROKE_TOOL_HIGHLIGHTER) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void LayerRasterCache::paintLayers(cairo_t* cr, const PageRef& page, DocumentView& view,
+                                   const std::function<void(cairo_t*)>& paintPdf, bool withBackground,
+                                   const std::vector<Layer*>& layers, const Rectangle<double>* area) {
+    bool backgroundVisible = page->isLayerVisible(0);
+    if (withBackground && backgroundVisible && page->getBackgroundType().isPdfPage()) {
+        paintPdf(cr);
+    }
+
+    if (area) {
+        view.limitArea(area->x, area->y, area->width, area->height);
+    }
+    view.initDrawing(page, cr, false);
+
+    if (withBackground) {
+        if (backgroundVisible) {
+            view.drawBackground();
+        } else {
+            view.drawTransparentBackgroundPattern();
+        }
+    }
+
+    for (Layer* l: layers) {
+        if (l->isVisible()) {
+            view.drawLayer(cr, l);
+        }
+    }
+
+    view.finializeDrawing();
+}
+
+auto LayerRasterCache::update(Raster& raster, const PageRef& page, double zoom, DocumentView& view,
+                              const std::function<void(cairo_t*)>& paintPdf, bool withBackground,
+                              const std::vector<Layer*>& layers) -> cairo_surface_t* {
+    auto width = static_cast<int>(std::ceil(page->getWidth() * zoom));
+    auto height = static_cast<int>(std::ceil(page->getHeight() * zoom));
+    bool backgroundVisible = withBackground && page->isLayerVisible(0);
+    auto revisions = getRevisions(layers);
+
+    // The surface may have been dropped for other rasters meanwhile
+    cairo_surface_t* surface = raster.owner->rasters.get(raster.slot);
+    if (surface && raster.zoom == zoom && raster.backgroundVisible == backgroundVisible &&
+        raster.markAudioStroke == view.isMarkAudioStroke() && raster.revisions == revisions &&
+        cairo_image_surface_get_width(surface) == width && cairo_image_surface_get_height(surface) == height) {
+        return surface;
+    }
+    cairo_surface_destroy(surface);
+
+    raster.reset();
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+
+    cairo_t* cr = cairo_create(surface);
+    cairo_scale(cr, zoom, zoom);
+    paintLayers(cr, page, view, paintPdf, withBackground, layers, nullptr);
+    cairo_destroy(cr);
+    cairo_surface_flush(surface);
+
+    raster.zoom = zoom;
+    raster.backgroundVisible = backgroundVisible;
+    raster.markAudioStroke = view.isMarkAudioStroke();
+    raster.revisions = std::move(revisions);
+
+    raster.owner->rasters.insert(raster.slot, surface);
+    return surface;
+}
+
+void LayerRasterCache::blit(cairo_t* cr, cairo_surface_t* surface) {
+    cairo_save(cr);
+
+    // The raster has the resolution of the target, so paint it without any scaling at the page origin
+    cairo_matrix_t matrix;
+    cairo_get_matrix(cr, &matrix);
+    cairo_identity_matrix(cr);
+
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+    cairo_set_source_surface(cr, surface, std::round(matrix.x0), std::round(matrix.y0));
+    cairo_paint(cr);
+
+    cairo_restore(cr);
+}
+
+void LayerRasterCache::paint(cairo_t* cr, const PageRef& page, double zoom, DocumentView& view,
+                             const std::function<void(cairo_t*)>& paintPdf, const Rectangle<double>* area) {
+    std::lock_guard lock(this->mutex);
+
+    const std::vector<Layer*>& layers = *page->getLayers();
+
+    // Layer ID 0 is the background, if it is selected nothing can be edited and all layers count as below
+    int selected = page->getSelectedLayerId();
+    size_t split = selected > 0 ? std::min(static_cast<size_t>(selected - 1), layers.size()) : layers.size();
+
+    std::vector<Layer*> belowLayers(layers.begin(), layers.begin() + static_cast<std::ptrdiff_t>(split));
+    Layer* active = split < layers.size() ? layers[split] : nullptr;
+    std::vector<Layer*> aboveLayers;
+    if (active) {
+        aboveLayers.assign(layers.begin() + static_cast<std::ptrdiff_t>(split) + 1, layers.end());
+    }
+
+    if (isWorthCaching(belowLayers)) {
+        cairo_surface_t* surface = update(this->below, page, zoom, view, paintPdf, true, belowLayers);
+        blit(cr, surface);
+        cairo_surface_destroy(surface);
+    } else {
+        // The background alone is cached by the background painters and the PDF cache
+        this->below.reset();
+        paintLayers(cr, page, view, paintPdf, true, belowLayers, area);
+    }
+
+    if (active) {
+        paintLayers(cr, page, view, paintPdf, false, {active}, area);
+    }
+
+    if (isWorthCaching(aboveLayers) && canBeComposited(aboveLayers)) {
+        cairo_surface_t* surface = update(this->above, page, zoom, view, paintPdf, false, aboveLayers);
+        blit(cr, surface);
+        cairo_surface_destroy(surface);
+    } else {
+        this->above.reset();
+        paintLayers(cr, page, view, paintPdf, false, aboveLayers, area);
+    }
+}
@@ -0,0 +1,142 @@
+/*
+ * Xournal++
+ *
+ * Caches the layers of a page which are not edited
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <cairo.h>
+
+#include "model/PageRef.h"
+#include "util/RasterCache.h"
+#include "util/Rectangle.h"
+
+class DocumentView;
+class Layer;
+
+/**
+ * Only the selected layer of a page is edited with the tools. The layers below it (including the background and PDF)
+ * and the layers above it are kept as rasters at the current zoom, so a change on the selected layer only rerenders
+ * the selected layer and blits the rest.
+ *
+ * A raster is rendered again as soon as the revision (see Layer::getRevision()) of one of its layers changes, the
+ * selected layer changes, the zoom changes or the strokes with audio are marked or unmarked.
+ *
+ * The least recently used rasters are dropped when the budget shared by all pages and the other caches is exceeded,
+ * see RasterBudget.
+ */
+class LayerRasterCache {
+public:
+    LayerRasterCache();
+    ~LayerRasterCache();
+
+    LayerRasterCache(const LayerRasterCache& other) = delete;
+    LayerRasterCache& operator=(const LayerRasterCache& other) = delete;
+
+public:
+    /**
+     * Paints the page to `cr`, which has to be scaled by `zoom`, with the page origin on a device pixel.
+     * The document has to be locked.
+     *
+     * @param view Used to draw the selected layer and to render the rasters
+     * @param paintPdf Paints the PDF background, only called if the background is a visible PDF page
+     * @param area Only this part of the page (in page coordinates) needs to be painted, nullptr for the whole page
+     */
+    void paint(cairo_t* cr, const PageRef& page, double zoom, DocumentView& view,
+               const std::function<void(cairo_t*)>& paintPdf, const Rectangle<double>* area);
+
+    /**
+     * Drops the rasters, e.g. if the page is not visible anymore or its background changed
+     */
+    void clear();
+
+private:
+    /**
+     * The state of the layers a raster was rendered from
+     */
+    struct Raster {
+        Raster(LayerRasterCache* owner, int slot);
+
+        LayerRasterCache* owner;
+
+        /**
+         * The key of the surface in `rasters` of the owner
+         */
+        int slot;
+
+        double zoom = 0;
+        bool backgroundVisible = false;
+
+        /**
+         * See DocumentView::setMarkAudioStroke()
+         */
+        bool markAudioStroke = false;
+
+        /**
+         * ID and revision of each layer
+         */
+        std::vector<std::pair<size_t, size_t>> revisions;
+
+        void reset();
+    };
+
+    static std::vector<std::pair<size_t, size_t>> getRevisions(const std::vector<Layer*>& layers);
+
+    /**
+     * @return true if the layers contain something which is worth caching
+     */
+    static bool isWorthCaching(const std::vector<Layer*>& layers);
+
+    /**
+     * Highlighter strokes multiply with what is below them, so they cannot be composited from a separate raster
+     */
+    static bool canBeComposited(const std::vector<Layer*>& layers);
+
+    /**
+     * Paints the background (ruling, image or PDF) and `layers`
+     */
+    static void paintLayers(cairo_t* cr, const PageRef& page, DocumentView& view,
+                            const std::function<void(cairo_t*)>& paintPdf, bool withBackground,
+                            const std::vector<Layer*>& layers, const Rectangle<double>* area);
+
+    /**
+     * Renders `raster` again if it is out of date or was dropped
+     *
+     * @return A new reference to the surface of `raster`
+     */
+    static cairo_surface_t* update(Raster& raster, const PageRef& page, double zoom, DocumentView& view,
+                                   const std::function<void(cairo_t*)>& paintPdf, bool withBackground,
+                                   const std::vector<Layer*>& layers);
+
+    static void blit(cairo_t* cr, cairo_surface_t* surface);
+
+private:
+    std::mutex mutex;
+
+    /**
+     * Background, PDF and all layers below the selected layer
+     */
+    Raster below;
+
+    /**
+     * All layers above the selected layer
+     */
+    Raster above;
+
+    /**
+     * The surfaces of `below` and `above`
+     */
+    RasterCache<int> rasters;
+};
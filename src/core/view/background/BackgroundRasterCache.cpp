@@ -0,0 +1,87 @@
+#include "BackgroundRasterCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+namespace {
+auto rasterSize(const BackgroundRasterCache::Key& key) -> size_t {
+    return static_cast<size_t>(BackgroundRasterCache::getRasterWidth(key)) *
+           static_cast<size_t>(BackgroundRasterCache::getRasterHeight(key)) * 4;
+}
+}  // namespace
+
+auto BackgroundRasterCache::Key::operator==(const Key& other) const -> bool {
+    return format == other.format && config == other.config && width == other.width && height == other.height &&
+           backgroundColor == other.backgroundColor && lineWidthFactor == other.lineWidthFactor &&
+           scaleX == other.scaleX && scaleY == other.scaleY;
+}
+
+auto BackgroundRasterCache::Key::operator<(const Key& other) const -> bool {
+    return std::tie(format, config, width, height, backgroundColor, lineWidthFactor, scaleX, scaleY) <
+           std::tie(other.format, other.config, other.width, other.height, other.backgroundColor,
+                    other.lineWidthFactor, other.scaleX, other.scaleY);
+}
+
+BackgroundRasterCache::BackgroundRasterCache() = default;
+
+BackgroundRasterCache::~BackgroundRasterCache() = default;
+
+auto BackgroundRasterCache::getInstance() -> BackgroundRasterCache& {
+    static BackgroundRasterCache instance;
+    return instance;
+}
+
+auto BackgroundRasterCache::getRasterWidth(const Key& key) -> int {
+    return static_cast<int>(std::ceil(key.width * key.scaleX));
+}
+
+auto BackgroundRasterCache::getRasterHeight(const Key& key) -> int {
+    return static_cast<int>(std::ceil(key.height * key.scaleY));
+}
+
+auto BackgroundRasterCache::fits(const Key& key) -> bool {
+    // A single background must not drop the rasters of all other pages and caches, e.g. at a very high zoom
+    return rasterSize(key) <= RasterBudget::getInstance().getMemoryLimit() / 8;
+}
+
+auto BackgroundRasterCache::get(const Key& key, const std::function<void(cairo_t*)>& paint) -> cairo_surface_t* {
+    std::unique_lock lock(this->mutex);
+
+    while (true) {
+        if (cairo_surface_t* raster = this->rasters.get(key)) {
+            return raster;
+        }
+
+        // Another thread is painting the same raster, wait for it instead of painting it twice
+        if (std::find(this->painting.begin(), this->painting.end(), key) == this->painting.end()) {
+            break;
+        }
+        this->painted.wait(lock);
+    }
+    this->painting.push_back(key);
+
+    // Other threads can use the cache while this raster is painted
+    lock.unlock();
+
+    cairo_surface_t* raster =
+            cairo_image_surface_create(CAIRO_FORMAT_ARGB32, getRasterWidth(key), getRasterHeight(key));
+    cairo_t* cr = cairo_create(raster);
+    cairo_scale(cr, key.scaleX, key.scaleY);
+    paint(cr);
+    cairo_destroy(cr);
+    cairo_surface_flush(raster);
+
+    lock.lock();
+    this->painting.erase(std::find(this->painting.begin(), this->painting.end(), key));
+    this->rasters.insert(key, raster);
+
+    lock.unlock();
+    this->painted.notify_all();
+
+    return raster;
+}
+
+void BackgroundRasterCache::clear() { this->rasters.clear(); }
+
+auto BackgroundRasterCache::getMemoryUsage() const -> size_t { return this->rasters.getMemoryUsage(); }
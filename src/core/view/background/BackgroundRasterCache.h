@@ -0,0 +1,91 @@
+/*
+ * Xournal++
+ *
+ * Cache of rendered page backgrounds, shared by all pages
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <cairo.h>
+
+#include "model/PageType.h"
+#include "util/Color.h"
+#include "util/RasterCache.h"
+
+/**
+ * Most pages of a document share the same ruling, size and color. Instead of emitting hundreds of lines for every
+ * rerender, the background is rendered once per zoom level and then painted as an image. The least recently used
+ * rasters are dropped when the budget shared with the other caches is exceeded, see RasterBudget.
+ */
+class BackgroundRasterCache {
+public:
+    struct Key {
+        PageTypeFormat format;
+        std::string config;
+        double width;
+        double height;
+        Color backgroundColor;
+        double lineWidthFactor;
+        double scaleX;
+        double scaleY;
+
+        bool operator==(const Key& other) const;
+        bool operator<(const Key& other) const;
+    };
+
+private:
+    BackgroundRasterCache();
+    ~BackgroundRasterCache();
+
+public:
+    BackgroundRasterCache(const BackgroundRasterCache&) = delete;
+    void operator=(const BackgroundRasterCache&) = delete;
+
+    static BackgroundRasterCache& getInstance();
+
+    /**
+     * @return A new reference to the raster for `key`, rendered by `paint` on a miss.
+     *         `paint` gets a context already scaled to page coordinates. It is called without holding the lock of the
+     *         cache, a thread which requests the same raster meanwhile waits for it.
+     */
+    cairo_surface_t* get(const Key& key, const std::function<void(cairo_t*)>& paint);
+
+    /**
+     * @return false if a raster for this key is too large to be cached
+     */
+    static bool fits(const Key& key);
+
+    void clear();
+
+    size_t getMemoryUsage() const;
+
+    static int getRasterWidth(const Key& key);
+    static int getRasterHeight(const Key& key);
+
+private:
+    std::mutex mutex;
+
+    RasterCache<Key> rasters;
+
+    /**
+     * Keys of the rasters which are painted right now
+     */
+    std::vector<Key> painting;
+
+    /**
+     * Notified when a raster is painted
+     */
+    std::condition_variable painted;
+};
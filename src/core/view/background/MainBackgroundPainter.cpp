@@ -1,6 +1,9 @@
 #include "MainBackgroundPainter.h"
 
+#include <cmath>
+
 #include "BackgroundConfig.h"
+#include "BackgroundRasterCache.h"
 #include "BaseBackgroundPainter.h"
 #include "DottedBackgroundPainter.h"
 #include "GraphBackgroundPainter.h"
@@ -32,15 +35,67 @@ MainBackgroundPainter::~MainBackgroundPainter() {
  * Set a factor to draw the lines bolder, for previews
  */
 void MainBackgroundPainter::setLineWidthFactor(double factor) {
+    this->lineWidthFactor = factor;
     for (auto& e: painter) { e.second->setLineWidthFactor(factor); }
 }
 
+auto MainBackgroundPainter::paintCached(BaseBackgroundPainter* painter, const PageType& pt, cairo_t* cr,
+                                        const PageRef& page) -> bool {
+    // Export and printing need vector output
+    if (cairo_surface_get_type(cairo_get_group_target(cr)) != CAIRO_SURFACE_TYPE_IMAGE) {
+        return false;
+    }
+
+    // The raster can only be blitted if page pixels map 1:1 to device pixels
+    cairo_matrix_t matrix;
+    cairo_get_matrix(cr, &matrix);
+    if (matrix.xy != 0 || matrix.yx != 0 || matrix.xx <= 0 || matrix.yy <= 0 ||
+        matrix.x0 != std::round(matrix.x0) || matrix.y0 != std::round(matrix.y0)) {
+        return false;
+    }
+
+    BackgroundRasterCache& cache = BackgroundRasterCache::getInstance();
+    BackgroundRasterCache::Key key{pt.format,
+                                   pt.config,
+                                   page->getWidth(),
+                                   page->getHeight(),
+                                   page->getBackgroundColor(),
+                                   this->lineWidthFactor,
+                                   matrix.xx,
+                                   matrix.yy};
+    if (!cache.fits(key)) {
+        return false;
+    }
+
+    cairo_surface_t* raster = cache.get(key, [&](cairo_t* rasterCr) {
+        BackgroundConfig config(pt.config);
+        painter->resetConfig();
+        painter->paint(rasterCr, page, &config);
+    });
+
+    cairo_save(cr);
+    cairo_identity_matrix(cr);
+    cairo_set_source_surface(cr, raster, matrix.x0, matrix.y0);
+    cairo_rectangle(cr, matrix.x0, matrix.y0, BackgroundRasterCache::getRasterWidth(key),
+                    BackgroundRasterCache::getRasterHeight(key));
+    cairo_fill(cr);
+    cairo_restore(cr);
+
+    cairo_surface_destroy(raster);
+    return true;
+}
+
 void MainBackgroundPainter::paint(PageType pt, cairo_t* cr, PageRef page) {
     auto it = this->painter.find(pt.format);
 
     BaseBackgroundPainter* painter = defaultPainter;
     if (it != this->painter.end()) {
         painter = it->second;
+
+        // A plain background is a single fill, caching only pays off for rulings
+        if (paintCached(painter, pt, cr, page)) {
+            return;
+        }
     }
 
     BackgroundConfig config(pt.config);
@@ -35,7 +35,17 @@ public:
      */
     void setLineWidthFactor(double factor);
 
+private:
+    /**
+     * Paint the background from the shared BackgroundRasterCache, if cr is a raster target
+     *
+     * @return false if the background has to be painted as vector graphics
+     */
+    bool paintCached(BaseBackgroundPainter* painter, const PageType& pt, cairo_t* cr, const PageRef& page);
+
 private:
     std::map<PageTypeFormat, BaseBackgroundPainter*> painter;
     BaseBackgroundPainter* defaultPainter;
+
+    double lineWidthFactor = 1;
 };
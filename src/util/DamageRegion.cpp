@@ -0,0 +1,163 @@
+#include "util/DamageRegion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+auto toCairoRect(const Rectangle<double>& rect) -> cairo_rectangle_int_t {
+    auto x1 = static_cast<int>(std::floor(rect.x));
+    auto y1 = static_cast<int>(std::floor(rect.y));
+    auto x2 = static_cast<int>(std::ceil(rect.x + rect.width));
+    auto y2 = static_cast<int>(std::ceil(rect.y + rect.height));
+    return {x1, y1, x2 - x1, y2 - y1};
+}
+
+auto toRectangle(const cairo_rectangle_int_t& rect) -> Rectangle<double> {
+    return {static_cast<double>(rect.x), static_cast<double>(rect.y), static_cast<double>(rect.width),
+            static_cast<double>(rect.height)};
+}
+
+auto area(const cairo_rectangle_int_t& rect) -> double {
+    return static_cast<double>(rect.width) * static_cast<double>(rect.height);
+}
+
+auto boundingBox(const cairo_rectangle_int_t& a, const cairo_rectangle_int_t& b) -> cairo_rectangle_int_t {
+    int x1 = std::min(a.x, b.x);
+    int y1 = std::min(a.y, b.y);
+    int x2 = std::max(a.x + a.width, b.x + b.width);
+    int y2 = std::max(a.y + a.height, b.y + b.height);
+    return {x1, y1, x2 - x1, y2 - y1};
+}
+
+auto contains(const cairo_rectangle_int_t& outer, const cairo_rectangle_int_t& inner) -> bool {
+    return inner.x >= outer.x && inner.y >= outer.y && inner.x + inner.width <= outer.x + outer.width &&
+           inner.y + inner.height <= outer.y + outer.height;
+}
+
+auto regionArea(const cairo_region_t* region) -> double {
+    double sum = 0;
+    int n = cairo_region_num_rectangles(region);
+    for (int i = 0; i < n; i++) {
+        cairo_rectangle_int_t rect;
+        cairo_region_get_rectangle(region, i, &rect);
+        sum += area(rect);
+    }
+    return sum;
+}
+
+/**
+ * @return true if rendering `box` instead of the damaged parts inside it costs at most `maxWaste` extra
+ */
+auto isCheapToMerge(const cairo_region_t* region, const cairo_rectangle_int_t& box, double maxWaste) -> bool {
+    cairo_region_t* part = cairo_region_create_rectangle(&box);
+    cairo_region_intersect(part, region);
+    double covered = regionArea(part);
+    cairo_region_destroy(part);
+
+    return area(box) - covered <= maxWaste * area(box);
+}
+
+}  // namespace
+
+DamageRegion::DamageRegion(): region(cairo_region_create()) {}
+
+DamageRegion::~DamageRegion() { cairo_region_destroy(this->region); }
+
+DamageRegion::DamageRegion(DamageRegion&& other) noexcept:
+        region(std::exchange(other.region, cairo_region_create())) {}
+
+auto DamageRegion::operator=(DamageRegion&& other) noexcept -> DamageRegion& {
+    std::swap(this->region, other.region);
+    other.clear();
+    return *this;
+}
+
+void DamageRegion::add(const Rectangle<double>& rect) {
+    cairo_rectangle_int_t r = toCairoRect(rect);
+    if (r.width <= 0 || r.height <= 0) {
+        return;
+    }
+    cairo_region_union_rectangle(this->region, &r);
+}
+
+void DamageRegion::clear() {
+    cairo_region_destroy(this->region);
+    this->region = cairo_region_create();
+}
+
+auto DamageRegion::isEmpty() const -> bool { return cairo_region_is_empty(this->region); }
+
+auto DamageRegion::getExtents() const -> Rectangle<double> {
+    cairo_rectangle_int_t extents;
+    cairo_region_get_extents(this->region, &extents);
+    return toRectangle(extents);
+}
+
+auto DamageRegion::getArea() const -> double { return regionArea(this->region); }
+
+auto DamageRegion::getRects(const Rectangle<double>& clip, double maxWaste, size_t maxRects) const
+        -> std::vector<Rectangle<double>> {
+    cairo_region_t* work = cairo_region_copy(this->region);
+    if (clip.width > 0 && clip.height > 0) {
+        cairo_rectangle_int_t c = toCairoRect(clip);
+        cairo_region_intersect_rectangle(work, &c);
+    }
+
+    int n = cairo_region_num_rectangles(work);
+    std::vector<cairo_rectangle_int_t> rects;
+    rects.reserve(static_cast<size_t>(n));
+
+    // cairo returns the pieces sorted in horizontal bands, so a sweep over them merges neighbours first.
+    // This keeps the cost linear in the number of pieces, even for long eraser sweeps.
+    for (int i = 0; i < n; i++) {
+        cairo_rectangle_int_t rect;
+        cairo_region_get_rectangle(work, i, &rect);
+
+        if (!rects.empty()) {
+            cairo_rectangle_int_t box = boundingBox(rects.back(), rect);
+            if (isCheapToMerge(work, box, maxWaste)) {
+                rects.back() = box;
+                continue;
+            }
+        }
+        rects.push_back(rect);
+    }
+
+    // Merge the remaining pieces pairwise, which catches pieces of the same object split by a band in between
+    bool merged = rects.size() <= 4 * maxRects;
+    while (merged && rects.size() > 1) {
+        merged = false;
+        for (size_t i = 0; i < rects.size() && !merged; i++) {
+            for (size_t j = i + 1; j < rects.size(); j++) {
+                cairo_rectangle_int_t box = boundingBox(rects[i], rects[j]);
+                if (!isCheapToMerge(work, box, maxWaste)) {
+                    continue;
+                }
+
+                rects[i] = box;
+                rects.erase(rects.begin() + static_cast<std::ptrdiff_t>(j));
+                rects.erase(std::remove_if(rects.begin() + static_cast<std::ptrdiff_t>(i) + 1, rects.end(),
+                                           [&box](const cairo_rectangle_int_t& r) { return contains(box, r); }),
+                            rects.end());
+                merged = true;
+                break;
+            }
+        }
+    }
+
+    std::vector<Rectangle<double>> result;
+    if (rects.size() > maxRects) {
+        // Too fragmented, a single pass over all elements is cheaper
+        cairo_rectangle_int_t extents;
+        cairo_region_get_extents(work, &extents);
+        result.push_back(toRectangle(extents));
+    } else {
+        result.reserve(rects.size());
+        for (const cairo_rectangle_int_t& rect: rects) { result.push_back(toRectangle(rect)); }
+    }
+
+    cairo_region_destroy(work);
+    return result;
+}
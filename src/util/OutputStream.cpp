@@ -1,8 +1,16 @@
 #include "util/OutputStream.h"
 
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+
 #include <glib.h>
 
-#include "util/GzUtil.h"
 #include "util/i18n.h"
 
 OutputStream::OutputStream() = default;
@@ -17,27 +25,270 @@ void OutputStream::write(const char* str) { write(str, strlen(str)); }
 /// GzOutputStream /////////////////////////////////////
 ////////////////////////////////////////////////////////
 
-GzOutputStream::GzOutputStream(fs::path file): file(std::move(file)) {
-    this->fp = GzUtil::openPath(this->file, "w");
-    if (this->fp == nullptr) {
+namespace {
+/**
+ * Size of the uncompressed blocks, as in pigz
+ */
+constexpr size_t BLOCK_SIZE = 128 * 1024;
+
+/**
+ * Size of the deflate window, which is primed with the end of the previous block
+ */
+constexpr size_t DICTIONARY_SIZE = 32 * 1024;
+
+/**
+ * Operating system field of the gzip header: unknown
+ */
+constexpr unsigned char GZIP_OS_UNKNOWN = 255;
+
+void writeLittleEndian32(std::ofstream& out, uLong value) {
+    for (int i = 0; i < 4; i++) { out.put(static_cast<char>((value >> (8 * i)) & 0xffU)); }
+}
+}  // namespace
+
+struct GzOutputStream::Block {
+    std::string input;
+    std::string dictionary;
+    bool last = false;
+
+    std::string output;
+    uLong crc = 0;
+    uLong length = 0;
+    bool done = false;
+
+    /**
+     * The block could not be compressed, e.g. because of an invalid level or no memory
+     */
+    bool failed = false;
+
+    /**
+     * Deflates the input as raw deflate data. Non-final blocks end with a sync flush, so the next block starts on a
+     * byte boundary.
+     */
+    void compress(int level) {
+        z_stream stream{};
+        if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            this->failed = true;
+            return;
+        }
+        if (!this->dictionary.empty()) {
+            deflateSetDictionary(&stream, reinterpret_cast<const Bytef*>(this->dictionary.data()),
+                                 static_cast<uInt>(this->dictionary.size()));
+        }
+
+        this->length = this->input.size();
+        this->crc = crc32(0, reinterpret_cast<const Bytef*>(this->input.data()), static_cast<uInt>(this->length));
+
+        // The bound does not include the empty block of the sync flush
+        this->output.resize(deflateBound(&stream, this->length) + 16);
+        stream.next_in = reinterpret_cast<Bytef*>(this->input.data());
+        stream.avail_in = static_cast<uInt>(this->length);
+        int flush = this->last ? Z_FINISH : Z_SYNC_FLUSH;
+        for (;;) {
+            stream.next_out = reinterpret_cast<Bytef*>(this->output.data() + stream.total_out);
+            stream.avail_out = static_cast<uInt>(this->output.size() - stream.total_out);
+            int ret = deflate(&stream, flush);
+            if (ret == Z_STREAM_ERROR) {
+                this->failed = true;
+                break;
+            }
+            if (stream.avail_out != 0 || ret == Z_STREAM_END) {
+                break;
+            }
+            this->output.resize(this->output.size() * 2);
+        }
+        this->output.resize(stream.total_out);
+        deflateEnd(&stream);
+
+        this->input = std::string();
+        this->dictionary = std::string();
+    }
+};
+
+/**
+ * Pool of threads compressing the blocks. The blocks are returned in the order they were added.
+ */
+class GzOutputStream::Compressor {
+public:
+    Compressor(int level, size_t threads): level(level) {
+        for (size_t i = 0; i < threads; i++) { this->workers.emplace_back([this]() { work(); }); }
+    }
+
+    ~Compressor() {
+        {
+            std::lock_guard lock(this->mutex);
+            this->stop = true;
+        }
+        this->workCondition.notify_all();
+        for (std::thread& t: this->workers) { t.join(); }
+    }
+
+    void add(std::unique_ptr<Block> block) {
+        {
+            std::lock_guard lock(this->mutex);
+            this->queue.push_back(block.get());
+            this->blocks.push_back(std::move(block));
+        }
+        this->workCondition.notify_one();
+    }
+
+    auto pending() -> size_t {
+        std::lock_guard lock(this->mutex);
+        return this->blocks.size();
+    }
+
+    /**
+     * Waits until the oldest block is compressed
+     */
+    auto takeOldest() -> std::unique_ptr<Block> {
+        std::unique_lock lock(this->mutex);
+        this->doneCondition.wait(lock, [this]() { return this->blocks.front()->done; });
+        std::unique_ptr<Block> block = std::move(this->blocks.front());
+        this->blocks.pop_front();
+        return block;
+    }
+
+private:
+    void work() {
+        std::unique_lock lock(this->mutex);
+        for (;;) {
+            this->workCondition.wait(lock, [this]() { return this->stop || !this->queue.empty(); });
+            if (this->queue.empty()) {
+                return;
+            }
+
+            Block* block = this->queue.front();
+            this->queue.pop_front();
+
+            lock.unlock();
+            block->compress(this->level);
+            lock.lock();
+
+            block->done = true;
+            this->doneCondition.notify_all();
+        }
+    }
+
+private:
+    int level;
+
+    std::mutex mutex;
+    std::condition_variable workCondition;
+    std::condition_variable doneCondition;
+
+    /**
+     * All blocks which are not yet written, in order
+     */
+    std::deque<std::unique_ptr<Block>> blocks;
+
+    /**
+     * Blocks which are not yet compressed
+     */
+    std::deque<Block*> queue;
+
+    bool stop = false;
+    std::vector<std::thread> workers;
+};
+
+GzOutputStream::GzOutputStream(fs::path file, int level, size_t threads):
+        out(file, std::ios::binary | std::ios::trunc),
+        level(level),
+        threads(threads > 0 ? threads : std::max<size_t>(std::thread::hardware_concurrency(), 1)),
+        crc(crc32(0, nullptr, 0)),
+        file(std::move(file)) {
+    if (!this->out) {
         this->error = FS(_F("Error opening file: \"{1}\"") % this->file.u8string());
+        this->closed = true;
+        return;
     }
+
+    // gzip header: magic, deflate, no flags, no modification time, no extra flags
+    const std::array<unsigned char, 10> header = {0x1f, 0x8b, Z_DEFLATED, 0, 0, 0, 0, 0, 0, GZIP_OS_UNKNOWN};
+    this->out.write(reinterpret_cast<const char*>(header.data()), header.size());
+    this->buffer.reserve(BLOCK_SIZE);
 }
 
-GzOutputStream::~GzOutputStream() {
-    if (this->fp) {
-        close();
+GzOutputStream::~GzOutputStream() { close(); }
+
+auto GzOutputStream::getLastError() -> std::string& { return this->error; }
+
+void GzOutputStream::write(const char* data, int len) {
+    if (this->closed || len <= 0) {
+        return;
+    }
+
+    size_t remaining = static_cast<size_t>(len);
+    while (remaining > 0) {
+        size_t n = std::min(remaining, BLOCK_SIZE - this->buffer.size());
+        this->buffer.append(data, n);
+        data += n;
+        remaining -= n;
+
+        if (this->buffer.size() == BLOCK_SIZE) {
+            submitBlock(BLOCK_SIZE, false);
+        }
     }
-    this->fp = nullptr;
 }
 
-auto GzOutputStream::getLastError() -> std::string& { return this->error; }
+void GzOutputStream::submitBlock(size_t len, bool last) {
+    auto block = std::make_unique<Block>();
+    block->input = this->buffer.substr(0, len);
+    block->dictionary = this->dictionary;
+    block->last = last;
+    this->buffer.erase(0, len);
+
+    if (!last) {
+        this->dictionary += block->input;
+        if (this->dictionary.size() > DICTIONARY_SIZE) {
+            this->dictionary.erase(0, this->dictionary.size() - DICTIONARY_SIZE);
+        }
+    }
+
+    if (this->compressor == nullptr && (this->threads <= 1 || last)) {
+        // Single threaded, or everything fits in one block
+        block->compress(this->level);
+        writeBlock(*block);
+        return;
+    }
+
+    if (this->compressor == nullptr) {
+        this->compressor = std::make_unique<Compressor>(this->level, this->threads);
+    }
+    this->compressor->add(std::move(block));
+
+    // Bound the memory: keep at most two blocks per thread in flight
+    size_t maxPending = last ? 0 : 2 * this->threads;
+    while (this->compressor->pending() > maxPending) { writeBlock(*this->compressor->takeOldest()); }
+}
 
-void GzOutputStream::write(const char* data, int len) { gzwrite(this->fp, data, len); }
+void GzOutputStream::writeBlock(const Block& block) {
+    if (block.failed) {
+        if (this->error.empty()) {
+            this->error = FS(_F("Error compressing file: \"{1}\"") % this->file.u8string());
+        }
+        return;
+    }
+
+    this->out.write(block.output.data(), static_cast<std::streamsize>(block.output.size()));
+    this->crc = crc32_combine(this->crc, block.crc, static_cast<z_off_t>(block.length));
+    this->size += block.length;
+}
 
 void GzOutputStream::close() {
-    if (this->fp) {
-        gzclose(this->fp);
-        this->fp = nullptr;
+    if (this->closed) {
+        return;
+    }
+    this->closed = true;
+
+    submitBlock(this->buffer.size(), true);
+    this->compressor.reset();
+
+    // gzip trailer: CRC-32 and size modulo 2^32
+    writeLittleEndian32(this->out, this->crc);
+    writeLittleEndian32(this->out, this->size & 0xffffffffU);
+
+    this->out.close();
+    if (this->out.fail() && this->error.empty()) {
+        this->error = FS(_F("Error writing file: \"{1}\"") % this->file.u8string());
     }
 }
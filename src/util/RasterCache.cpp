@@ -0,0 +1,62 @@
+#include "util/RasterCache.h"
+
+#include <iterator>
+
+RasterBudget::RasterBudget() = default;
+
+RasterBudget::~RasterBudget() = default;
+
+auto RasterBudget::getInstance() -> RasterBudget& {
+    static RasterBudget instance;
+    return instance;
+}
+
+auto RasterBudget::add(Owner* owner, const void* key, cairo_surface_t* surface, bool cold) -> Iterator {
+    size_t size = static_cast<size_t>(cairo_image_surface_get_stride(surface)) *
+                  static_cast<size_t>(cairo_image_surface_get_height(surface));
+    Entry entry{owner, key, cairo_surface_reference(surface), size};
+    auto it = this->entries.insert(cold ? this->entries.end() : this->entries.begin(), entry);
+    this->memoryUsage += size;
+
+    evict(it);
+    return it;
+}
+
+void RasterBudget::touch(Iterator it) { this->entries.splice(this->entries.begin(), this->entries, it); }
+
+void RasterBudget::erase(Iterator it) {
+    this->memoryUsage -= it->size;
+    cairo_surface_destroy(it->surface);
+    this->entries.erase(it);
+}
+
+void RasterBudget::evict(Iterator keep) {
+    // The surface which was just added is kept, even if it alone exceeds the limit
+    auto it = this->entries.end();
+    while (this->memoryUsage > this->memoryLimit && it != this->entries.begin()) {
+        --it;
+        if (it == keep) {
+            continue;
+        }
+        it->owner->forget(it->key);
+        auto next = std::next(it);
+        erase(it);
+        it = next;
+    }
+}
+
+void RasterBudget::setMemoryLimit(size_t bytes) {
+    std::lock_guard lock(this->mutex);
+    this->memoryLimit = bytes;
+    evict(this->entries.end());
+}
+
+auto RasterBudget::getMemoryLimit() const -> size_t {
+    std::lock_guard lock(this->mutex);
+    return this->memoryLimit;
+}
+
+auto RasterBudget::getMemoryUsage() const -> size_t {
+    std::lock_guard lock(this->mutex);
+    return this->memoryUsage;
+}
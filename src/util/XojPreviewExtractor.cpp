@@ -2,6 +2,7 @@
 
 #include <array>
 #include <cstring>
+#include <string>
 
 #include <glib.h>
 #include <zip.h>
@@ -43,12 +44,17 @@ auto XojPreviewExtractor::getData(gsize& dataLen) -> unsigned char* {
  * @return If an image was read, or the error
  */
 auto XojPreviewExtractor::readPreview(char* buffer, int len) -> PreviewExtractResult {
+    int from = 0;
+    int startPreview = -1;
+    return scanPreview(buffer, len, from, startPreview);
+}
+
+auto XojPreviewExtractor::scanPreview(char* buffer, int len, int& from, int& startPreview) -> PreviewExtractResult {
     bool inTag = false;
     int startTag = 0;
-    int startPreview = -1;
     int endPreview = -1;
     int pageStart = -1;
-    for (int i = 0; i < len; i++) {
+    for (int i = from; i < len; i++) {
         if (inTag) {
             if (buffer[i] == '>') {
                 inTag = false;
@@ -87,6 +93,8 @@ auto XojPreviewExtractor::readPreview(char* buffer, int len) -> PreviewExtractRe
         return PREVIEW_RESULT_NO_PREVIEW;
     }
 
+    // Continue with the tag which is not complete yet, everything before is scanned
+    from = inTag ? startTag - 1 : len;
     return PREVIEW_RESULT_ERROR_READING_PREVIEW;
 }
 
@@ -110,13 +118,22 @@ auto XojPreviewExtractor::readFile(const fs::path& file) -> PreviewExtractResult
             return PREVIEW_RESULT_COULD_NOT_OPEN_FILE;
         }
 
-        // The <preview> Tag is within the first 179 Bytes
-        // The Preview should end within the first 8k
-
-        std::array<char, BUF_SIZE> buffer{};
-        int readLen = gzread(fp, buffer.data(), BUF_SIZE);
-
-        PreviewExtractResult result = readPreview(buffer.data(), readLen);
+        // The <preview> Tag is within the first 179 Bytes, read on until the end of the preview (or the first page, if
+        // there is none) but never further
+        std::string buffer;
+        std::array<char, BUF_SIZE> chunk{};
+        PreviewExtractResult result = PREVIEW_RESULT_ERROR_READING_PREVIEW;
+        int readLen = 0;
+        int scanned = 0;
+        int startPreview = -1;
+        while ((readLen = gzread(fp, chunk.data(), BUF_SIZE)) > 0) {
+            buffer.append(chunk.data(), static_cast<size_t>(readLen));
+            // Only the new data is scanned
+            result = scanPreview(buffer.data(), static_cast<int>(buffer.length()), scanned, startPreview);
+            if (result != PREVIEW_RESULT_ERROR_READING_PREVIEW) {
+                break;
+            }
+        }
 
         gzclose(fp);
         return result;
@@ -152,6 +169,8 @@ auto XojPreviewExtractor::readFile(const fs::path& file) -> PreviewExtractResult
         zip_int64_t read = zip_fread(thumb, data, thumbStat.size);
         if (read == -1) {
             g_free(data);
+            data = nullptr;
+            dataLen = 0;
             zip_fclose(thumb);
             zip_close(zipFp);
             return PREVIEW_RESULT_ERROR_READING_PREVIEW;
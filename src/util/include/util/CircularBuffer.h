@@ -13,13 +13,15 @@ class CircularBuffer: private std::vector<T> {
 public:
     CircularBuffer(size_t length): std::vector<T>(length > 1 ? length : 1), length(length > 1 ? length : 1) {}
     ~CircularBuffer() = default;
+    /**
+     * The most recent element
+     */
     T front() { return (*this)[head]; }
-    T back() {
-        if (head == 0) {
-            return (*this)[length - 1];
-        }
-        return (*this)[head - 1];
-    }
+
+    /**
+     * The oldest element, it is overwritten by the next push_front
+     */
+    T oldest() { return (*this)[head + 1 == length ? 0 : head + 1]; }
     void push_front(const T& ev) {
         head++;
         head %= length;
@@ -0,0 +1,74 @@
+/*
+ * Xournal++
+ *
+ * Accumulates the areas of a page which need to be rerendered
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <cairo.h>
+
+#include "util/Rectangle.h"
+
+/**
+ * A union of rectangles, e.g. all areas touched by an eraser sweep.
+ *
+ * The union is exact (backed by a cairo_region_t), so overlapping or adjacent rectangles never cause an area to be
+ * rendered twice. getRects() then reduces the region to a few rectangles which are cheap to render.
+ */
+class DamageRegion {
+public:
+    DamageRegion();
+    ~DamageRegion();
+
+    DamageRegion(const DamageRegion& other) = delete;
+    DamageRegion& operator=(const DamageRegion& other) = delete;
+
+    /**
+     * The moved-from region is empty afterwards
+     */
+    DamageRegion(DamageRegion&& other) noexcept;
+    DamageRegion& operator=(DamageRegion&& other) noexcept;
+
+public:
+    /**
+     * Adds a rectangle, non integer coordinates are rounded outwards
+     */
+    void add(const Rectangle<double>& rect);
+
+    void clear();
+
+    bool isEmpty() const;
+
+    /**
+     * @return The bounding box of the region
+     */
+    Rectangle<double> getExtents() const;
+
+    /**
+     * @return The area actually covered by the region
+     */
+    double getArea() const;
+
+    /**
+     * Cover the region with as few rectangles as sensible.
+     *
+     * Two pieces are merged into their bounding box if that box contains at most `maxWaste` (relative to its area)
+     * which is not part of the region. If more than `maxRects` rectangles remain, the extents are returned.
+     *
+     * @param clip Only return the parts inside this area (e.g. the page), ignored if empty
+     */
+    std::vector<Rectangle<double>> getRects(const Rectangle<double>& clip = {}, double maxWaste = 0.3,
+                                            size_t maxRects = 8) const;
+
+private:
+    cairo_region_t* region = nullptr;
+};
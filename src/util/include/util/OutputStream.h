@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <fstream>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -31,9 +33,18 @@ public:
     virtual void close() = 0;
 };
 
+/**
+ * Writes a gzip file. The data is split into blocks which are compressed in parallel (like pigz): every block is
+ * deflated independently, primed with the end of the previous block, and ends on a byte boundary, so the blocks
+ * concatenated form one regular deflate stream.
+ */
 class GzOutputStream: public OutputStream {
 public:
-    GzOutputStream(fs::path file);
+    /**
+     * @param level zlib compression level (0-9), Z_DEFAULT_COMPRESSION for the default
+     * @param threads Number of compression threads, 0 for one per processor
+     */
+    GzOutputStream(fs::path file, int level = Z_DEFAULT_COMPRESSION, size_t threads = 0);
     virtual ~GzOutputStream();
 
 public:
@@ -44,10 +55,38 @@ public:
     std::string& getLastError();
 
 private:
-    gzFile fp = nullptr;
+    struct Block;
+    class Compressor;
+
+    /**
+     * Compresses the first `len` bytes of the buffer, in a worker thread if there is more than one block
+     */
+    void submitBlock(size_t len, bool last);
+
+    void writeBlock(const Block& block);
+
+private:
+    std::ofstream out;
+    int level;
+    size_t threads;
+
+    /**
+     * Data not yet submitted, less than one block
+     */
+    std::string buffer;
+
+    /**
+     * The last bytes of the data, used as dictionary for the next block
+     */
+    std::string dictionary;
+
+    std::unique_ptr<Compressor> compressor;
+
+    uLong crc;
+    uLong size = 0;
+    bool closed = false;
 
     std::string error;
 
-    std::string target;
     fs::path file;
 };
@@ -0,0 +1,218 @@
+/*
+ * Xournal++
+ *
+ * Caches of rendered surfaces, sharing one memory budget
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <mutex>
+
+#include <cairo.h>
+
+/**
+ * The memory budget of all RasterCache instances (decoded images, TeX rasters, backgrounds and layers). When it is
+ * exceeded, the least recently used surface of any cache is dropped, so e.g. a document full of images can use the
+ * memory which its backgrounds do not need.
+ *
+ * All caches share the lock of the budget. Only lookups and the bookkeeping happen under it, never rendering.
+ */
+class RasterBudget {
+private:
+    RasterBudget();
+    ~RasterBudget();
+
+public:
+    RasterBudget(const RasterBudget&) = delete;
+    void operator=(const RasterBudget&) = delete;
+
+    static RasterBudget& getInstance();
+
+    /**
+     * Limit the memory used by all caches, the least recently used surfaces are dropped first
+     */
+    void setMemoryLimit(size_t bytes);
+    size_t getMemoryLimit() const;
+
+    /**
+     * @return The memory used by all caches, in bytes
+     */
+    size_t getMemoryUsage() const;
+
+    /**
+     * The sum of the budgets the caches had on their own
+     */
+    static constexpr size_t DEFAULT_MEMORY_LIMIT = 704 * 1024 * 1024;
+
+private:
+    /**
+     * Implemented by RasterCache, called with the lock held when a surface of the cache is evicted
+     */
+    class Owner {
+    public:
+        virtual ~Owner() = default;
+        virtual void forget(const void* key) = 0;
+    };
+
+    struct Entry {
+        Owner* owner;
+
+        /**
+         * The key of the surface in the cache of `owner`
+         */
+        const void* key;
+        cairo_surface_t* surface;
+        size_t size;
+    };
+
+    using Iterator = std::list<Entry>::iterator;
+
+    /**
+     * Takes a new reference of `surface` and drops the least recently used surfaces (but not this one) which exceed
+     * the budget. The lock must be held.
+     *
+     * @param cold Insert as least recently used
+     */
+    Iterator add(Owner* owner, const void* key, cairo_surface_t* surface, bool cold);
+
+    /**
+     * Marks the surface as most recently used. The lock must be held.
+     */
+    void touch(Iterator it);
+
+    /**
+     * Drops the surface without notifying its owner. The lock must be held.
+     */
+    void erase(Iterator it);
+
+    void evict(Iterator keep);
+
+    template <typename Key>
+    friend class RasterCache;
+
+private:
+    mutable std::mutex mutex;
+
+    /**
+     * Most recently used first
+     */
+    std::list<Entry> entries;
+
+    size_t memoryUsage = 0;
+    size_t memoryLimit = DEFAULT_MEMORY_LIMIT;
+};
+
+/**
+ * A cache of image surfaces with a budget shared with all other instances, see RasterBudget. `Key` needs operator<.
+ *
+ * All methods are thread safe.
+ */
+template <typename Key>
+class RasterCache: private RasterBudget::Owner {
+public:
+    // The budget is created first, so it is destroyed after static caches
+    RasterCache() { RasterBudget::getInstance(); }
+    ~RasterCache() override { clear(); }
+
+    RasterCache(const RasterCache&) = delete;
+    void operator=(const RasterCache&) = delete;
+
+public:
+    /**
+     * @return A new reference to the surface for `key`, nullptr if it is not cached
+     */
+    cairo_surface_t* get(const Key& key) {
+        RasterBudget& budget = RasterBudget::getInstance();
+        std::lock_guard lock(budget.mutex);
+
+        auto it = this->index.find(key);
+        if (it == this->index.end()) {
+            return nullptr;
+        }
+        budget.touch(it->second);
+        return cairo_surface_reference(it->second->surface);
+    }
+
+    /**
+     * Adds the surface for `key`, replacing the one cached before. Takes a new reference.
+     *
+     * @param cold Insert as least recently used, e.g. a surface which was only needed to build another one
+     */
+    void insert(const Key& key, cairo_surface_t* surface, bool cold = false) {
+        RasterBudget& budget = RasterBudget::getInstance();
+        std::lock_guard lock(budget.mutex);
+
+        auto [it, inserted] = this->index.try_emplace(key);
+        if (!inserted) {
+            this->memoryUsage -= it->second->size;
+            budget.erase(it->second);
+        }
+        // The address of the key in the map stays the same until it is erased
+        it->second = budget.add(this, &it->first, surface, cold);
+        this->memoryUsage += it->second->size;
+    }
+
+    void remove(const Key& key) {
+        RasterBudget& budget = RasterBudget::getInstance();
+        std::lock_guard lock(budget.mutex);
+
+        if (auto it = this->index.find(key); it != this->index.end()) {
+            eraseLocked(it);
+        }
+    }
+
+    /**
+     * Drops the surfaces of all keys from `first` to `last` (inclusive)
+     */
+    void removeRange(const Key& first, const Key& last) {
+        RasterBudget& budget = RasterBudget::getInstance();
+        std::lock_guard lock(budget.mutex);
+
+        auto it = this->index.lower_bound(first);
+        while (it != this->index.end() && !(last < it->first)) { it = eraseLocked(it); }
+    }
+
+    void clear() {
+        RasterBudget& budget = RasterBudget::getInstance();
+        std::lock_guard lock(budget.mutex);
+
+        for (auto& [key, entry]: this->index) { budget.erase(entry); }
+        this->index.clear();
+        this->memoryUsage = 0;
+    }
+
+    /**
+     * @return The memory used by the surfaces of this cache, in bytes
+     */
+    size_t getMemoryUsage() const {
+        std::lock_guard lock(RasterBudget::getInstance().mutex);
+        return this->memoryUsage;
+    }
+
+private:
+    using Index = std::map<Key, RasterBudget::Iterator>;
+
+    typename Index::iterator eraseLocked(typename Index::iterator it) {
+        this->memoryUsage -= it->second->size;
+        RasterBudget::getInstance().erase(it->second);
+        return this->index.erase(it);
+    }
+
+    void forget(const void* key) override {
+        auto it = this->index.find(*static_cast<const Key*>(key));
+        this->memoryUsage -= it->second->size;
+        this->index.erase(it);
+    }
+
+private:
+    Index index;
+    size_t memoryUsage = 0;
+};
@@ -72,6 +72,15 @@ public:
      */
     unsigned char* getData(gsize& dataLen);
 
+private:
+    /**
+     * Continues reading the preview from a buffer which grew since the last call
+     * @param from Position to continue scanning at, updated to the end of the scanned data
+     * @param startPreview Start of the preview data found so far, -1 if none
+     * @return If an image was read, or the error
+     */
+    PreviewExtractResult scanPreview(char* buffer, int len, int& from, int& startPreview);
+
     // Member
 private:
     /**
@@ -11,7 +11,11 @@
 
 #pragma once
 
-#include <sstream>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 #include <gtk/gtk.h>
 
@@ -19,6 +23,9 @@
 
 class Serializable;
 
+/**
+ * Reads a stream written by ObjectOutputStream. The data is not copied, it has to stay valid while the stream is read.
+ */
 class ObjectInputStream {
 public:
     ObjectInputStream() = default;
@@ -37,16 +44,57 @@ public:
     size_t readSizeT();
     std::string readString();
 
+    /**
+     * Reads data written by ObjectOutputStream::writeData()
+     * @param data The data, allocated with g_malloc, nullptr if empty
+     * @param len The number of elements
+     */
     void readData(void** data, int* len);
+
+    /**
+     * Reads an array written by ObjectOutputStream::writeData() with one copy directly into `data`
+     */
+    template <typename T>
+    void readData(std::vector<T>& data) {
+        static_assert(std::is_trivially_copyable_v<T>, "The elements are copied bytewise");
+        size_t count = 0;
+        const char* bytes = readDataBlock(sizeof(T), count);
+        data.resize(count);
+        if (count > 0) {
+            std::memcpy(data.data(), bytes, count * sizeof(T));
+        }
+    }
+
     cairo_surface_t* readImage();
 
+    /**
+     * Reads an image written by ObjectOutputStream::writeImage() without decoding it
+     * @return The PNG encoded image
+     */
+    std::string readImageData();
+
 private:
     void checkType(char type);
 
+    /**
+     * Reads the header of a data block and skips its content
+     * @param width The expected size of one element
+     * @param count The number of elements
+     * @return The content of the block
+     */
+    const char* readDataBlock(size_t width, size_t& count);
+
+    /**
+     * @return `count` bytes of the stream, the position is moved behind them
+     */
+    const char* readBytes(size_t count, const char* what);
+
+    template <typename T>
+    T readType();
+
     static std::string getType(char type);
 
 private:
-    std::istringstream istream;
-    size_t pos();
-    size_t len = 0;
+    std::string_view data;
+    size_t pos = 0;
 };
@@ -12,6 +12,7 @@
 #pragma once
 
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include <gtk/gtk.h>
@@ -36,8 +37,27 @@ public:
     void writeString(const std::string& s);
 
     void writeData(const void* data, int len, int width);
+
+    /**
+     * Writes the array in one block, it can be read by ObjectInputStream::readData(std::vector<T>&)
+     */
+    template <typename T>
+    void writeData(const std::vector<T>& data) {
+        static_assert(std::is_trivially_copyable_v<T>, "The elements are copied bytewise");
+        writeData(data.data(), static_cast<int>(data.size()), sizeof(T));
+    }
     void writeImage(cairo_surface_t* img);
 
+    /**
+     * Writes an already PNG encoded image, it can be read by ObjectInputStream::readImage()
+     */
+    void writeImageData(const std::string& png);
+
+    /**
+     * Makes sure `bytes` more bytes can be written without reallocation, for large payloads with a known size
+     */
+    void reserve(size_t bytes);
+
     GString* getStr();
 
 private:
@@ -1,31 +1,33 @@
 #include "util/serializing/ObjectInputStream.h"
 
+#include <sstream>
+
 #include "util/i18n.h"
 #include "util/serializing/Serializable.h"
 
 // This function requires that T is read from its binary representation to work (e.g. integer type)
 template <typename T>
-T readTypeFromSStream(std::istringstream& istream) {
-    if (istream.str().size() < sizeof(T)) {
-        std::ostringstream oss;
-        oss << "End reached: trying to read " << sizeof(T) << " bytes while only " << istream.str().size()
-            << " bytes available";
-        throw InputStreamException(oss.str(), __FILE__, __LINE__);
-    }
+auto ObjectInputStream::readType() -> T {
     T output;
-
-    istream.read((char*)&output, sizeof(T));
-
+    std::memcpy(&output, readBytes(sizeof(T), "a value"), sizeof(T));
     return output;
 }
 
-size_t ObjectInputStream::pos() { return istream.tellg(); }
+auto ObjectInputStream::readBytes(size_t count, const char* what) -> const char* {
+    if (this->data.size() - this->pos < count) {
+        std::ostringstream oss;
+        oss << "End reached: trying to read " << what << " of " << count << " bytes while only "
+            << this->data.size() - this->pos << " bytes available";
+        throw InputStreamException(oss.str(), __FILE__, __LINE__);
+    }
+    const char* bytes = this->data.data() + this->pos;
+    this->pos += count;
+    return bytes;
+}
 
 auto ObjectInputStream::read(const char* data, int data_len) -> bool {
-    istream.clear();
-    len = (size_t)data_len;
-    std::string dataStr = std::string(data, len);
-    istream.str(dataStr);
+    this->data = std::string_view(data, static_cast<size_t>(data_len));
+    this->pos = 0;
 
     try {
         std::string version = readString();
@@ -55,12 +57,12 @@ auto ObjectInputStream::readObject() -> std::string {
 }
 
 auto ObjectInputStream::getNextObjectName() -> std::string {
-    auto position = istream.tellg();
+    size_t position = this->pos;
 
     checkType('{');
     std::string name = readString();
 
-    istream.seekg(position);
+    this->pos = position;
     return name;
 }
 
@@ -68,97 +70,110 @@ void ObjectInputStream::endObject() { checkType('}'); }
 
 auto ObjectInputStream::readInt() -> int {
     checkType('i');
-    return readTypeFromSStream<int>(istream);
+    return readType<int>();
 }
 
 auto ObjectInputStream::readDouble() -> double {
     checkType('d');
-    return readTypeFromSStream<double>(istream);
+    return readType<double>();
 }
 
 auto ObjectInputStream::readSizeT() -> size_t {
     checkType('l');
-    return readTypeFromSStream<size_t>(istream);
+    return readType<size_t>();
 }
 
 auto ObjectInputStream::readString() -> std::string {
     checkType('s');
 
-    size_t lenString = (size_t)readTypeFromSStream<int>(istream);
-
-    if (istream.str().size() < len) {
-        throw InputStreamException("End reached, but try to read an string", __FILE__, __LINE__);
+    int lenString = readType<int>();
+    if (lenString < 0) {
+        throw InputStreamException("Negative string length", __FILE__, __LINE__);
     }
 
-    std::string output;
-    output.resize(lenString);
+    return std::string(readBytes(static_cast<size_t>(lenString), "a string"), static_cast<size_t>(lenString));
+}
 
-    istream.read(&output[0], (long)lenString);
+auto ObjectInputStream::readDataBlock(size_t width, size_t& count) -> const char* {
+    checkType('b');
 
-    return output;
+    int len = readType<int>();
+    int dataWidth = readType<int>();
+    if (len < 0 || dataWidth < 0) {
+        throw InputStreamException("Negative data length", __FILE__, __LINE__);
+    }
+    if (len > 0 && static_cast<size_t>(dataWidth) != width) {
+        throw InputStreamException(FS(FORMAT_STR("Expected data of width {1} but read width {2}") %
+                                      static_cast<int64_t>(width) % dataWidth),
+                                   __FILE__, __LINE__);
+    }
+
+    count = static_cast<size_t>(len);
+    return readBytes(count * width, "data");
 }
 
 void ObjectInputStream::readData(void** data, int* length) {
     checkType('b');
 
-    if (istream.str().size() < 2 * sizeof(int)) {
-        throw InputStreamException("End reached, but try to read data len and width", __FILE__, __LINE__);
+    int len = readType<int>();
+    int width = readType<int>();
+    if (len < 0 || width < 0) {
+        throw InputStreamException("Negative data length", __FILE__, __LINE__);
     }
 
-    int len = readTypeFromSStream<int>(istream);
-    int width = readTypeFromSStream<int>(istream);
-
-    if (istream.str().size() < (len * width)) {
-        throw InputStreamException("End reached, but try to read data", __FILE__, __LINE__);
-    }
+    size_t size = static_cast<size_t>(len) * static_cast<size_t>(width);
+    const char* bytes = readBytes(size, "data");
 
     if (len == 0) {
         *length = 0;
         *data = nullptr;
     } else {
-        *data = (void*)new char[(size_t)(len * width)];
+        *data = g_malloc(size);
+        std::memcpy(*data, bytes, size);
         *length = len;
-
-        istream.read((char*)*data, len * width);
-    }
-}
-
-cairo_status_t cairoReadFunction(std::istringstream* iss, unsigned char* data, unsigned int length) {
-    if (iss->str().size() < length) {
-        return CAIRO_STATUS_READ_ERROR;
     }
-    iss->read((char*)data, length);
-    return CAIRO_STATUS_SUCCESS;
 }
 
 auto ObjectInputStream::readImage() -> cairo_surface_t* {
     checkType('m');
 
-    if (istream.str().size() < sizeof(size_t)) {
-        throw InputStreamException("End reached, but try to read an image's data's length", __FILE__, __LINE__);
-    }
-
-    size_t len = readTypeFromSStream<size_t>(istream);
+    size_t len = readType<size_t>();
+    std::string_view png(readBytes(len, "an image"), len);
+
+    return cairo_image_surface_create_from_png_stream(
+            [](void* closure, unsigned char* data, unsigned int length) {
+                auto* remaining = static_cast<std::string_view*>(closure);
+                if (remaining->size() < length) {
+                    return CAIRO_STATUS_READ_ERROR;
+                }
+                std::memcpy(data, remaining->data(), length);
+                remaining->remove_prefix(length);
+                return CAIRO_STATUS_SUCCESS;
+            },
+            &png);
+}
 
-    if (istream.str().size() < len) {
-        throw InputStreamException("End reached, but try to read an image", __FILE__, __LINE__);
-    }
+auto ObjectInputStream::readImageData() -> std::string {
+    checkType('m');
 
-    return cairo_image_surface_create_from_png_stream((cairo_read_func_t)(&cairoReadFunction), &istream);
+    size_t len = readType<size_t>();
+    return std::string(readBytes(len, "an image"), len);
 }
 
 void ObjectInputStream::checkType(char type) {
-    if (istream.str().size() < 2) {
+    if (this->data.size() - this->pos < 2) {
         throw InputStreamException(FS(FORMAT_STR("End reached, but try to read {1}, index {2} of {3}") % getType(type) %
-                                      (uint32_t)pos() % (uint32_t)len),
+                                      (uint32_t)this->pos % (uint32_t)this->data.size()),
                                    __FILE__, __LINE__);
     }
-    char t = 0, underscore = 0;
-    istream >> underscore >> t;
+    char underscore = this->data[this->pos];
+    char t = this->data[this->pos + 1];
+    this->pos += 2;
 
     if (underscore != '_') {
         throw InputStreamException(FS(FORMAT_STR("Expected type signature of {1}, index {2} of {3}, but read '{4}'") %
-                                      getType(type) % ((uint32_t)pos() + 1) % (uint32_t)len % underscore),
+                                      getType(type) % ((uint32_t)this->pos - 1) % (uint32_t)this->data.size() %
+                                      underscore),
                                    __FILE__, __LINE__);
     }
 
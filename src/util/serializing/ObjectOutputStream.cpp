@@ -76,4 +76,23 @@ void ObjectOutputStream::writeImage(cairo_surface_t* img) {
     g_string_free(imgStr, true);
 }
 
+void ObjectOutputStream::writeImageData(const std::string& png) {
+    gsize len = png.length();
+
+    this->encoder->addStr("_m");
+    this->encoder->addData(&len, sizeof(gsize));
+
+    this->encoder->addData(png.data(), static_cast<int>(len));
+}
+
+void ObjectOutputStream::reserve(size_t bytes) {
+    GString* str = this->encoder->data;
+    gsize len = str->len;
+    if (str->allocated_len <= len + bytes) {
+        // GString has no reserve, growing and truncating keeps the allocation
+        g_string_set_size(str, len + bytes);
+        g_string_truncate(str, len);
+    }
+}
+
 auto ObjectOutputStream::getStr() -> GString* { return this->encoder->getData(); }
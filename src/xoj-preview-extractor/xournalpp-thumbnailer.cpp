@@ -19,6 +19,7 @@
 #include <cairo.h>
 #include <librsvg/rsvg.h>
 
+#include "control/xojfile/PreviewRenderer.h"
 #include "util/PathUtil.h"
 #include "util/XojPreviewExtractor.h"
 #include "util/i18n.h"
@@ -105,6 +106,11 @@ fs::path findAppIcon() {
     return "";
 }
 
+/**
+ * Size of the rendered thumbnail if the file has no preview, the size of a "large" thumbnail
+ */
+constexpr int THUMBNAIL_SIZE = 256;
+
 int main(int argc, char* argv[]) {
     initLocalisation();
 
@@ -117,6 +123,18 @@ int main(int argc, char* argv[]) {
     XojPreviewExtractor extractor;
     PreviewExtractResult result = extractor.readFile(argv[1]);
 
+    cairo_surface_t* rendered = nullptr;
+    if (result == PREVIEW_RESULT_NO_PREVIEW || result == PREVIEW_RESULT_ERROR_READING_PREVIEW) {
+        // Older files and files saved without preview: draw the first page instead
+        std::string error;
+        rendered = PreviewRenderer::renderFile(fs::u8path(argv[1]), THUMBNAIL_SIZE, error);
+        if (rendered) {
+            result = PREVIEW_RESULT_IMAGE_READ;
+        } else {
+            logMessage((_F("xoj-preview-extractor: could not render the first page: {1}") % error).str(), true);
+        }
+    }
+
     switch (result) {
         case PREVIEW_RESULT_IMAGE_READ:
             // continue to write preview
@@ -163,7 +181,8 @@ int main(int argc, char* argv[]) {
                 return CAIRO_STATUS_SUCCESS;
             };
     ReadClosure closure{0, imageData, dataLen};
-    cairo_surface_t* thumbnail = cairo_image_surface_create_from_png_stream(processRead, &closure);
+    cairo_surface_t* thumbnail =
+            rendered ? rendered : cairo_image_surface_create_from_png_stream(processRead, &closure);
     // This application is short-lived, so we'll purposefully be sloppy and let the OS free memory.
     if (cairo_surface_status(thumbnail) == CAIRO_STATUS_SUCCESS) {
         GError* err = nullptr;
@@ -0,0 +1,157 @@
+#include "BenchmarkRunner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <iomanip>
+#include <numeric>
+
+namespace {
+
+auto jsonEscape(const std::string& str) -> std::string {
+    std::string escaped;
+    escaped.reserve(str.size());
+    for (char c: str) {
+        switch (c) {
+            case '"':
+                escaped += "\\\"";
+                break;
+            case '\\':
+                escaped += "\\\\";
+                break;
+            case '\n':
+                escaped += "\\n";
+                break;
+            case '\t':
+                escaped += "\\t";
+                break;
+            default:
+                escaped += c;
+        }
+    }
+    return escaped;
+}
+
+}  // namespace
+
+auto BenchmarkResult::min() const -> double {
+    return samplesMs.empty() ? 0 : *std::min_element(samplesMs.begin(), samplesMs.end());
+}
+
+auto BenchmarkResult::max() const -> double {
+    return samplesMs.empty() ? 0 : *std::max_element(samplesMs.begin(), samplesMs.end());
+}
+
+auto BenchmarkResult::mean() const -> double {
+    if (samplesMs.empty()) {
+        return 0;
+    }
+    return std::accumulate(samplesMs.begin(), samplesMs.end(), 0.0) / static_cast<double>(samplesMs.size());
+}
+
+auto BenchmarkResult::median() const -> double {
+    if (samplesMs.empty()) {
+        return 0;
+    }
+    std::vector<double> sorted = samplesMs;
+    std::sort(sorted.begin(), sorted.end());
+    size_t mid = sorted.size() / 2;
+    if (sorted.size() % 2 == 0) {
+        return (sorted[mid - 1] + sorted[mid]) / 2;
+    }
+    return sorted[mid];
+}
+
+auto BenchmarkResult::stddev() const -> double {
+    if (samplesMs.size() < 2) {
+        return 0;
+    }
+    double m = mean();
+    double sum = 0;
+    for (double s: samplesMs) { sum += (s - m) * (s - m); }
+    return std::sqrt(sum / static_cast<double>(samplesMs.size() - 1));
+}
+
+void BenchmarkRunner::add(BenchmarkCase c) { cases.emplace_back(std::move(c)); }
+
+void BenchmarkRunner::setContext(const std::string& key, const std::string& value) { context[key] = value; }
+
+auto BenchmarkRunner::run(const Options& options, std::ostream& log) -> bool {
+    using Clock = std::chrono::steady_clock;
+    bool success = true;
+
+    for (BenchmarkCase& c: cases) {
+        if (!options.filter.empty() && c.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+
+        BenchmarkResult result;
+        result.name = c.name;
+        result.items = c.items;
+        result.itemUnit = c.itemUnit;
+
+        try {
+            for (int i = 0; i < options.warmup + options.repetitions; i++) {
+                if (c.setup) {
+                    c.setup();
+                }
+
+                auto start = Clock::now();
+                c.body();
+                auto end = Clock::now();
+
+                if (c.teardown) {
+                    c.teardown();
+                }
+
+                if (i >= options.warmup) {
+                    result.samplesMs.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+                }
+            }
+        } catch (const std::exception& e) {
+            log << c.name << ": failed: " << e.what() << std::endl;
+            success = false;
+            continue;
+        }
+
+        log << std::left << std::setw(32) << result.name << std::right << std::fixed << std::setprecision(3)
+            << " median " << std::setw(10) << result.median() << " ms"
+            << "  min " << std::setw(10) << result.min() << " ms";
+        if (result.items > 1 && result.median() > 0) {
+            log << "  " << std::setprecision(1) << static_cast<double>(result.items) * 1000.0 / result.median() << " "
+                << result.itemUnit << "/s";
+        }
+        log << std::endl;
+
+        results.emplace_back(std::move(result));
+    }
+
+    return success;
+}
+
+void BenchmarkRunner::writeJson(std::ostream& out) const {
+    out << std::setprecision(6) << std::fixed;
+    out << "{\n  \"context\": {";
+    bool first = true;
+    for (auto const& [key, value]: context) {
+        out << (first ? "\n" : ",\n") << "    \"" << jsonEscape(key) << "\": \"" << jsonEscape(value) << "\"";
+        first = false;
+    }
+    out << "\n  },\n  \"results\": [";
+
+    first = true;
+    for (BenchmarkResult const& r: results) {
+        out << (first ? "\n" : ",\n");
+        first = false;
+        out << "    {\"name\": \"" << jsonEscape(r.name) << "\", \"items\": " << r.items << ", \"unit\": \""
+            << jsonEscape(r.itemUnit) << "\", \"min_ms\": " << r.min() << ", \"median_ms\": " << r.median()
+            << ", \"mean_ms\": " << r.mean() << ", \"max_ms\": " << r.max() << ", \"stddev_ms\": " << r.stddev()
+            << ", \"samples_ms\": [";
+        for (size_t i = 0; i < r.samplesMs.size(); i++) { out << (i ? ", " : "") << r.samplesMs[i]; }
+        out << "]}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+auto BenchmarkRunner::getResults() const -> const std::vector<BenchmarkResult>& { return results; }
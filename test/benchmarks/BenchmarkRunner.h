@@ -0,0 +1,92 @@
+/*
+ * Xournal++
+ *
+ * Minimal timing harness for the xournalpp-bench target
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * A single named measurement.
+ *
+ * `setup` and `teardown` run around every timed call of `body`, but are not part of the sample.
+ */
+struct BenchmarkCase {
+    std::string name;
+    std::function<void()> body;
+
+    /**
+     * Number of work items (pages, files, events...) processed by one call of `body`.
+     * Used to report a throughput next to the raw timings.
+     */
+    size_t items = 1;
+    std::string itemUnit = "run";
+
+    std::function<void()> setup;
+    std::function<void()> teardown;
+};
+
+struct BenchmarkResult {
+    std::string name;
+    size_t items = 1;
+    std::string itemUnit;
+    std::vector<double> samplesMs;
+
+    double min() const;
+    double max() const;
+    double mean() const;
+    double median() const;
+    double stddev() const;
+};
+
+class BenchmarkRunner {
+public:
+    struct Options {
+        int warmup = 1;
+        int repetitions = 5;
+
+        /**
+         * Only cases whose name contains this string are run (empty: all)
+         */
+        std::string filter;
+    };
+
+public:
+    void add(BenchmarkCase c);
+
+    /**
+     * Additional key / value pairs written to the result header (document parameters etc.)
+     */
+    void setContext(const std::string& key, const std::string& value);
+
+    /**
+     * Runs all registered cases, prints a human readable summary to `log`
+     *
+     * @return false if any case threw an exception
+     */
+    bool run(const Options& options, std::ostream& log);
+
+    /**
+     * Writes all results collected by run() as JSON, suitable for regression tracking
+     */
+    void writeJson(std::ostream& out) const;
+
+    const std::vector<BenchmarkResult>& getResults() const;
+
+private:
+    std::vector<BenchmarkCase> cases;
+    std::vector<BenchmarkResult> results;
+    std::map<std::string, std::string> context;
+};
@@ -0,0 +1,127 @@
+#include "DocumentBenchmarks.h"
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+#include <cairo.h>
+
+#include "control/PdfCache.h"
+#include "control/jobs/ImageExport.h"
+#include "control/jobs/ProgressListener.h"
+#include "control/xojfile/LoadHandler.h"
+#include "control/xojfile/SaveHandler.h"
+#include "pdf/base/XojPdfExport.h"
+#include "pdf/base/XojPdfExportFactory.h"
+#include "util/PageRange.h"
+#include "view/DocumentView.h"
+#include "view/PdfView.h"
+
+namespace {
+
+/**
+ * The document is loaded once and shared by all cases except "load"
+ */
+struct LoadedDocument {
+    explicit LoadedDocument(const fs::path& file) {
+        doc = loader.loadDocument(file);
+        if (doc == nullptr) {
+            throw std::runtime_error("Could not load " + file.u8string() + ": " + loader.getLastError());
+        }
+        range.push_back(new PageRangeEntry(0, static_cast<int>(doc->getPageCount()) - 1));
+    }
+
+    ~LoadedDocument() {
+        for (PageRangeEntry* e: range) { delete e; }
+    }
+
+    LoadHandler loader;
+    Document* doc = nullptr;
+    PageRangeVector range;
+};
+
+void renderDocument(Document* doc, double zoom) {
+    DocumentView view;
+
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        PageRef page = doc->getPage(i);
+        auto width = static_cast<int>(std::lround(page->getWidth() * zoom));
+        auto height = static_cast<int>(std::lround(page->getHeight() * zoom));
+
+        cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+        cairo_t* cr = cairo_create(surface);
+        cairo_scale(cr, zoom, zoom);
+
+        // Same sequence as RenderJob, but without PdfCache to measure the real rendering cost
+        if (page->isLayerVisible(0) && page->getBackgroundType().isPdfPage()) {
+            XojPdfPageSPtr popplerPage = doc->getPdfPage(page->getPdfPageNr());
+            PdfView::drawPage(nullptr, popplerPage, cr, zoom, page->getWidth(), page->getHeight());
+        }
+        view.drawPage(page, cr, false);
+
+        cairo_destroy(cr);
+        cairo_surface_flush(surface);
+        cairo_surface_destroy(surface);
+    }
+}
+
+void exportImages(LoadedDocument& loaded, const fs::path& file, ExportGraphicsFormat format) {
+    DummyProgressListener progress;
+    ImageExport imgExport(loaded.doc, file, format, EXPORT_BACKGROUND_ALL, loaded.range);
+    imgExport.exportGraphics(&progress);
+
+    if (!imgExport.getLastErrorMsg().empty()) {
+        throw std::runtime_error(imgExport.getLastErrorMsg());
+    }
+}
+
+}  // namespace
+
+void DocumentBenchmarks::registerCases(BenchmarkRunner& runner, const fs::path& file, const fs::path& outputFolder,
+                                       double zoom) {
+    auto loaded = std::make_shared<LoadedDocument>(file);
+    size_t pages = loaded->doc->getPageCount();
+
+    runner.add({"load",
+                [file]() {
+                    LoadHandler loader;
+                    if (loader.loadDocument(file) == nullptr) {
+                        throw std::runtime_error(loader.getLastError());
+                    }
+                },
+                pages, "pages"});
+
+    runner.add({"render", [loaded, zoom]() { renderDocument(loaded->doc, zoom); }, pages, "pages"});
+
+    runner.add({"save",
+                [loaded, outputFolder]() {
+                    SaveHandler handler;
+                    handler.prepareSave(loaded->doc);
+                    handler.saveTo(outputFolder / "bench-save.xopp");
+                    if (!handler.getErrorMessage().empty()) {
+                        throw std::runtime_error(handler.getErrorMessage());
+                    }
+                },
+                pages, "pages"});
+
+    runner.add({"export-pdf",
+                [loaded, outputFolder]() {
+                    std::unique_ptr<XojPdfExport> pdfExport(XojPdfExportFactory::createExport(loaded->doc, nullptr));
+                    if (!pdfExport->createPdf(outputFolder / "bench-export.pdf", false)) {
+                        throw std::runtime_error(pdfExport->getLastError());
+                    }
+                },
+                pages, "pages"});
+
+    runner.add({"export-png",
+                [loaded, outputFolder]() {
+                    exportImages(*loaded, outputFolder / "bench-export.png", EXPORT_GRAPHICS_PNG);
+                },
+                pages, "pages"});
+
+    runner.add({"export-svg",
+                [loaded, outputFolder]() {
+                    exportImages(*loaded, outputFolder / "bench-export.svg", EXPORT_GRAPHICS_SVG);
+                },
+                pages, "pages"});
+}
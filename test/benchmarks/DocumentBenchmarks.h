@@ -0,0 +1,28 @@
+/*
+ * Xournal++
+ *
+ * Load / render / save / export benchmarks on a document file
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "BenchmarkRunner.h"
+#include "filesystem.h"
+
+namespace DocumentBenchmarks {
+
+/**
+ * Registers the cases "load", "render", "save", "export-pdf", "export-png" and "export-svg"
+ *
+ * @param file The document to benchmark
+ * @param outputFolder Folder for files written by save and export
+ * @param zoom Zoom factor used for rendering
+ */
+void registerCases(BenchmarkRunner& runner, const fs::path& file, const fs::path& outputFolder, double zoom);
+
+}  // namespace DocumentBenchmarks
@@ -0,0 +1,58 @@
+#include "ShapeRecognizerBenchmarks.h"
+
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "control/shaperecognizer/ShapeRecognizer.h"
+#include "model/Stroke.h"
+
+namespace {
+
+auto createCircle(size_t points) -> std::shared_ptr<Stroke> {
+    auto stroke = std::make_shared<Stroke>();
+    for (size_t i = 0; i <= points; i++) {
+        // A slightly wobbly circle, as drawn by hand
+        double a = 2 * M_PI * static_cast<double>(i) / static_cast<double>(points);
+        double r = 200 + 2 * sin(37 * a);
+        stroke->addPoint(Point(400 + r * cos(a), 400 + r * sin(a)));
+    }
+    return stroke;
+}
+
+auto createScribble(size_t points) -> std::shared_ptr<Stroke> {
+    auto stroke = std::make_shared<Stroke>();
+    for (size_t i = 0; i < points; i++) {
+        double t = static_cast<double>(i) / 50.0;
+        stroke->addPoint(Point(100 + t * 3 + 30 * sin(t * 1.7), 300 + 80 * sin(t * 0.9) + 20 * cos(t * 3.1)));
+    }
+    return stroke;
+}
+
+void addCases(BenchmarkRunner& runner, const std::string& name, const std::shared_ptr<Stroke>& stroke) {
+    size_t points = static_cast<size_t>(stroke->getPointCount());
+
+    runner.add({"recognize-" + name,
+                [stroke]() {
+                    ShapeRecognizer reco;
+                    delete reco.recognizePatterns(stroke.get());
+                },
+                points, "points"});
+
+    // The recognizer is prepared in the untimed setup, as it is while the stroke is drawn
+    auto reco = std::make_shared<std::unique_ptr<ShapeRecognizer>>();
+    runner.add({"recognize-" + name + "-drawn", [stroke, reco]() { delete (*reco)->recognizePatterns(stroke.get()); },
+                points, "points",
+                [stroke, reco]() {
+                    *reco = std::make_unique<ShapeRecognizer>();
+                    (*reco)->updateInertia(stroke.get());
+                },
+                [reco]() { reco->reset(); }});
+}
+}  // namespace
+
+void ShapeRecognizerBenchmarks::registerCases(BenchmarkRunner& runner, size_t points) {
+    addCases(runner, "circle", createCircle(points));
+    addCases(runner, "scribble", createScribble(points));
+}
@@ -0,0 +1,27 @@
+/*
+ * Xournal++
+ *
+ * Latency of the shape recognizer at pen-up
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "BenchmarkRunner.h"
+
+namespace ShapeRecognizerBenchmarks {
+
+/**
+ * Registers the cases "recognize-circle" and "recognize-scribble" (no shape found, the slowest path) on strokes with
+ * the given number of points. The "-drawn" variants feed the recognizer while the stroke is generated, like the
+ * StrokeHandler does, and only time the recognition at pen-up.
+ */
+void registerCases(BenchmarkRunner& runner, size_t points);
+
+}  // namespace ShapeRecognizerBenchmarks
@@ -0,0 +1,141 @@
+#include "StabilizerBenchmarks.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "control/tools/StrokeStabilizer.h"
+#include "gui/inputdevices/InputTrace.h"
+#include "model/Stroke.h"
+
+namespace {
+
+/**
+ * Collects the stabilized points without a page view, like the StrokeHandler without its motion filter
+ */
+class StrokeOutput: public StrokeStabilizer::Output {
+public:
+    auto getStroke() -> Stroke* override { return &this->stroke; }
+    void paintTo(const Point& point) override { this->stroke.addPoint(point); }
+    void drawSegmentTo(const Point& point) override { this->stroke.addPoint(point); }
+
+private:
+    Stroke stroke;
+};
+
+using Strokes = std::vector<std::vector<PositionInputData>>;
+
+auto createTrace(size_t events) -> std::vector<PositionInputData> {
+    std::mt19937 random(42);
+    std::normal_distribution<double> noise(0, 0.4);
+
+    std::vector<PositionInputData> trace;
+    trace.reserve(events);
+    for (size_t i = 0; i < events; i++) {
+        double t = static_cast<double>(i) / 500.0;
+        PositionInputData pos{};
+        pos.x = 100 + 40 * t + 25 * sin(t * 9.0) + noise(random);
+        pos.y = 300 + 30 * sin(t * 13.0) * cos(t * 2.0) + noise(random);
+        pos.pressure = 0.5 + 0.3 * sin(t * 5.0);
+        pos.timestamp = static_cast<guint32>(i * 2);
+
+        // The pen rests for 20 ms every second
+        if (i % 500 >= 490 && !trace.empty()) {
+            pos.x = trace.back().x + noise(random) * 0.1;
+            pos.y = trace.back().y + noise(random) * 0.1;
+        }
+        trace.push_back(pos);
+    }
+    return trace;
+}
+
+/**
+ * Splits the pen events of a recorded trace into strokes, each from a button press to its release
+ */
+auto readTrace(const fs::path& file) -> Strokes {
+    std::vector<InputTraceEvent> events;
+    if (!InputTrace::read(file, events)) {
+        throw std::runtime_error("Could not read the input trace " + file.u8string());
+    }
+
+    Strokes strokes;
+    bool down = false;
+    for (const InputTraceEvent& event: events) {
+        if (event.deviceClass != INPUT_DEVICE_PEN) {
+            continue;
+        }
+        if (event.type == BUTTON_PRESS_EVENT) {
+            strokes.emplace_back();
+            down = true;
+        } else if (event.type == BUTTON_RELEASE_EVENT) {
+            down = false;
+        }
+        if (down && (event.type == BUTTON_PRESS_EVENT || event.type == MOTION_EVENT)) {
+            PositionInputData pos{};
+            pos.x = event.relativeX;
+            pos.y = event.relativeY;
+            pos.pressure = event.pressure;
+            pos.state = static_cast<GdkModifierType>(event.state);
+            pos.timestamp = event.timestamp;
+            strokes.back().push_back(pos);
+        }
+    }
+
+    strokes.erase(std::remove_if(strokes.begin(), strokes.end(), [](const auto& s) { return s.size() < 2; }),
+                  strokes.end());
+    if (strokes.empty()) {
+        throw std::runtime_error("The input trace " + file.u8string() + " contains no pen strokes");
+    }
+    return strokes;
+}
+
+using Factory = std::function<std::unique_ptr<StrokeStabilizer::Base>()>;
+
+void addCase(BenchmarkRunner& runner, const std::string& name, Factory factory,
+             const std::shared_ptr<Strokes>& strokes) {
+    size_t events = 0;
+    for (const auto& trace: *strokes) { events += trace.size(); }
+
+    runner.add({"stabilizer-" + name,
+                [factory, strokes]() {
+                    for (const auto& trace: *strokes) {
+                        StrokeOutput output;
+                        std::unique_ptr<StrokeStabilizer::Base> stabilizer = factory();
+                        stabilizer->initialize(&output, 1.0, trace.front());
+                        for (size_t i = 1; i < trace.size(); i++) { stabilizer->processEvent(trace[i]); }
+                        stabilizer->finalizeStroke();
+                    }
+                },
+                events, "events"});
+}
+}  // namespace
+
+void StabilizerBenchmarks::registerCases(BenchmarkRunner& runner, size_t events, const fs::path& inputTrace) {
+    using namespace StrokeStabilizer;
+
+    // Defaults of the Settings
+    constexpr size_t BUFFER_SIZE = 20;
+    constexpr double SIGMA = 0.5;
+    constexpr double DEADZONE_RADIUS = 1.3;
+    constexpr double DRAG = 0.4;
+    constexpr double MASS = 5.0;
+
+    auto trace = std::make_shared<Strokes>(inputTrace.empty() ? Strokes{createTrace(std::max<size_t>(events, 2))} :
+                                                                readTrace(inputTrace));
+
+    addCase(runner, "arithmetic", []() { return std::make_unique<Arithmetic>(true, BUFFER_SIZE); }, trace);
+    addCase(runner, "arithmetic-deadzone",
+            []() { return std::make_unique<ArithmeticDeadzone>(true, BUFFER_SIZE, DEADZONE_RADIUS, true); }, trace);
+    addCase(runner, "arithmetic-inertia",
+            []() { return std::make_unique<ArithmeticInertia>(true, BUFFER_SIZE, DRAG, MASS); }, trace);
+    addCase(runner, "gaussian", []() { return std::make_unique<VelocityGaussian>(true, SIGMA); }, trace);
+    addCase(runner, "gaussian-deadzone",
+            []() { return std::make_unique<VelocityGaussianDeadzone>(true, SIGMA, DEADZONE_RADIUS, true); }, trace);
+    addCase(runner, "gaussian-inertia",
+            []() { return std::make_unique<VelocityGaussianInertia>(true, SIGMA, DRAG, MASS); }, trace);
+}
@@ -0,0 +1,31 @@
+/*
+ * Xournal++
+ *
+ * Stroke stabilizers driven by a pen trace
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "BenchmarkRunner.h"
+#include "filesystem.h"
+
+namespace StabilizerBenchmarks {
+
+/**
+ * Registers one "stabilizer-..." case per averaging method and preprocessor, each processing a generated handwriting
+ * trace with the given number of motion events (500 Hz, with sensor noise and pauses) using the default settings.
+ *
+ * If an input trace recorded with --record-input is given, its pen strokes are processed instead.
+ *
+ * @throws std::runtime_error if the input trace cannot be read
+ */
+void registerCases(BenchmarkRunner& runner, size_t events, const fs::path& inputTrace = {});
+
+}  // namespace StabilizerBenchmarks
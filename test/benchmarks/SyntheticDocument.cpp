@@ -0,0 +1,200 @@
+#include "SyntheticDocument.h"
+
+#include <algorithm>
+#include <cmath>
+#include <locale>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+#include <cairo-pdf.h>
+#include <cairo.h>
+#include <glib.h>
+
+#include "util/OutputStream.h"
+
+namespace {
+
+constexpr const char* COLORS[] = {"#000000ff", "#3333ccff", "#ff0000ff", "#008000ff", "#808080ff", "#00c0ffff"};
+
+auto pngWriteFunction(std::string* data, const unsigned char* buffer, unsigned int length) -> cairo_status_t {
+    data->append(reinterpret_cast<const char*>(buffer), length);
+    return CAIRO_STATUS_SUCCESS;
+}
+
+/**
+ * A gradient with some noise, so the PNG does not compress to nothing
+ */
+auto createImageBase64(int size, std::mt19937& rng) -> std::string {
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_RGB24, size, size);
+    cairo_t* cr = cairo_create(surface);
+
+    cairo_pattern_t* gradient = cairo_pattern_create_linear(0, 0, size, size);
+    cairo_pattern_add_color_stop_rgb(gradient, 0, 0.2, 0.4, 0.8);
+    cairo_pattern_add_color_stop_rgb(gradient, 1, 0.9, 0.7, 0.1);
+    cairo_set_source(cr, gradient);
+    cairo_paint(cr);
+    cairo_pattern_destroy(gradient);
+
+    std::uniform_real_distribution<double> pos(0, size);
+    std::uniform_real_distribution<double> channel(0, 1);
+    for (int i = 0; i < 200; i++) {
+        cairo_set_source_rgb(cr, channel(rng), channel(rng), channel(rng));
+        cairo_arc(cr, pos(rng), pos(rng), size / 40.0, 0, 2 * M_PI);
+        cairo_fill(cr);
+    }
+    cairo_destroy(cr);
+
+    std::string png;
+    cairo_surface_write_to_png_stream(surface, reinterpret_cast<cairo_write_func_t>(&pngWriteFunction), &png);
+    cairo_surface_destroy(surface);
+
+    gchar* base64 = g_base64_encode(reinterpret_cast<const guchar*>(png.data()), png.size());
+    std::string result = base64;
+    g_free(base64);
+    return result;
+}
+
+void writePdf(const SyntheticDocumentSpec& spec, const fs::path& file) {
+    cairo_surface_t* surface = cairo_pdf_surface_create(file.u8string().c_str(), spec.pageWidth, spec.pageHeight);
+    cairo_t* cr = cairo_create(surface);
+
+    for (size_t p = 0; p < spec.pages; p++) {
+        // Some text and vector graphics, roughly like a lecture slide
+        cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+        cairo_set_font_size(cr, 11);
+        cairo_set_source_rgb(cr, 0, 0, 0);
+        for (double y = 60; y < spec.pageHeight - 40; y += 14) {
+            cairo_move_to(cr, 50, y);
+            cairo_show_text(cr, "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor.");
+        }
+
+        cairo_set_line_width(cr, 0.5);
+        cairo_set_source_rgb(cr, 0.2, 0.3, 0.7);
+        for (int i = 0; i < 40; i++) {
+            cairo_arc(cr, spec.pageWidth / 2, spec.pageHeight / 2, 10.0 + i * 5, 0, 2 * M_PI);
+            cairo_stroke(cr);
+        }
+        cairo_show_page(cr);
+    }
+
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+}
+
+}  // namespace
+
+auto SyntheticDocumentSpec::describe() const -> std::string {
+    std::ostringstream str;
+    str << pages << " pages x " << strokesPerPage << " strokes x " << pointsPerStroke << " points";
+    if (imagesPerPage) {
+        str << ", " << imagesPerPage << " images/page";
+    }
+    if (textsPerPage) {
+        str << ", " << textsPerPage << " texts/page";
+    }
+    str << (pdfBackground ? ", PDF background" : ", " + ruling + " background");
+    return str.str();
+}
+
+auto SyntheticDocument::write(const SyntheticDocumentSpec& spec, const fs::path& folder) -> fs::path {
+    std::ostringstream name;
+    name << "synthetic-" << spec.pages << "p-" << spec.strokesPerPage << "s-" << spec.pointsPerStroke << "pt-"
+         << spec.imagesPerPage << "i-" << spec.textsPerPage << "t" << (spec.pdfBackground ? "-pdf" : "");
+
+    fs::path file = folder / (name.str() + ".xopp");
+    fs::path pdfFile = folder / (name.str() + ".pdf");
+
+    if (spec.pdfBackground) {
+        writePdf(spec, pdfFile);
+    }
+
+    std::mt19937 rng(spec.seed);
+    std::uniform_real_distribution<double> startX(20, spec.pageWidth - 20);
+    std::uniform_real_distribution<double> startY(20, spec.pageHeight - 20);
+    std::normal_distribution<double> step(0, 1.5);
+    std::uniform_real_distribution<double> width(0.8, 3.0);
+    std::uniform_int_distribution<size_t> color(0, std::size(COLORS) - 1);
+
+    // The image content is shared, like a logo pasted on every page
+    std::string image;
+    if (spec.imagesPerPage) {
+        image = createImageBase64(spec.imageSize, rng);
+    }
+
+    GzOutputStream out(file);
+    if (!out.getLastError().empty()) {
+        throw std::runtime_error(out.getLastError());
+    }
+
+    std::ostringstream xml;
+    xml.imbue(std::locale::classic());
+    xml.precision(6);
+
+    auto flush = [&]() {
+        out.write(xml.str());
+        xml.str("");
+    };
+
+    xml << "<?xml version=\"1.0\" standalone=\"no\"?>\n";
+    xml << "<xournal creator=\"xournalpp-bench\" fileversion=\"4\">\n";
+    xml << "<title>Xournal++ document - synthetic benchmark</title>\n";
+
+    for (size_t p = 0; p < spec.pages; p++) {
+        xml << "<page width=\"" << spec.pageWidth << "\" height=\"" << spec.pageHeight << "\">\n";
+        if (spec.pdfBackground) {
+            xml << "<background type=\"pdf\"";
+            if (p == 0) {
+                xml << " domain=\"absolute\" filename=\"" << pdfFile.u8string() << "\"";
+            }
+            xml << " pageno=\"" << p + 1 << "\"/>\n";
+        } else {
+            xml << "<background type=\"solid\" color=\"#ffffffff\" style=\"" << spec.ruling << "\"/>\n";
+        }
+        xml << "<layer>\n";
+
+        for (size_t s = 0; s < spec.strokesPerPage; s++) {
+            xml << "<stroke tool=\"pen\" color=\"" << COLORS[color(rng)] << "\" width=\"" << width(rng) << "\">";
+            double x = startX(rng);
+            double y = startY(rng);
+            for (size_t i = 0; i < spec.pointsPerStroke; i++) {
+                x = std::clamp(x + step(rng), 0.0, spec.pageWidth);
+                y = std::clamp(y + step(rng), 0.0, spec.pageHeight);
+                xml << (i ? " " : "") << x << " " << y;
+            }
+            if (spec.pointsPerStroke < 2) {
+                // A stroke needs at least two points
+                xml << " " << x << " " << y;
+            }
+            xml << "</stroke>\n";
+            flush();
+        }
+
+        for (size_t i = 0; i < spec.textsPerPage; i++) {
+            xml << "<text font=\"Sans\" size=\"12\" x=\"" << startX(rng) << "\" y=\"" << startY(rng)
+                << "\" color=\"#000000ff\">Synthetic text element " << i
+                << "\nwith a second line of some length</text>\n";
+        }
+
+        for (size_t i = 0; i < spec.imagesPerPage; i++) {
+            double left = startX(rng) / 2;
+            double top = startY(rng) / 2;
+            xml << "<image left=\"" << left << "\" top=\"" << top << "\" right=\"" << left + 150 << "\" bottom=\""
+                << top + 150 << "\">" << image << "</image>\n";
+            flush();
+        }
+
+        xml << "</layer>\n</page>\n";
+        flush();
+    }
+
+    xml << "</xournal>\n";
+    flush();
+    out.close();
+
+    if (!out.getLastError().empty()) {
+        throw std::runtime_error(out.getLastError());
+    }
+
+    return file;
+}
@@ -0,0 +1,63 @@
+/*
+ * Xournal++
+ *
+ * Generates reproducible documents for benchmarking
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "filesystem.h"
+
+struct SyntheticDocumentSpec {
+    size_t pages = 20;
+    size_t strokesPerPage = 200;
+    size_t pointsPerStroke = 100;
+    size_t imagesPerPage = 0;
+    size_t textsPerPage = 0;
+
+    /**
+     * Use a generated PDF as page background instead of a ruling
+     */
+    bool pdfBackground = false;
+
+    /**
+     * Ruling used for pages without PDF background, e.g. "plain", "lined", "graph"
+     */
+    std::string ruling = "lined";
+
+    double pageWidth = 595.275591;
+    double pageHeight = 841.889764;
+
+    /**
+     * Edge length in pixel of the (square) generated images
+     */
+    int imageSize = 512;
+
+    unsigned int seed = 42;
+
+    /**
+     * Short description used in benchmark output
+     */
+    std::string describe() const;
+};
+
+namespace SyntheticDocument {
+
+/**
+ * Writes a .xopp file (and, if requested, its background PDF) into `folder`
+ *
+ * The output only depends on the spec, so it can be compared between builds.
+ *
+ * @return The path of the written .xopp file
+ */
+fs::path write(const SyntheticDocumentSpec& spec, const fs::path& folder);
+
+}  // namespace SyntheticDocument
@@ -0,0 +1,61 @@
+#include "ThumbnailBenchmarks.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "control/xojfile/PreviewRenderer.h"
+#include "util/PathUtil.h"
+#include "util/XojPreviewExtractor.h"
+
+namespace {
+/**
+ * Size of the rendered thumbnail, as in xournalpp-thumbnailer
+ */
+constexpr int THUMBNAIL_SIZE = 256;
+
+void render(const fs::path& file) {
+    std::string error;
+    cairo_surface_t* surface = PreviewRenderer::renderFile(file, THUMBNAIL_SIZE, error);
+    if (surface == nullptr) {
+        throw std::runtime_error("No thumbnail for " + file.u8string() + ": " + error);
+    }
+    cairo_surface_destroy(surface);
+}
+}  // namespace
+
+void ThumbnailBenchmarks::registerCases(BenchmarkRunner& runner, const fs::path& folder) {
+    std::vector<fs::path> files;
+    std::error_code ec;
+    for (const auto& entry: fs::directory_iterator(folder, ec)) {
+        if (entry.is_regular_file(ec) && Util::hasXournalFileExt(entry.path())) {
+            files.push_back(entry.path());
+        }
+    }
+    if (files.empty()) {
+        return;
+    }
+    std::sort(files.begin(), files.end());
+
+    runner.add({"thumbnail",
+                [files]() {
+                    for (const fs::path& file: files) {
+                        XojPreviewExtractor extractor;
+                        PreviewExtractResult result = extractor.readFile(file);
+                        if (result == PREVIEW_RESULT_NO_PREVIEW || result == PREVIEW_RESULT_ERROR_READING_PREVIEW) {
+                            render(file);
+                        } else if (result != PREVIEW_RESULT_IMAGE_READ) {
+                            throw std::runtime_error("No thumbnail for " + file.u8string() + ": " +
+                                                     std::to_string(result));
+                        }
+                    }
+                },
+                files.size(), "files"});
+
+    runner.add({"thumbnail-render",
+                [files]() {
+                    for (const fs::path& file: files) { render(file); }
+                },
+                files.size(), "files"});
+}
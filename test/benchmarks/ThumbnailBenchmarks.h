@@ -0,0 +1,25 @@
+/*
+ * Xournal++
+ *
+ * Thumbnailer benchmarks on a folder of documents
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "BenchmarkRunner.h"
+#include "filesystem.h"
+
+namespace ThumbnailBenchmarks {
+
+/**
+ * Registers the cases "thumbnail" (read the stored preview like xournalpp-thumbnailer, or render the first page if
+ * there is none) and "thumbnail-render" (always render the first page) over all .xopp and .xoj files of the folder
+ */
+void registerCases(BenchmarkRunner& runner, const fs::path& folder);
+
+}  // namespace ThumbnailBenchmarks
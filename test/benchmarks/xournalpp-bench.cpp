@@ -0,0 +1,177 @@
+/*
+ * Xournal++
+ *
+ * Headless performance benchmarks, see test/README.md
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <algorithm>
+#include <array>
+#include <clocale>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <glib.h>
+
+#include "util/PathUtil.h"
+
+#include "BenchmarkRunner.h"
+#include "DocumentBenchmarks.h"
+#include "ShapeRecognizerBenchmarks.h"
+#include "StabilizerBenchmarks.h"
+#include "SyntheticDocument.h"
+#include "ThumbnailBenchmarks.h"
+#include "filesystem.h"
+
+namespace {
+
+struct BenchOptions {
+    ~BenchOptions() {
+        g_free(file);
+        g_free(output);
+        g_free(filter);
+        g_free(ruling);
+        g_free(thumbnailDir);
+        g_free(inputTrace);
+    }
+
+    int pages = 20;
+    int strokes = 200;
+    int points = 100;
+    int images = 0;
+    int texts = 0;
+    int recoPoints = 100000;
+    int stabilizerEvents = 50000;
+    gchar* inputTrace{};
+    gboolean pdf = false;
+    gchar* ruling{};
+    gchar* file{};
+    gchar* thumbnailDir{};
+    double zoom = 1.0;
+    int warmup = 1;
+    int repetitions = 5;
+    gchar* filter{};
+    gchar* output{};
+    gboolean keep = false;
+};
+
+}  // namespace
+
+auto main(int argc, char* argv[]) -> int {
+    // Make sure numbers in generated files and JSON output are locale independent
+    setlocale(LC_NUMERIC, "C");
+
+    BenchOptions opt;
+    std::array options = {
+            GOptionEntry{"pages", 0, 0, G_OPTION_ARG_INT, &opt.pages, "Number of generated pages", "N"},
+            GOptionEntry{"strokes", 0, 0, G_OPTION_ARG_INT, &opt.strokes, "Strokes per generated page", "M"},
+            GOptionEntry{"points", 0, 0, G_OPTION_ARG_INT, &opt.points, "Points per generated stroke", "P"},
+            GOptionEntry{"images", 0, 0, G_OPTION_ARG_INT, &opt.images, "Images per generated page", "N"},
+            GOptionEntry{"texts", 0, 0, G_OPTION_ARG_INT, &opt.texts, "Text elements per generated page", "N"},
+            GOptionEntry{"pdf", 0, 0, G_OPTION_ARG_NONE, &opt.pdf, "Use a generated PDF as background", nullptr},
+            GOptionEntry{"ruling", 0, 0, G_OPTION_ARG_STRING, &opt.ruling,
+                         "Background of generated pages (plain, lined, ruled, graph, dotted...)", "NAME"},
+            GOptionEntry{"file", 'f', 0, G_OPTION_ARG_FILENAME, &opt.file,
+                         "Benchmark this document instead of a generated one", "FILE"},
+            GOptionEntry{"thumbnail-dir", 0, 0, G_OPTION_ARG_FILENAME, &opt.thumbnailDir,
+                         "Benchmark the thumbnailer on the documents of this folder (default: the benchmarked document)",
+                         "DIR"},
+            GOptionEntry{"reco-points", 0, 0, G_OPTION_ARG_INT, &opt.recoPoints,
+                         "Points of the strokes given to the shape recognizer", "N"},
+            GOptionEntry{"stabilizer-events", 0, 0, G_OPTION_ARG_INT, &opt.stabilizerEvents,
+                         "Motion events of the trace given to the stroke stabilizers", "N"},
+            GOptionEntry{"input-trace", 0, 0, G_OPTION_ARG_FILENAME, &opt.inputTrace,
+                         "Give the pen strokes of this trace (see xournalpp --record-input) to the stroke stabilizers",
+                         "FILE"},
+            GOptionEntry{"zoom", 'z', 0, G_OPTION_ARG_DOUBLE, &opt.zoom, "Zoom used for rendering", "ZOOM"},
+            GOptionEntry{"warmup", 0, 0, G_OPTION_ARG_INT, &opt.warmup, "Untimed runs per case", "N"},
+            GOptionEntry{"repeat", 'r', 0, G_OPTION_ARG_INT, &opt.repetitions, "Timed runs per case", "N"},
+            GOptionEntry{"filter", 0, 0, G_OPTION_ARG_STRING, &opt.filter,
+                         "Only run cases whose name contains this string", "TEXT"},
+            GOptionEntry{"output", 'o', 0, G_OPTION_ARG_FILENAME, &opt.output,
+                         "Write JSON results to this file instead of stdout", "FILE"},
+            GOptionEntry{"keep", 0, 0, G_OPTION_ARG_NONE, &opt.keep, "Keep generated and exported files", nullptr},
+            GOptionEntry{nullptr}};  // Must be terminated by a nullptr. See gtk doc
+
+    GOptionContext* context = g_option_context_new("- Xournal++ performance benchmarks");
+    g_option_context_add_main_entries(context, options.data(), nullptr);
+    GError* error = nullptr;
+    if (!g_option_context_parse(context, &argc, &argv, &error)) {
+        std::cerr << error->message << std::endl;
+        g_error_free(error);
+        g_option_context_free(context);
+        return 1;
+    }
+    g_option_context_free(context);
+
+    fs::path workdir = Util::getTmpDirSubfolder("bench");
+    Util::ensureFolderExists(workdir);
+
+    BenchmarkRunner runner;
+    fs::path file;
+
+    if (opt.file) {
+        file = fs::u8path(opt.file);
+        runner.setContext("document", file.u8string());
+    } else {
+        SyntheticDocumentSpec spec;
+        spec.pages = static_cast<size_t>(std::max(opt.pages, 1));
+        spec.strokesPerPage = static_cast<size_t>(std::max(opt.strokes, 0));
+        spec.pointsPerStroke = static_cast<size_t>(std::max(opt.points, 2));
+        spec.imagesPerPage = static_cast<size_t>(std::max(opt.images, 0));
+        spec.textsPerPage = static_cast<size_t>(std::max(opt.texts, 0));
+        spec.pdfBackground = opt.pdf;
+        if (opt.ruling) {
+            spec.ruling = opt.ruling;
+        }
+
+        std::cerr << "Generating " << spec.describe() << std::endl;
+        file = SyntheticDocument::write(spec, workdir);
+        runner.setContext("document", spec.describe());
+    }
+    runner.setContext("zoom", std::to_string(opt.zoom));
+    runner.setContext("reco-points", std::to_string(opt.recoPoints));
+    runner.setContext("stabilizer-events", std::to_string(opt.stabilizerEvents));
+    if (opt.inputTrace) {
+        runner.setContext("input-trace", opt.inputTrace);
+    }
+
+    try {
+        DocumentBenchmarks::registerCases(runner, file, workdir, opt.zoom);
+        ThumbnailBenchmarks::registerCases(runner, opt.thumbnailDir ? fs::u8path(opt.thumbnailDir) : file.parent_path());
+        ShapeRecognizerBenchmarks::registerCases(runner, static_cast<size_t>(std::max(opt.recoPoints, 3)));
+        StabilizerBenchmarks::registerCases(runner, static_cast<size_t>(std::max(opt.stabilizerEvents, 2)),
+                                            opt.inputTrace ? fs::u8path(opt.inputTrace) : fs::path());
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    BenchmarkRunner::Options runOptions;
+    runOptions.warmup = std::max(opt.warmup, 0);
+    runOptions.repetitions = std::max(opt.repetitions, 1);
+    if (opt.filter) {
+        runOptions.filter = opt.filter;
+    }
+
+    bool success = runner.run(runOptions, std::cerr);
+
+    if (opt.output) {
+        std::ofstream out(fs::u8path(opt.output));
+        runner.writeJson(out);
+    } else {
+        runner.writeJson(std::cout);
+    }
+
+    if (!opt.keep) {
+        std::error_code ec;
+        fs::remove_all(workdir, ec);
+    }
+
+    return success ? 0 : 2;
+}
@@ -0,0 +1,123 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <fstream>
+#include <string>
+#include <system_error>
+
+#include <config-test.h>
+#include <glib.h>
+#include <gtest/gtest.h>
+
+#include "control/BatchConverter.h"
+
+#include "filesystem.h"
+
+namespace {
+/**
+ * Every test gets a temporary folder of its own, which is removed afterwards
+ */
+class BatchConverterTest: public ::testing::Test {
+protected:
+    void SetUp() override {
+        gchar* dir = g_dir_make_tmp("xournalpp-batch-test-XXXXXX", nullptr);
+        ASSERT_NE(nullptr, dir);
+        this->folder = fs::u8path(dir);
+        g_free(dir);
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        fs::remove_all(this->folder, ec);
+    }
+
+    fs::path folder;
+};
+}  // namespace
+
+TEST(BatchConverter, testDirectorySource) {
+    BatchConverter converter({});
+    ASSERT_TRUE(converter.addSource(GET_TESTFILE("load")));
+
+    const auto& files = converter.getFiles();
+    ASSERT_EQ(2U, files.size());
+    EXPECT_EQ(fs::path(GET_TESTFILE("load/layer.xoj")), files[0].first);
+    EXPECT_EQ(fs::path(GET_TESTFILE("load/layer.pdf")), files[0].second);
+    EXPECT_EQ(fs::path(GET_TESTFILE("load/pages.xoj")), files[1].first);
+}
+
+TEST_F(BatchConverterTest, testManifestSource) {
+    fs::path manifest = folder / "manifest.txt";
+    {
+        std::ofstream out(manifest);
+        out << "# comment\n"
+            << "a.xopp\n"
+            << "\n"
+            << "sub/b.xoj\tout/b.png\r\n";
+    }
+
+    BatchConverter converter({});
+    ASSERT_TRUE(converter.addSource(manifest));
+
+    const auto& files = converter.getFiles();
+    ASSERT_EQ(2U, files.size());
+    EXPECT_EQ(folder / "a.xopp", files[0].first);
+    EXPECT_EQ(folder / "a.pdf", files[0].second);
+    EXPECT_EQ(folder / "sub/b.xoj", files[1].first);
+    EXPECT_EQ(folder / "out/b.png", files[1].second);
+
+    EXPECT_FALSE(converter.addSource(folder / "missing.txt"));
+}
+
+TEST_F(BatchConverterTest, testRun) {
+    fs::path manifest = folder / "run.txt";
+    {
+        std::ofstream out(manifest);
+        out << GET_TESTFILE("test1.xoj") << "\t" << (folder / "test1.pdf").u8string() << "\n"
+            << (folder / "missing.xopp").u8string() << "\n";
+    }
+
+    BatchConverter::Options options;
+    options.jobs = 2;
+    BatchConverter converter(options);
+    ASSERT_TRUE(converter.addSource(manifest));
+
+    EXPECT_EQ(1U, converter.run());
+    EXPECT_TRUE(fs::exists(folder / "test1.pdf"));
+}
+
+TEST_F(BatchConverterTest, testWorkerResults) {
+    fs::path manifest = folder / "worker.txt";
+    {
+        std::ofstream out(manifest);
+        out << GET_TESTFILE("test1.xoj") << "\t" << (folder / "test1.pdf").u8string() << "\n"
+            << (folder / "missing.xopp").u8string() << "\n";
+    }
+
+    BatchConverter::Options options;
+    options.resultFile = folder / "results.txt";
+    BatchConverter converter(options);
+    ASSERT_TRUE(converter.addSource(manifest));
+    EXPECT_EQ(1U, converter.run());
+
+    // One line per document, in the order of the manifest
+    std::ifstream in(options.resultFile);
+    std::string ok;
+    std::string failed;
+    ASSERT_TRUE(std::getline(in, ok));
+    ASSERT_TRUE(std::getline(in, failed));
+    std::string extra;
+    EXPECT_FALSE(std::getline(in, extra));
+
+    EXPECT_EQ(ok.size() - 1, ok.rfind('\t'));
+    EXPECT_EQ('0', failed[0]);
+    EXPECT_LT(failed.rfind('\t') + 1, failed.size());
+}
@@ -0,0 +1,71 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <chrono>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "control/latex/LatexCache.h"
+#include "util/PathUtil.h"
+
+#include "filesystem.h"
+
+TEST(LatexCache, testKey) {
+    std::string key = LatexCache::key("pdflatex '{}'", "x^2");
+    EXPECT_EQ(key, LatexCache::key("pdflatex '{}'", "x^2"));
+    EXPECT_NE(key, LatexCache::key("pdflatex '{}'", "x^3"));
+    EXPECT_NE(key, LatexCache::key("lualatex '{}'", "x^2"));
+    EXPECT_NE(LatexCache::key("a", "bc"), LatexCache::key("ab", "c"));
+}
+
+TEST(LatexCache, testStoreAndLookup) {
+    LatexCache cache(Util::getTmpDirSubfolder("latex-cache-test"));
+    std::string key = LatexCache::key("pdflatex '{}'", "\\frac{1}{2}");
+
+    EXPECT_FALSE(cache.contains(key));
+    EXPECT_FALSE(cache.lookup(key).has_value());
+
+    std::string pdf("%PDF-1.5\n\0binary", 16);
+    cache.store(key, pdf);
+
+    EXPECT_TRUE(cache.contains(key));
+    auto cached = cache.lookup(key);
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_EQ(pdf, *cached);
+}
+
+TEST(LatexCache, testRemoveLeastRecentlyUsed) {
+    fs::path folder = Util::getTmpDirSubfolder("latex-cache-eviction-test");
+    std::string pdf(100, 'x');
+
+    // Space for two PDFs
+    LatexCache cache(folder, 250);
+    std::string keys[3] = {LatexCache::key("", "a"), LatexCache::key("", "b"), LatexCache::key("", "c")};
+
+    auto age = [&](const std::string& key, int hours) {
+        fs::last_write_time(folder / (key + ".pdf"), fs::file_time_type::clock::now() - std::chrono::hours(hours));
+    };
+    cache.store(keys[0], pdf);
+    age(keys[0], 3);
+    cache.store(keys[1], pdf);
+    age(keys[1], 2);
+
+    // Using a PDF keeps it in the cache
+    EXPECT_TRUE(cache.lookup(keys[0]).has_value());
+
+    cache.store(keys[2], pdf);
+    EXPECT_TRUE(cache.contains(keys[0]));
+    EXPECT_FALSE(cache.contains(keys[1]));
+    EXPECT_TRUE(cache.contains(keys[2]));
+
+    fs::remove_all(folder);
+}
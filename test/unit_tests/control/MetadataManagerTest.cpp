@@ -0,0 +1,163 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "control/settings/MetadataManager.h"
+#include "util/PathUtil.h"
+
+#include "filesystem.h"
+
+namespace {
+auto createFolder(const std::string& name) -> fs::path {
+    fs::path folder = Util::getTmpDirSubfolder("metadata-test") / name;
+    fs::remove_all(folder);
+    return Util::ensureFolderExists(folder);
+}
+
+auto countLines(const fs::path& file) -> size_t {
+    std::ifstream in(file);
+    std::string line;
+    size_t lines = 0;
+    while (std::getline(in, line)) { lines++; }
+    return lines;
+}
+
+void store(MetadataManager& manager, const fs::path& file, int page, double zoom) {
+    manager.storeMetadata(file, page, zoom);
+    manager.documentChanged();
+}
+}  // namespace
+
+TEST(MetadataManager, testStoreAndLoad) {
+    fs::path folder = createFolder("store");
+    fs::path log = folder / "metadata.log";
+    {
+        MetadataManager manager(log, folder / "legacy");
+        store(manager, "/home/user/a.xopp", 3, 1.25);
+        store(manager, "/home/user/b b.xopp", 7, 0.5);
+        store(manager, "/home/user/a.xopp", 4, 2.0);
+
+        MetadataEntry a = manager.getForFile("/home/user/a.xopp");
+        ASSERT_TRUE(a.valid);
+        EXPECT_EQ(4, a.page);
+        EXPECT_EQ(2.0, a.zoom);
+    }
+
+    // Read back from the log by a new instance
+    MetadataManager manager(log, folder / "legacy");
+    MetadataEntry a = manager.getForFile("/home/user/a.xopp");
+    ASSERT_TRUE(a.valid);
+    EXPECT_EQ(4, a.page);
+    EXPECT_EQ(2.0, a.zoom);
+
+    MetadataEntry b = manager.getForFile("/home/user/b b.xopp");
+    ASSERT_TRUE(b.valid);
+    EXPECT_EQ(7, b.page);
+    EXPECT_EQ(0.5, b.zoom);
+
+    EXPECT_FALSE(manager.getForFile("/home/user/c.xopp").valid);
+}
+
+TEST(MetadataManager, testCompaction) {
+    fs::path folder = createFolder("compaction");
+    fs::path log = folder / "metadata.log";
+    {
+        MetadataManager manager(log, folder / "legacy");
+        for (int i = 0; i < 1000; i++) { store(manager, "/home/user/a.xopp", i, 1.0); }
+        store(manager, "/home/user/b.xopp", 1, 1.0);
+    }
+
+    // Outdated lines are dropped, so the log does not grow with every change
+    EXPECT_LT(countLines(log), 200U);
+
+    MetadataManager manager(log, folder / "legacy");
+    EXPECT_EQ(999, manager.getForFile("/home/user/a.xopp").page);
+    EXPECT_EQ(1, manager.getForFile("/home/user/b.xopp").page);
+}
+
+TEST(MetadataManager, testCompactionKeepsOtherInstances) {
+    fs::path folder = createFolder("instances");
+    fs::path log = folder / "metadata.log";
+
+    MetadataManager first(log, folder / "legacy");
+    store(first, "/home/user/a.xopp", 1, 1.0);
+
+    // Another instance appends to the log after the first one has read it
+    {
+        MetadataManager second(log, folder / "legacy");
+        store(second, "/home/user/b.xopp", 5, 1.5);
+    }
+
+    for (int i = 0; i < 200; i++) { store(first, "/home/user/a.xopp", i, 1.0); }
+    EXPECT_LT(countLines(log), 200U);
+
+    MetadataManager manager(log, folder / "legacy");
+    EXPECT_EQ(199, manager.getForFile("/home/user/a.xopp").page);
+    MetadataEntry b = manager.getForFile("/home/user/b.xopp");
+    ASSERT_TRUE(b.valid);
+    EXPECT_EQ(5, b.page);
+    EXPECT_EQ(1.5, b.zoom);
+}
+
+TEST(MetadataManager, testDamagedLog) {
+    fs::path folder = createFolder("damaged");
+    fs::path log = folder / "metadata.log";
+    {
+        std::ofstream out(log);
+        out << "XOJ-METADATA-LOG/1.0\n"
+            << "100\t2\t1.5\t/home/user/a.xopp\n"
+            << "200\t5\t1.";
+    }
+
+    {
+        MetadataManager manager(log, folder / "legacy");
+        EXPECT_EQ(2, manager.getForFile("/home/user/a.xopp").page);
+        store(manager, "/home/user/b.xopp", 9, 1.0);
+    }
+
+    // The cut off line was removed before appending
+    MetadataManager manager(log, folder / "legacy");
+    EXPECT_EQ(2, manager.getForFile("/home/user/a.xopp").page);
+    EXPECT_EQ(9, manager.getForFile("/home/user/b.xopp").page);
+    EXPECT_EQ(3U, countLines(log));
+}
+
+TEST(MetadataManager, testImportLegacyFolder) {
+    fs::path folder = createFolder("legacy-import");
+    fs::path legacy = Util::ensureFolderExists(folder / "legacy");
+    {
+        std::ofstream out(legacy / "1000.metadata");
+        out << "XOJ-METADATA/1.0\n"
+            << "\"/home/user/a.xopp\"\n"
+            << "page=3\n"
+            << "zoom=1.5\n";
+    }
+    {
+        std::ofstream out(legacy / "2000.metadata");
+        out << "XOJ-METADATA/1.0\n"
+            << "\"/home/user/a.xopp\"\n"
+            << "page=8\n"
+            << "zoom=2\n";
+    }
+
+    MetadataManager manager(folder / "metadata.log", legacy);
+    MetadataEntry a = manager.getForFile("/home/user/a.xopp");
+    ASSERT_TRUE(a.valid);
+    EXPECT_EQ(8, a.page);
+    EXPECT_EQ(2.0, a.zoom);
+
+    EXPECT_TRUE(fs::exists(folder / "metadata.log"));
+    EXPECT_FALSE(fs::exists(legacy));
+}
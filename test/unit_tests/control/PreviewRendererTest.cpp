@@ -0,0 +1,41 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <string>
+
+#include <cairo.h>
+#include <config-test.h>
+#include <gtest/gtest.h>
+
+#include "control/xojfile/PreviewRenderer.h"
+
+#include "filesystem.h"
+
+TEST(PreviewRenderer, testRenderFile) {
+    std::string error;
+    cairo_surface_t* surface =
+            PreviewRenderer::renderFile(fs::u8path(GET_TESTFILE("preview-test-no-preview.unzipped.xoj")), 256, error);
+    ASSERT_NE(nullptr, surface);
+    EXPECT_TRUE(error.empty());
+
+    // The portrait page fits into 256 x 256 pixels
+    EXPECT_EQ(256, cairo_image_surface_get_height(surface));
+    EXPECT_EQ(181, cairo_image_surface_get_width(surface));
+
+    cairo_surface_destroy(surface);
+}
+
+TEST(PreviewRenderer, testInvalidFile) {
+    std::string error;
+    EXPECT_EQ(nullptr,
+              PreviewRenderer::renderFile(fs::u8path(GET_TESTFILE("preview-test-invalid.xoj")), 256, error));
+    EXPECT_FALSE(error.empty());
+}
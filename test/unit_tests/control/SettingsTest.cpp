@@ -0,0 +1,94 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "control/settings/Settings.h"
+#include "control/settings/SettingsWriter.h"
+#include "util/PathUtil.h"
+
+#include "filesystem.h"
+
+namespace {
+auto createSettingsFile(const std::string& name) -> fs::path {
+    fs::path file = Util::getTmpDirSubfolder("settings-test") / name;
+    fs::remove(file);
+    return file;
+}
+}  // namespace
+
+TEST(Settings, testSaveIsDeferred) {
+    fs::path file = createSettingsFile("deferred.xml");
+
+    Settings settings(file);
+    settings.setDisplayDpi(123);
+    settings.setZoomStep(17.5);
+    EXPECT_FALSE(fs::exists(file));
+
+    settings.flush();
+    ASSERT_TRUE(fs::exists(file));
+
+    Settings loaded(file);
+    ASSERT_TRUE(loaded.load());
+    EXPECT_EQ(123, loaded.getDisplayDpi());
+    EXPECT_EQ(17.5, loaded.getZoomStep());
+}
+
+TEST(Settings, testSaveAfterDelay) {
+    fs::path file = createSettingsFile("delay.xml");
+
+    Settings settings(file);
+    settings.setDisplayDpi(96);
+
+    // Written from the main loop, shortly after the last change
+    auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!fs::exists(file) && std::chrono::steady_clock::now() < timeout) {
+        g_main_context_iteration(nullptr, false);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_TRUE(fs::exists(file));
+}
+
+TEST(Settings, testDestructorWrites) {
+    fs::path file = createSettingsFile("destructor.xml");
+    {
+        Settings settings(file);
+        settings.setDisplayDpi(144);
+    }
+
+    Settings loaded(file);
+    ASSERT_TRUE(loaded.load());
+    EXPECT_EQ(144, loaded.getDisplayDpi());
+}
+
+TEST(Settings, testWriterReplacesFile) {
+    fs::path folder = Util::getTmpDirSubfolder("settings-writer-test");
+    fs::path file = folder / "settings.xml";
+
+    {
+        SettingsWriter writer(file);
+        writer.write("first");
+        writer.write("second");
+        writer.flush();
+        EXPECT_EQ(6U, fs::file_size(file));
+
+        writer.write("third and last");
+    }
+    EXPECT_EQ(14U, fs::file_size(file));
+
+    // No temporary file is left behind
+    size_t files = 0;
+    for ([[maybe_unused]] const auto& entry: fs::directory_iterator(folder)) { files++; }
+    EXPECT_EQ(1U, files);
+}
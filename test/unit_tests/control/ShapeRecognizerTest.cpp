@@ -0,0 +1,102 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cmath>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "control/shaperecognizer/Inertia.h"
+#include "control/shaperecognizer/InertiaTable.h"
+#include "control/shaperecognizer/ShapeRecognizer.h"
+#include "model/Stroke.h"
+
+namespace {
+auto createCircle(double cx, double cy, double r, int points) -> Stroke {
+    Stroke stroke;
+    for (int i = 0; i <= points; i++) {
+        double a = 2 * M_PI * i / points;
+        stroke.addPoint(Point(cx + r * cos(a), cy + r * sin(a)));
+    }
+    return stroke;
+}
+
+void expectSameInertia(const Inertia& expected, const Inertia& actual) {
+    EXPECT_NEAR(expected.getMass(), actual.getMass(), 1e-6);
+    if (expected.getMass() > 0) {
+        EXPECT_NEAR(expected.centerX(), actual.centerX(), 1e-6);
+        EXPECT_NEAR(expected.centerY(), actual.centerY(), 1e-6);
+    }
+    EXPECT_NEAR(expected.xx(), actual.xx(), 1e-4);
+    EXPECT_NEAR(expected.xy(), actual.xy(), 1e-4);
+    EXPECT_NEAR(expected.yy(), actual.yy(), 1e-4);
+    EXPECT_NEAR(expected.det(), actual.det(), 1e-6);
+}
+}  // namespace
+
+TEST(ShapeRecognizer, testInertiaTableMatchesCalc) {
+    Stroke stroke = createCircle(500, 700, 80, 200);
+    const Point* pt = stroke.getPoints();
+
+    InertiaTable table;
+    table.update(stroke.getPointVector());
+    ASSERT_EQ(stroke.getPointCount(), table.size());
+
+    for (int start: {0, 1, 17, 100}) {
+        for (int end: {start, start + 1, start + 20, start + 50, stroke.getPointCount()}) {
+            if (end > stroke.getPointCount()) {
+                continue;
+            }
+            Inertia expected;
+            expected.calc(pt, start, end);
+            expectSameInertia(expected, table.get(start, end));
+        }
+    }
+}
+
+TEST(ShapeRecognizer, testInertiaTableIncremental) {
+    Stroke stroke = createCircle(50, 50, 20, 60);
+    const auto& points = stroke.getPointVector();
+
+    InertiaTable table;
+    table.update(std::vector<Point>(points.begin(), points.begin() + 10));
+    table.update(points);
+    ASSERT_EQ(stroke.getPointCount(), table.size());
+
+    Inertia expected;
+    expected.calc(stroke.getPoints(), 0, stroke.getPointCount());
+    expectSameInertia(expected, table.get(0, stroke.getPointCount()));
+}
+
+TEST(ShapeRecognizer, testRecognizeLine) {
+    auto stroke = std::make_unique<Stroke>();
+    for (int i = 0; i <= 1000; i++) { stroke->addPoint(Point(100 + i * 0.3, 200 + (i % 2) * 0.1)); }
+
+    ShapeRecognizer reco;
+    std::unique_ptr<Stroke> result(reco.recognizePatterns(stroke.get()));
+    ASSERT_NE(nullptr, result);
+    EXPECT_EQ(2, result->getPointCount());
+}
+
+TEST(ShapeRecognizer, testRecognizeCircle) {
+    Stroke stroke = createCircle(300, 300, 50, 5000);
+
+    // Feed the recognizer while "drawing", the result must be the same
+    ShapeRecognizer reco;
+    reco.updateInertia(&stroke);
+    std::unique_ptr<Stroke> result(reco.recognizePatterns(&stroke));
+    ASSERT_NE(nullptr, result);
+    EXPECT_GE(result->getPointCount(), 24);
+
+    Rectangle<double> bounds = result->getSnappedBounds();
+    EXPECT_NEAR(300, bounds.x + bounds.width / 2, 1.0);
+    EXPECT_NEAR(100, bounds.width, 1.0);
+}
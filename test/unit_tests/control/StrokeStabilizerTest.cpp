@@ -0,0 +1,267 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "control/tools/StrokeStabilizer.h"
+#include "model/Stroke.h"
+
+namespace {
+using namespace StrokeStabilizer;
+
+/*
+ * The averagers as they were before the running sum and the allocation-free buffers, used as a reference. The
+ * preprocessors did not change, so the hybrids reuse them.
+ */
+
+/**
+ * Averages the whole buffer for every event
+ */
+class ReferenceArithmetic: virtual public Active {
+public:
+    ReferenceArithmetic(bool finalize, size_t buffersize): Active(finalize), eventBuffer(buffersize) {}
+
+protected:
+    void recordFirstEvent(const PositionInputData& pos) override {
+        eventBuffer.assign(eventBuffer.size(), Event(pos));
+    }
+
+    void averageAndPaint(const Event& ev, guint32 timestamp) override {
+        eventBuffer.pop_back();
+        eventBuffer.push_front(ev);
+
+        Event sum = std::accumulate(begin(eventBuffer), end(eventBuffer), Event(0, 0, 0), [](auto&& lhs, auto&& rhs) {
+            return Event(lhs.x + rhs.x, lhs.y + rhs.y, lhs.pressure + rhs.pressure);
+        });
+
+        double d = static_cast<double>(eventBuffer.size());
+        sum.pressure /= d;
+        sum.x /= d;
+        sum.y /= d;
+        setLastPaintedEvent(sum);
+        drawEvent(sum);
+    }
+
+    void resetBuffer(Event& ev, guint32 timestamp) override {
+        // CircularBuffer::back() used to return the second most recent event
+        if (eventBuffer[1] != ev) {
+            eventBuffer.assign(eventBuffer.size(), ev);
+        }
+    }
+
+    Event getLastEvent() override { return eventBuffer.front(); }
+
+private:
+    /**
+     * The most recent event first
+     */
+    std::deque<Event> eventBuffer;
+};
+
+/**
+ * Computes every weight with std::exp and erases the outdated events at once
+ */
+class ReferenceVelocityGaussian: virtual public Active {
+public:
+    ReferenceVelocityGaussian(bool finalize, double sigma): Active(finalize), twoSigmaSquared(2 * sigma * sigma) {}
+
+protected:
+    struct VelocityEvent: public Event {
+        VelocityEvent(const Event& ev, double velocity = 0): Event(ev), velocity(velocity) {}
+        double velocity{};
+    };
+
+    void recordFirstEvent(const PositionInputData& pos) override {
+        eventBuffer.emplace_front(Event(pos));
+        lastEventTimestamp = pos.timestamp;
+    }
+
+    void averageAndPaint(const Event& ev, guint32 timestamp) override {
+        if (eventBuffer.empty()) {
+            eventBuffer.emplace_front(ev);
+        } else {
+            VelocityEvent& last = eventBuffer.front();
+            guint32 timelaps = timestamp - lastEventTimestamp;
+            if (timelaps == 0) {
+                timelaps = 1;
+            }
+            eventBuffer.emplace_front(ev, std::hypot(ev.x - last.x, ev.y - last.y) / static_cast<double>(timelaps));
+        }
+        lastEventTimestamp = timestamp;
+
+        Event weightedSum = {0, 0, 0};
+        double weight;
+        double sumOfWeights = 0;
+        double sumOfVelocities = 0;
+
+        auto it = eventBuffer.cbegin();
+        for (; it != eventBuffer.cend(); ++it) {
+            weight = exp(-sumOfVelocities * sumOfVelocities / twoSigmaSquared);
+            if (weight < 0.01) {
+                break;
+            }
+            sumOfVelocities += (*it).velocity;
+            weightedSum.x += weight * (*it).x;
+            weightedSum.y += weight * (*it).y;
+            weightedSum.pressure += weight * (*it).pressure;
+            sumOfWeights += weight;
+        }
+        eventBuffer.erase(it, eventBuffer.cend());
+
+        weightedSum.x /= sumOfWeights;
+        weightedSum.y /= sumOfWeights;
+        weightedSum.pressure /= sumOfWeights;
+
+        setLastPaintedEvent(weightedSum);
+        drawEvent(weightedSum);
+    }
+
+    void resetBuffer(Event& ev, guint32 timestamp) override {
+        if (eventBuffer.size() != 1 || lastEventTimestamp != timestamp || eventBuffer.front() != ev) {
+            eventBuffer.clear();
+            lastEventTimestamp = timestamp;
+            eventBuffer.emplace_front(ev);
+        }
+    }
+
+    Event getLastEvent() override { return eventBuffer.front(); }
+
+private:
+    /**
+     * The most recent event first
+     */
+    std::deque<VelocityEvent> eventBuffer;
+    const double twoSigmaSquared;
+    guint32 lastEventTimestamp = 0;
+};
+
+template <class Averager, class Preprocessor>
+class ReferenceHybrid: public Averager, public Preprocessor {
+public:
+    template <typename Parameter, typename... Args>
+    ReferenceHybrid(bool finalize, Parameter averagerParameter, Args... preprocessorParameters):
+            Active(finalize),
+            Averager(finalize, averagerParameter),
+            Preprocessor(finalize, preprocessorParameters...) {}
+
+private:
+    void recordFirstEvent(const PositionInputData& pos) override {
+        Averager::recordFirstEvent(pos);
+        Preprocessor::recordFirstEvent(pos);
+    }
+    Event getLastEvent() override { return Preprocessor::getLastEvent(); }
+};
+
+class StrokeOutput: public StrokeStabilizer::Output {
+public:
+    auto getStroke() -> Stroke* override { return &this->stroke; }
+    void paintTo(const Point& point) override { this->stroke.addPoint(point); }
+    void drawSegmentTo(const Point& point) override { this->stroke.addPoint(point); }
+
+private:
+    Stroke stroke;
+};
+
+/**
+ * 2 seconds of a 500 Hz pen with noise, resting for 20 ms every second
+ */
+auto createTrace() -> std::vector<PositionInputData> {
+    std::mt19937 random(42);
+    std::normal_distribution<double> noise(0, 0.4);
+
+    std::vector<PositionInputData> trace;
+    for (size_t i = 0; i < 1000; i++) {
+        double t = static_cast<double>(i) / 500.0;
+        PositionInputData pos{};
+        pos.x = 100 + 40 * t + 25 * sin(t * 9.0) + noise(random);
+        pos.y = 300 + 30 * sin(t * 13.0) * cos(t * 2.0) + noise(random);
+        pos.pressure = 0.5 + 0.3 * sin(t * 5.0);
+        pos.timestamp = static_cast<guint32>(i * 2);
+
+        if (i % 500 >= 490 && !trace.empty()) {
+            pos.x = trace.back().x + noise(random) * 0.1;
+            pos.y = trace.back().y + noise(random) * 0.1;
+        }
+        trace.push_back(pos);
+    }
+    return trace;
+}
+
+auto stabilize(Base& stabilizer) -> std::vector<Point> {
+    static const std::vector<PositionInputData> trace = createTrace();
+
+    StrokeOutput output;
+    stabilizer.initialize(&output, 1.0, trace.front());
+    for (size_t i = 1; i < trace.size(); i++) { stabilizer.processEvent(trace[i]); }
+    stabilizer.finalizeStroke();
+    return output.getStroke()->getPointVector();
+}
+
+/**
+ * @param tolerance Maximal difference of the coordinates and the pressure, in px
+ */
+void expectSameStroke(Base&& stabilizer, Base&& reference, double tolerance) {
+    std::vector<Point> points = stabilize(stabilizer);
+    std::vector<Point> expected = stabilize(reference);
+
+    ASSERT_EQ(expected.size(), points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        EXPECT_NEAR(expected[i].x, points[i].x, tolerance) << "Point " << i;
+        EXPECT_NEAR(expected[i].y, points[i].y, tolerance) << "Point " << i;
+        EXPECT_NEAR(expected[i].z, points[i].z, tolerance) << "Point " << i;
+    }
+}
+
+// Defaults of the Settings
+constexpr size_t BUFFER_SIZE = 20;
+constexpr double SIGMA = 0.5;
+constexpr double DEADZONE_RADIUS = 1.3;
+constexpr double DRAG = 0.4;
+constexpr double MASS = 5.0;
+
+/**
+ * The running sum is only rounded differently than the full sum
+ */
+constexpr double ARITHMETIC_TOLERANCE = 1e-9;
+
+/**
+ * The interpolated exp table differs from std::exp by up to 2e-6 px on the positions
+ */
+constexpr double GAUSSIAN_TOLERANCE = 1e-5;
+}  // namespace
+
+TEST(StrokeStabilizer, testArithmeticMatchesReference) {
+    expectSameStroke(Arithmetic(true, BUFFER_SIZE), ReferenceArithmetic(true, BUFFER_SIZE), ARITHMETIC_TOLERANCE);
+    expectSameStroke(ArithmeticDeadzone(true, BUFFER_SIZE, DEADZONE_RADIUS, true),
+                     ReferenceHybrid<ReferenceArithmetic, Deadzone>(true, BUFFER_SIZE, DEADZONE_RADIUS, true),
+                     ARITHMETIC_TOLERANCE);
+    expectSameStroke(ArithmeticInertia(true, BUFFER_SIZE, DRAG, MASS),
+                     ReferenceHybrid<ReferenceArithmetic, Inertia>(true, BUFFER_SIZE, DRAG, MASS),
+                     ARITHMETIC_TOLERANCE);
+}
+
+TEST(StrokeStabilizer, testVelocityGaussianMatchesReference) {
+    expectSameStroke(VelocityGaussian(true, SIGMA), ReferenceVelocityGaussian(true, SIGMA), GAUSSIAN_TOLERANCE);
+    expectSameStroke(VelocityGaussianDeadzone(true, SIGMA, DEADZONE_RADIUS, true),
+                     ReferenceHybrid<ReferenceVelocityGaussian, Deadzone>(true, SIGMA, DEADZONE_RADIUS, true),
+                     GAUSSIAN_TOLERANCE);
+    expectSameStroke(VelocityGaussianInertia(true, SIGMA, DRAG, MASS),
+                     ReferenceHybrid<ReferenceVelocityGaussian, Inertia>(true, SIGMA, DRAG, MASS),
+                     GAUSSIAN_TOLERANCE);
+}
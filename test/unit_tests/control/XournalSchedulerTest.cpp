@@ -0,0 +1,146 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "control/jobs/XournalScheduler.h"
+
+namespace {
+/**
+ * The state of a WaitingJob, kept by the test because the scheduler frees the job
+ */
+struct Gate {
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool released = false;
+    std::atomic<bool> started = false;
+    std::atomic<bool> finished = false;
+    std::atomic<bool> deleted = false;
+
+    void release() {
+        {
+            std::lock_guard lock(mutex);
+            released = true;
+        }
+        condition.notify_all();
+    }
+
+    static void waitFor(const std::atomic<bool>& flag) {
+        auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!flag && std::chrono::steady_clock::now() < timeout) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ASSERT_TRUE(flag);
+    }
+};
+
+/**
+ * Runs until its gate is released, stands in for a SelectionRenderJob or e.g. a running save
+ */
+class WaitingJob: public Job {
+public:
+    WaitingJob(void* source, JobType type, Gate& gate): source(source), type(type), gate(gate) {}
+
+    void* getSource() override { return this->source; }
+    JobType getType() override { return this->type; }
+
+protected:
+    void onDelete() override { this->gate.deleted = true; }
+
+    void run() override {
+        this->gate.started = true;
+        std::unique_lock lock(this->gate.mutex);
+        this->gate.condition.wait(lock, [this]() { return this->gate.released; });
+        this->gate.finished = true;
+    }
+
+private:
+    void* source;
+    JobType type;
+    Gate& gate;
+};
+
+void addJob(XournalScheduler& scheduler, void* source, JobType type, JobPriority priority, Gate& gate) {
+    auto* job = new WaitingJob(source, type, gate);
+    scheduler.addJob(job, priority);
+    job->unref();
+}
+
+/**
+ * removeSelection() only compares the pointer, the selection is never accessed
+ */
+auto asSelection(int& token) -> EditSelectionContents* { return reinterpret_cast<EditSelectionContents*>(&token); }
+}  // namespace
+
+TEST(XournalScheduler, testCancelSelectionWhileRendering) {
+    XournalScheduler scheduler;
+    scheduler.start();
+
+    int selection = 0;
+    Gate running;
+    Gate queued;
+    addJob(scheduler, asSelection(selection), JOB_TYPE_RENDER, JOB_PRIORITY_URGENT, running);
+    Gate::waitFor(running.started);
+
+    // A second job for the same selection has to wait for the running one
+    addJob(scheduler, asSelection(selection), JOB_TYPE_RENDER, JOB_PRIORITY_URGENT, queued);
+
+    std::atomic<bool> removed = false;
+    std::thread cancel([&]() {
+        scheduler.removeSelection(asSelection(selection));
+        removed = true;
+    });
+
+    // The queued job is dropped at once, but the running job may still use the selection, so the cancel waits for it
+    Gate::waitFor(queued.deleted);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(removed);
+
+    running.release();
+    cancel.join();
+    EXPECT_TRUE(removed);
+    EXPECT_TRUE(running.finished);
+
+    scheduler.stop();
+    EXPECT_FALSE(queued.started);
+}
+
+TEST(XournalScheduler, testCancelSelectionDoesNotWaitForOtherJobs) {
+    XournalScheduler scheduler;
+    scheduler.start();
+
+    int selection = 0;
+    int otherSelection = 0;
+    int document = 0;
+    Gate save;
+    Gate otherRender;
+    addJob(scheduler, &document, JOB_TYPE_BLOCKING, JOB_PRIORITY_NONE, save);
+    Gate::waitFor(save.started);
+
+    // Runs on a render thread, the job thread is busy with the save
+    addJob(scheduler, asSelection(otherSelection), JOB_TYPE_RENDER, JOB_PRIORITY_URGENT, otherRender);
+    Gate::waitFor(otherRender.started);
+
+    auto cancel = std::async(std::launch::async, [&]() { scheduler.removeSelection(asSelection(selection)); });
+    EXPECT_EQ(std::future_status::ready, cancel.wait_for(std::chrono::seconds(5)));
+
+    save.release();
+    otherRender.release();
+    cancel.wait();
+    scheduler.stop();
+}
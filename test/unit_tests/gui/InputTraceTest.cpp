@@ -0,0 +1,146 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <fstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gui/inputdevices/InputTrace.h"
+#include "util/PathUtil.h"
+
+#include "filesystem.h"
+
+namespace {
+auto createEvent(InputEventType type, InputDeviceClass deviceClass, double x, double y) -> InputEvent {
+    InputEvent event{};
+    event.type = type;
+    event.deviceClass = deviceClass;
+    event.deviceName = const_cast<gchar*>("Wacom Pen stylus");
+    event.absoluteX = x + 100;
+    event.absoluteY = y + 200;
+    event.relativeX = x;
+    event.relativeY = y;
+    event.pressure = 0.1 + x / 1000.0;
+    event.timestamp = 1000 + static_cast<guint32>(x);
+    return event;
+}
+}  // namespace
+
+TEST(InputTrace, testRoundTrip) {
+    fs::path file = Util::getTmpDirSubfolder("input-trace") / "trace.txt";
+
+    auto* firstTouch = reinterpret_cast<GdkEventSequence*>(0x1000);
+    auto* secondTouch = reinterpret_cast<GdkEventSequence*>(0x2000);
+    {
+        InputTraceWriter writer(file);
+        ASSERT_TRUE(writer.isOpen());
+
+        InputEvent press = createEvent(BUTTON_PRESS_EVENT, INPUT_DEVICE_PEN, 10.125, 20.75);
+        press.button = 1;
+        press.state = GDK_SHIFT_MASK;
+        writer.write(press);
+        writer.write(createEvent(MOTION_EVENT, INPUT_DEVICE_PEN, 1.0 / 3.0, 2.0 / 3.0));
+
+        InputEvent touch = createEvent(BUTTON_PRESS_EVENT, INPUT_DEVICE_TOUCHSCREEN, 5, 5);
+        touch.sequence = firstTouch;
+        writer.write(touch);
+        touch.sequence = secondTouch;
+        writer.write(touch);
+        touch.type = BUTTON_RELEASE_EVENT;
+        touch.sequence = firstTouch;
+        writer.write(touch);
+        // The pointer of the ended touch is reused by GDK
+        touch.type = BUTTON_PRESS_EVENT;
+        writer.write(touch);
+    }
+
+    std::vector<InputTraceEvent> events;
+    ASSERT_TRUE(InputTrace::read(file, events));
+    ASSERT_EQ(6U, events.size());
+
+    EXPECT_EQ(BUTTON_PRESS_EVENT, events[0].type);
+    EXPECT_EQ(INPUT_DEVICE_PEN, events[0].deviceClass);
+    EXPECT_EQ("Wacom Pen stylus", events[0].deviceName);
+    EXPECT_EQ(10.125, events[0].relativeX);
+    EXPECT_EQ(20.75, events[0].relativeY);
+    EXPECT_EQ(110.125, events[0].absoluteX);
+    EXPECT_EQ(220.75, events[0].absoluteY);
+    EXPECT_EQ(1U, events[0].button);
+    EXPECT_EQ(static_cast<guint>(GDK_SHIFT_MASK), events[0].state);
+    EXPECT_EQ(1010U, events[0].timestamp);
+    EXPECT_EQ(0U, events[0].sequence);
+
+    // Doubles are stored exactly
+    EXPECT_EQ(MOTION_EVENT, events[1].type);
+    EXPECT_EQ(1.0 / 3.0, events[1].relativeX);
+    EXPECT_EQ(2.0 / 3.0, events[1].relativeY);
+    EXPECT_EQ(0.1 + (1.0 / 3.0) / 1000.0, events[1].pressure);
+
+    EXPECT_EQ(1U, events[2].sequence);
+    EXPECT_EQ(2U, events[3].sequence);
+    EXPECT_EQ(1U, events[4].sequence);
+    EXPECT_EQ(3U, events[5].sequence);
+}
+
+TEST(InputTrace, testToInputEvent) {
+    InputTraceEvent traceEvent;
+    traceEvent.type = MOTION_EVENT;
+    traceEvent.deviceClass = INPUT_DEVICE_TOUCHSCREEN;
+    traceEvent.deviceName = "Touchscreen";
+    traceEvent.relativeX = 12.5;
+    traceEvent.relativeY = 7.25;
+    traceEvent.pressure = 0.5;
+    traceEvent.sequence = 2;
+    traceEvent.timestamp = 42;
+
+    InputEvent event = traceEvent.toInputEvent();
+    ASSERT_TRUE(event);
+    EXPECT_EQ(GDK_MOTION_NOTIFY, static_cast<GdkEvent*>(event.sourceEvent)->type);
+    EXPECT_EQ(MOTION_EVENT, event.type);
+    EXPECT_EQ(INPUT_DEVICE_TOUCHSCREEN, event.deviceClass);
+    EXPECT_STREQ("Touchscreen", event.deviceName);
+    EXPECT_EQ(12.5, event.relativeX);
+    EXPECT_EQ(7.25, event.relativeY);
+    EXPECT_EQ(0.5, event.pressure);
+    EXPECT_EQ(42U, event.timestamp);
+
+    // The same sequence number always maps to the same sequence
+    EXPECT_NE(nullptr, event.sequence);
+    EXPECT_EQ(event.sequence, traceEvent.toInputEvent().sequence);
+    traceEvent.sequence = 0;
+    EXPECT_EQ(nullptr, traceEvent.toInputEvent().sequence);
+
+    traceEvent.type = KEY_PRESS_EVENT;
+    traceEvent.deviceClass = INPUT_DEVICE_KEYBOARD;
+    traceEvent.button = GDK_KEY_Left;
+    traceEvent.state = GDK_SHIFT_MASK;
+    InputEvent key = traceEvent.toInputEvent();
+    auto* keyEvent = reinterpret_cast<GdkEventKey*>(static_cast<GdkEvent*>(key.sourceEvent));
+    EXPECT_EQ(GDK_KEY_PRESS, keyEvent->type);
+    EXPECT_EQ(static_cast<guint>(GDK_KEY_Left), keyEvent->keyval);
+    EXPECT_EQ(static_cast<guint>(GDK_SHIFT_MASK), keyEvent->state);
+}
+
+TEST(InputTrace, testInvalidFile) {
+    fs::path folder = Util::getTmpDirSubfolder("input-trace");
+    std::vector<InputTraceEvent> events;
+    EXPECT_FALSE(InputTrace::read(folder / "missing.txt", events));
+
+    fs::path file = folder / "invalid.txt";
+    {
+        std::ofstream out(file);
+        out << "xournalpp-input-trace 1\n"
+            << "5\t1\t0\t0\t1\t2\t0\t0\t0.5\t0\t10\tPen\n"
+            << "99\t1\t0\t0\t1\t2\t0\t0\t0.5\t0\t11\tPen\n";
+    }
+    EXPECT_FALSE(InputTrace::read(file, events));
+}
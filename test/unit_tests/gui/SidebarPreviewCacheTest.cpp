@@ -0,0 +1,149 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cstdint>
+
+#include <cairo.h>
+#include <gtest/gtest.h>
+
+#include "gui/sidebar/previews/base/SidebarPreviewCache.h"
+
+namespace {
+auto createPreview(int width, int height, double gray) -> cairo_surface_t* {
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+    cairo_t* cr = cairo_create(surface);
+    cairo_set_source_rgb(cr, gray, gray, gray);
+    cairo_paint(cr);
+    cairo_set_source_rgb(cr, 0, 0, 0);
+    cairo_rectangle(cr, 5, 5, 10, 20);
+    cairo_fill(cr);
+    cairo_destroy(cr);
+    cairo_surface_flush(surface);
+    return surface;
+}
+
+auto pixel(cairo_surface_t* surface, int x, int y) -> uint32_t {
+    const unsigned char* data = cairo_image_surface_get_data(surface);
+    return *reinterpret_cast<const uint32_t*>(data + y * cairo_image_surface_get_stride(surface) + x * 4);
+}
+}  // namespace
+
+TEST(SidebarPreviewCache, testStoreAndTake) {
+    SidebarPreviewCache cache(1024 * 1024);
+    int key = 0;
+
+    cairo_surface_t* preview = createPreview(90, 130, 1.0);
+    cache.store(&key, preview);
+    cache.flush();
+    EXPECT_GT(cache.getSize(), 0U);
+
+    // Compressed in the background, much smaller than the raw image
+    EXPECT_LT(cache.getSize(), 90U * 130U);
+
+    cairo_surface_t* restored = cache.take(&key);
+    ASSERT_NE(nullptr, restored);
+    ASSERT_EQ(90, cairo_image_surface_get_width(restored));
+    ASSERT_EQ(130, cairo_image_surface_get_height(restored));
+    EXPECT_EQ(pixel(preview, 0, 0), pixel(restored, 0, 0));
+    EXPECT_EQ(pixel(preview, 10, 10), pixel(restored, 10, 10));
+
+    // Taken previews are removed
+    EXPECT_EQ(nullptr, cache.take(&key));
+    EXPECT_EQ(0U, cache.getSize());
+
+    cairo_surface_destroy(preview);
+    cairo_surface_destroy(restored);
+}
+
+TEST(SidebarPreviewCache, testTakeBeforeCompression) {
+    SidebarPreviewCache cache(1024 * 1024);
+    int key = 0;
+
+    cairo_surface_t* preview = createPreview(90, 130, 0.8);
+    cache.store(&key, preview);
+
+    // Whether it is compressed yet or not, the same preview is returned
+    cairo_surface_t* restored = cache.take(&key);
+    ASSERT_NE(nullptr, restored);
+    EXPECT_EQ(pixel(preview, 0, 0), pixel(restored, 0, 0));
+    EXPECT_EQ(pixel(preview, 10, 10), pixel(restored, 10, 10));
+
+    cache.flush();
+    EXPECT_EQ(0U, cache.getSize());
+
+    cairo_surface_destroy(preview);
+    cairo_surface_destroy(restored);
+}
+
+TEST(SidebarPreviewCache, testEvictsLeastRecentlyStored) {
+    int keys[3] = {};
+    cairo_surface_t* preview = createPreview(90, 130, 0.9);
+    size_t rawSize = cairo_image_surface_get_stride(preview) * 130U;
+
+    SidebarPreviewCache probe(1024 * 1024);
+    probe.store(&keys[0], preview);
+    probe.flush();
+    size_t size = probe.getSize();
+
+    // Space for two compressed previews, one of them may still be raw
+    SidebarPreviewCache cache(rawSize + size + size / 2);
+    for (int& key: keys) {
+        cache.store(&key, preview);
+        cache.flush();
+    }
+    EXPECT_EQ(2 * size, cache.getSize());
+
+    EXPECT_EQ(nullptr, cache.take(&keys[0]));
+
+    cairo_surface_t* restored = cache.take(&keys[2]);
+    EXPECT_NE(nullptr, restored);
+    cairo_surface_destroy(restored);
+
+    // Storing a key again replaces its preview
+    cache.store(&keys[1], preview);
+    cache.flush();
+    EXPECT_EQ(size, cache.getSize());
+
+    cache.remove(&keys[1]);
+    EXPECT_EQ(0U, cache.getSize());
+
+    cairo_surface_destroy(preview);
+}
+
+TEST(SidebarPreviewCache, testRestoresTransparentPixelsExactly) {
+    SidebarPreviewCache cache(1024 * 1024);
+    int key = 0;
+
+    // Premultiplied colors which do not survive a round trip through straight alpha, like in a PNG
+    cairo_surface_t* preview = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 64, 64);
+    cairo_t* cr = cairo_create(preview);
+    cairo_set_source_rgba(cr, 0.3, 0.6, 0.9, 0.07);
+    cairo_paint(cr);
+    cairo_set_source_rgba(cr, 0.9, 0.1, 0.5, 0.45);
+    cairo_rectangle(cr, 10, 10, 30, 30);
+    cairo_fill(cr);
+    cairo_destroy(cr);
+    cairo_surface_flush(preview);
+
+    cache.store(&key, preview);
+    cache.flush();
+    cairo_surface_t* restored = cache.take(&key);
+    ASSERT_NE(nullptr, restored);
+    ASSERT_EQ(CAIRO_FORMAT_ARGB32, cairo_image_surface_get_format(restored));
+    ASSERT_EQ(cairo_image_surface_get_stride(preview), cairo_image_surface_get_stride(restored));
+
+    for (int y = 0; y < 64; y++) {
+        for (int x = 0; x < 64; x++) { ASSERT_EQ(pixel(preview, x, y), pixel(restored, x, y)) << x << ", " << y; }
+    }
+
+    cairo_surface_destroy(preview);
+    cairo_surface_destroy(restored);
+}
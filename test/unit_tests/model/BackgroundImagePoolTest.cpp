@@ -0,0 +1,86 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+#include <string>
+
+#include <cairo.h>
+#include <gtest/gtest.h>
+
+#include "model/BackgroundImagePool.h"
+
+namespace {
+auto encodePng(int width, int height) -> std::string {
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_RGB24, width, height);
+    std::string png;
+    cairo_surface_write_to_png_stream(
+            surface,
+            [](void* closure, const unsigned char* data, unsigned int length) {
+                static_cast<std::string*>(closure)->append(reinterpret_cast<const char*>(data), length);
+                return CAIRO_STATUS_SUCCESS;
+            },
+            &png);
+    cairo_surface_destroy(surface);
+    return png;
+}
+}  // namespace
+
+TEST(BackgroundImagePool, testSharedDecoding) {
+    auto& pool = BackgroundImagePool::getInstance();
+
+    std::string png = encodePng(40, 30);
+    auto first = pool.get(png, nullptr);
+    auto second = pool.get(std::string(png), nullptr);
+    ASSERT_NE(nullptr, first);
+    EXPECT_EQ(first, second);
+
+    EXPECT_EQ(40, first->getWidth());
+    EXPECT_EQ(30, first->getHeight());
+    EXPECT_EQ(CAIRO_FORMAT_ARGB32, cairo_image_surface_get_format(first->getSurface()));
+    EXPECT_EQ(40, cairo_image_surface_get_width(first->getSurface()));
+
+    // Only the surface is kept, a pixbuf is converted on request
+    GdkPixbuf* pixbuf = first->createPixbuf();
+    ASSERT_NE(nullptr, pixbuf);
+    EXPECT_EQ(40, gdk_pixbuf_get_width(pixbuf));
+    EXPECT_EQ(30, gdk_pixbuf_get_height(pixbuf));
+    g_object_unref(pixbuf);
+
+    auto other = pool.get(encodePng(20, 30), nullptr);
+    ASSERT_NE(nullptr, other);
+    EXPECT_NE(first, other);
+}
+
+TEST(BackgroundImagePool, testRelease) {
+    auto& pool = BackgroundImagePool::getInstance();
+
+    std::string png = encodePng(16, 16);
+    auto image = pool.get(png, nullptr);
+    ASSERT_NE(nullptr, image);
+    EXPECT_EQ(BackgroundImagePool::hash(png), image->getHash());
+
+    // The pool does not keep the image alive
+    std::weak_ptr<const DecodedBackgroundImage> released = image;
+    image.reset();
+    EXPECT_TRUE(released.expired());
+
+    // So it is decoded again
+    auto again = pool.get(png, nullptr);
+    ASSERT_NE(nullptr, again);
+    EXPECT_EQ(16, again->getWidth());
+}
+
+TEST(BackgroundImagePool, testInvalidData) {
+    GError* error = nullptr;
+    EXPECT_EQ(nullptr, BackgroundImagePool::getInstance().get("no image", &error));
+    ASSERT_NE(nullptr, error);
+    g_error_free(error);
+}
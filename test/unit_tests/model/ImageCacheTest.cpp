@@ -0,0 +1,138 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <string>
+
+#include <cairo.h>
+#include <gtest/gtest.h>
+
+#include "model/ImageCache.h"
+#include "util/RasterCache.h"
+
+namespace {
+auto encodePng(int width, int height) -> std::string {
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+    std::string png;
+    cairo_surface_write_to_png_stream(
+            surface,
+            [](void* closure, const unsigned char* data, unsigned int length) {
+                static_cast<std::string*>(closure)->append(reinterpret_cast<const char*>(data), length);
+                return CAIRO_STATUS_SUCCESS;
+            },
+            &png);
+    cairo_surface_destroy(surface);
+    return png;
+}
+}  // namespace
+
+TEST(ImageCache, testLevel) {
+    EXPECT_EQ(0, ImageCache::getLevel(1000, 800, 1000, 800));
+    EXPECT_EQ(0, ImageCache::getLevel(1000, 800, 2000, 1600));
+    EXPECT_EQ(1, ImageCache::getLevel(1000, 800, 500, 400));
+    EXPECT_EQ(1, ImageCache::getLevel(1000, 800, 300, 300));
+    EXPECT_EQ(3, ImageCache::getLevel(1000, 800, 100, 100));
+}
+
+TEST(ImageCache, testMipLevels) {
+    ImageCache& cache = ImageCache::getInstance();
+    cache.clear();
+
+    std::string png = encodePng(400, 200);
+    size_t id = ImageCache::createId();
+
+    cairo_surface_t* full = cache.get(id, png, 400, 200);
+    ASSERT_NE(nullptr, full);
+    EXPECT_EQ(400, cairo_image_surface_get_width(full));
+    EXPECT_EQ(200, cairo_image_surface_get_height(full));
+
+    cairo_surface_t* small = cache.get(id, png, 90, 40);
+    ASSERT_NE(nullptr, small);
+    EXPECT_EQ(100, cairo_image_surface_get_width(small));
+    EXPECT_EQ(50, cairo_image_surface_get_height(small));
+
+    // Shared until the data is removed
+    cairo_surface_t* again = cache.get(id, png, 90, 40);
+    EXPECT_EQ(small, again);
+
+    cache.remove(id);
+    EXPECT_EQ(0U, cache.getMemoryUsage());
+
+    cairo_surface_destroy(full);
+    cairo_surface_destroy(small);
+    cairo_surface_destroy(again);
+}
+
+TEST(ImageCache, testMemoryLimit) {
+    ImageCache& cache = ImageCache::getInstance();
+    cache.clear();
+    RasterBudget::getInstance().setMemoryLimit(250 * 250 * 4);
+
+    std::string png1 = encodePng(200, 200);
+    std::string png2 = encodePng(200, 200);
+
+    cairo_surface_destroy(cache.get(ImageCache::createId(), png1, 200, 200));
+    cairo_surface_destroy(cache.get(ImageCache::createId(), png2, 200, 200));
+
+    // Only the most recently used image fits
+    EXPECT_EQ(200U * 200U * 4U, cache.getMemoryUsage());
+
+    cache.clear();
+    RasterBudget::getInstance().setMemoryLimit(RasterBudget::DEFAULT_MEMORY_LIMIT);
+}
+
+TEST(ImageCache, testInvalidData) {
+    std::string invalid = "not a png";
+    EXPECT_EQ(nullptr, ImageCache::getInstance().get(ImageCache::createId(), invalid, 10, 10));
+}
+
+TEST(ImageCache, testWithoutDecode) {
+    ImageCache& cache = ImageCache::getInstance();
+    cache.clear();
+
+    std::string png = encodePng(400, 200);
+    size_t id = ImageCache::createId();
+
+    // Nothing cached yet
+    EXPECT_EQ(nullptr, cache.get(id, png, 100, 50, false));
+    EXPECT_EQ(0U, cache.getMemoryUsage());
+
+    // Only the small level fits, the full resolution is dropped
+    RasterBudget::getInstance().setMemoryLimit(100 * 1024);
+    cairo_surface_t* small = cache.get(id, png, 100, 50);
+    ASSERT_NE(nullptr, small);
+    EXPECT_EQ(100, cairo_image_surface_get_width(small));
+
+    // A smaller level is better than nothing
+    cairo_surface_t* large = cache.get(id, png, 400, 200, false);
+    EXPECT_EQ(small, large);
+
+    cache.remove(id);
+    EXPECT_EQ(nullptr, cache.get(id, png, 100, 50, false));
+
+    cairo_surface_destroy(small);
+    cairo_surface_destroy(large);
+    RasterBudget::getInstance().setMemoryLimit(RasterBudget::DEFAULT_MEMORY_LIMIT);
+}
+
+TEST(ImageCache, testIdsAreNotReused) {
+    ImageCache& cache = ImageCache::getInstance();
+    cache.clear();
+
+    std::string png = encodePng(40, 20);
+    size_t id = ImageCache::createId();
+    cairo_surface_destroy(cache.get(id, png, 40, 20));
+    cache.remove(id);
+
+    // Data allocated at the same address does not get the surfaces of the removed image
+    size_t other = ImageCache::createId();
+    EXPECT_NE(id, other);
+    EXPECT_EQ(nullptr, cache.get(other, png, 40, 20, false));
+}
@@ -0,0 +1,63 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <gtest/gtest.h>
+
+#include "model/Layer.h"
+#include "model/Stroke.h"
+
+TEST(Layer, testRevisionChangesWithContent) {
+    Layer layer;
+    size_t revision = layer.getRevision();
+
+    auto* s1 = new Stroke();
+    auto* s2 = new Stroke();
+
+    layer.addElement(s1);
+    EXPECT_NE(revision, layer.getRevision());
+    revision = layer.getRevision();
+
+    layer.insertElement(s2, 0);
+    EXPECT_NE(revision, layer.getRevision());
+    revision = layer.getRevision();
+
+    layer.removeElement(s2, true);
+    EXPECT_NE(revision, layer.getRevision());
+    revision = layer.getRevision();
+
+    layer.markChanged();
+    EXPECT_NE(revision, layer.getRevision());
+}
+
+TEST(Layer, testRevisionChangesWithVisibility) {
+    Layer layer;
+    size_t revision = layer.getRevision();
+
+    layer.setVisible(true);
+    EXPECT_EQ(revision, layer.getRevision());
+
+    layer.setVisible(false);
+    EXPECT_NE(revision, layer.getRevision());
+}
+
+TEST(Layer, testIdIsNotReused) {
+    auto* first = new Layer();
+    size_t id = first->getId();
+    delete first;
+
+    // Even if the allocation reuses the address of the deleted layer
+    Layer second;
+    EXPECT_NE(id, second.getId());
+
+    Layer* copy = second.clone();
+    EXPECT_NE(second.getId(), copy->getId());
+    delete copy;
+}
@@ -0,0 +1,72 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include "model/Stroke.h"
+
+namespace {
+auto createStroke() -> Stroke {
+    Stroke stroke;
+    stroke.setWidth(2);
+    stroke.addPoint(Point(10, 10, 1.5));
+    stroke.addPoint(Point(30, 15, 2));
+    stroke.addPoint(Point(25, 40, 1));
+    return stroke;
+}
+}  // namespace
+
+TEST(Stroke, testTransformMatchesSequentialOperations) {
+    Stroke expected = createStroke();
+    expected.move(5, -3);
+    expected.scale(15, 7, 2, 0.5, 0, false);
+    expected.rotate(20, 20, M_PI / 3);
+
+    cairo_matrix_t matrix;
+    cairo_matrix_init_translate(&matrix, 5, -3);
+    cairo_matrix_t scaleMatrix;
+    cairo_matrix_init_translate(&scaleMatrix, 15, 7);
+    cairo_matrix_scale(&scaleMatrix, 2, 0.5);
+    cairo_matrix_translate(&scaleMatrix, -15, -7);
+    cairo_matrix_multiply(&matrix, &matrix, &scaleMatrix);
+    cairo_matrix_t rotMatrix;
+    cairo_matrix_init_translate(&rotMatrix, 20, 20);
+    cairo_matrix_rotate(&rotMatrix, M_PI / 3);
+    cairo_matrix_translate(&rotMatrix, -20, -20);
+    cairo_matrix_multiply(&matrix, &matrix, &rotMatrix);
+
+    Stroke actual = createStroke();
+    actual.transform(matrix, 1);
+
+    ASSERT_EQ(expected.getPointCount(), actual.getPointCount());
+    for (int i = 0; i < expected.getPointCount(); i++) {
+        EXPECT_NEAR(expected.getPoint(i).x, actual.getPoint(i).x, 1e-9);
+        EXPECT_NEAR(expected.getPoint(i).y, actual.getPoint(i).y, 1e-9);
+    }
+    EXPECT_NEAR(expected.getX(), actual.getX(), 1e-9);
+    EXPECT_NEAR(expected.getY(), actual.getY(), 1e-9);
+    EXPECT_NEAR(expected.getElementWidth(), actual.getElementWidth(), 1e-9);
+    EXPECT_NEAR(expected.getElementHeight(), actual.getElementHeight(), 1e-9);
+}
+
+TEST(Stroke, testTransformScalesWidth) {
+    Stroke stroke = createStroke();
+    cairo_matrix_t matrix;
+    cairo_matrix_init_scale(&matrix, 2, 2);
+    stroke.transform(matrix, 2);
+
+    EXPECT_DOUBLE_EQ(4, stroke.getWidth());
+    EXPECT_DOUBLE_EQ(3, stroke.getPoint(0).z);
+    EXPECT_DOUBLE_EQ(20, stroke.getPoint(0).x);
+    EXPECT_DOUBLE_EQ(80, stroke.getPoint(2).y);
+}
@@ -0,0 +1,81 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <string>
+
+#include <cairo-pdf.h>
+#include <cairo.h>
+#include <gtest/gtest.h>
+
+#include "model/TexImage.h"
+
+namespace {
+/**
+ * @return A one page PDF of the given size, like a rendered formula
+ */
+auto createPdf(double width, double height) -> std::string {
+    std::string pdf;
+    cairo_surface_t* surface = cairo_pdf_surface_create_for_stream(
+            [](void* closure, const unsigned char* data, unsigned int length) {
+                static_cast<std::string*>(closure)->append(reinterpret_cast<const char*>(data), length);
+                return CAIRO_STATUS_SUCCESS;
+            },
+            &pdf, width, height);
+    cairo_t* cr = cairo_create(surface);
+    cairo_rectangle(cr, 2, 2, width - 4, height - 4);
+    cairo_fill(cr);
+    cairo_destroy(cr);
+    cairo_surface_finish(surface);
+    cairo_surface_destroy(surface);
+    return pdf;
+}
+}  // namespace
+
+TEST(TexImage, testRasterIsReusedWithinZoomBucket) {
+    TexImage img;
+    ASSERT_TRUE(img.loadData(createPdf(40, 20)));
+    ASSERT_NE(nullptr, img.getPdfPage());
+
+    cairo_surface_t* a = img.getRaster(80, 40);
+    ASSERT_NE(nullptr, a);
+    EXPECT_GE(cairo_image_surface_get_width(a), 80);
+    EXPECT_GE(cairo_image_surface_get_height(a), 40);
+
+    // Almost the same zoom, same bucket
+    cairo_surface_t* b = img.getRaster(79, 39.5);
+    EXPECT_EQ(a, b);
+
+    // Another zoom
+    cairo_surface_t* c = img.getRaster(160, 80);
+    EXPECT_NE(a, c);
+    EXPECT_GE(cairo_image_surface_get_width(c), 160);
+
+    cairo_surface_destroy(a);
+    cairo_surface_destroy(b);
+    cairo_surface_destroy(c);
+}
+
+TEST(TexImage, testRasterInvalidatedOnNewData) {
+    TexImage img;
+    ASSERT_TRUE(img.loadData(createPdf(40, 20)));
+
+    cairo_surface_t* before = img.getRaster(80, 40);
+    ASSERT_NE(nullptr, before);
+    int heightBefore = cairo_image_surface_get_height(before);
+
+    ASSERT_TRUE(img.loadData(createPdf(40, 40)));
+    cairo_surface_t* after = img.getRaster(80, 80);
+    ASSERT_NE(nullptr, after);
+    EXPECT_GT(cairo_image_surface_get_height(after), heightBefore);
+
+    cairo_surface_destroy(before);
+    cairo_surface_destroy(after);
+}
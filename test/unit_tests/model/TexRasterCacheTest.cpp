@@ -0,0 +1,49 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cairo.h>
+#include <gtest/gtest.h>
+
+#include "model/TexImage.h"
+#include "model/TexRasterCache.h"
+#include "util/RasterCache.h"
+
+TEST(TexRasterCache, testEvictsLeastRecentlyUsed) {
+    TexRasterCache& cache = TexRasterCache::getInstance();
+    cache.clear();
+
+    TexImage a;
+    TexImage b;
+    cairo_surface_t* raster = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 64, 64);
+    size_t size = 64 * 64 * 4;
+
+    // Space for two rasters
+    RasterBudget::getInstance().setMemoryLimit(2 * size + size / 2);
+    cache.insert(&a, 0, 0, raster);
+    cache.insert(&a, 1, 1, raster);
+
+    cairo_surface_t* used = cache.get(&a, 0, 0);
+    EXPECT_EQ(raster, used);
+    cairo_surface_destroy(used);
+
+    cache.insert(&b, 0, 0, raster);
+    EXPECT_EQ(2 * size, cache.getMemoryUsage());
+    EXPECT_EQ(nullptr, cache.get(&a, 1, 1));
+
+    // Removing an image drops all its rasters
+    cache.remove(&a);
+    EXPECT_EQ(nullptr, cache.get(&a, 0, 0));
+    EXPECT_EQ(size, cache.getMemoryUsage());
+
+    cache.clear();
+    RasterBudget::getInstance().setMemoryLimit(RasterBudget::DEFAULT_MEMORY_LIMIT);
+    cairo_surface_destroy(raster);
+}
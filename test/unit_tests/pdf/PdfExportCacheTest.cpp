@@ -0,0 +1,95 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+#include "model/Layer.h"
+#include "model/PageRef.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "pdf/base/PdfExportCache.h"
+
+#include "filesystem.h"
+
+namespace {
+auto createPage() -> PageRef {
+    PageRef page = std::make_shared<XojPage>(595, 842);
+    page->addLayer(new Layer());
+    return page;
+}
+}  // namespace
+
+TEST(PdfExportCache, testHashIsStable) {
+    PageRef a = createPage();
+    PageRef b = createPage();
+    EXPECT_EQ(PdfExportCache::hashPage(a), PdfExportCache::hashPage(b));
+    EXPECT_EQ(PdfExportCache::hashPage(a), PdfExportCache::hashPage(a));
+}
+
+TEST(PdfExportCache, testHashChangesWithContent) {
+    PageRef page = createPage();
+    std::string empty = PdfExportCache::hashPage(page);
+
+    auto* stroke = new Stroke();
+    stroke->addPoint(Point(10, 10));
+    stroke->addPoint(Point(20, 20));
+    (*page->getLayers())[0]->addElement(stroke);
+    std::string withStroke = PdfExportCache::hashPage(page);
+    EXPECT_NE(empty, withStroke);
+
+    stroke->addPoint(Point(30, 20));
+    EXPECT_NE(withStroke, PdfExportCache::hashPage(page));
+}
+
+TEST(PdfExportCache, testHashChangesWithPage) {
+    PageRef page = createPage();
+    std::string hash = PdfExportCache::hashPage(page);
+
+    page->setSize(842, 595);
+    EXPECT_NE(hash, PdfExportCache::hashPage(page));
+    hash = PdfExportCache::hashPage(page);
+
+    (*page->getLayers())[0]->setVisible(false);
+    EXPECT_NE(hash, PdfExportCache::hashPage(page));
+}
+
+TEST(PdfExportCache, testRemoveOldEntries) {
+    gchar* tmp = g_dir_make_tmp("xournalpp-test-XXXXXX", nullptr);
+    ASSERT_NE(nullptr, tmp);
+    fs::path folder = fs::u8path(tmp);
+    g_free(tmp);
+
+    auto now = fs::file_time_type::clock::now();
+    auto createEntry = [&](const std::string& name, std::chrono::hours age) {
+        std::ofstream(folder / name) << "entry";
+        fs::last_write_time(folder / name, now - age);
+    };
+    createEntry("new.cache", std::chrono::hours(1));
+    createEntry("newer.cache", std::chrono::hours(0));
+    createEntry("older.cache", std::chrono::hours(2));
+    createEntry("expired.cache", std::chrono::hours(100));
+    createEntry("other.txt", std::chrono::hours(100));
+
+    PdfExportCache::removeOldEntries(folder, 2, std::chrono::hours(48));
+    EXPECT_TRUE(fs::exists(folder / "newer.cache"));
+    EXPECT_TRUE(fs::exists(folder / "new.cache"));
+    EXPECT_FALSE(fs::exists(folder / "older.cache"));
+    EXPECT_FALSE(fs::exists(folder / "expired.cache"));
+    EXPECT_TRUE(fs::exists(folder / "other.txt"));
+
+    fs::remove_all(folder);
+}
@@ -0,0 +1,74 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <string>
+#include <system_error>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+#include "pdf/base/Qpdf.h"
+
+#include "filesystem.h"
+
+namespace {
+/**
+ * Replaces PATH by an empty folder, so no program is found
+ */
+class QpdfMissing: public ::testing::Test {
+protected:
+    void SetUp() override {
+        const gchar* path = g_getenv("PATH");
+        this->hadPath = path != nullptr;
+        if (path) {
+            this->path = path;
+        }
+
+        gchar* dir = g_dir_make_tmp("xournalpp-qpdf-XXXXXX", nullptr);
+        ASSERT_NE(nullptr, dir);
+        this->emptyDir = fs::u8path(dir);
+        g_free(dir);
+        g_setenv("PATH", this->emptyDir.u8string().c_str(), true);
+    }
+
+    void TearDown() override {
+        if (this->hadPath) {
+            g_setenv("PATH", this->path.c_str(), true);
+        } else {
+            g_unsetenv("PATH");
+        }
+        std::error_code ec;
+        fs::remove_all(this->emptyDir, ec);
+    }
+
+    bool hadPath = false;
+    std::string path;
+    fs::path emptyDir;
+};
+}  // namespace
+
+TEST_F(QpdfMissing, testNotAvailable) { EXPECT_FALSE(Qpdf::isAvailable()); }
+
+TEST_F(QpdfMissing, testRunFails) {
+    std::string error;
+    EXPECT_FALSE(Qpdf::run({"--version"}, error));
+    EXPECT_FALSE(error.empty());
+}
+
+TEST(Qpdf, testRun) {
+    if (!Qpdf::isAvailable()) {
+        GTEST_SKIP() << "qpdf is not installed";
+    }
+
+    std::string error;
+    EXPECT_TRUE(Qpdf::run({"--version"}, error));
+    EXPECT_TRUE(error.empty());
+}
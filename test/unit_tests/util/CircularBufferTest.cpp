@@ -0,0 +1,37 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/CircularBuffer.h"
+
+TEST(CircularBuffer, testFrontAndOldest) {
+    CircularBuffer<int> buffer(3);
+    buffer.assign(0);
+
+    buffer.push_front(1);
+    EXPECT_EQ(1, buffer.front());
+    EXPECT_EQ(0, buffer.oldest());
+
+    buffer.push_front(2);
+    buffer.push_front(3);
+    EXPECT_EQ(3, buffer.front());
+    EXPECT_EQ(1, buffer.oldest());
+
+    // The oldest is the element overwritten next
+    buffer.push_front(4);
+    EXPECT_EQ(4, buffer.front());
+    EXPECT_EQ(2, buffer.oldest());
+    EXPECT_EQ(9, std::accumulate(buffer.begin(), buffer.end(), 0));
+}
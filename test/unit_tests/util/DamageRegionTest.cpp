@@ -0,0 +1,100 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "util/DamageRegion.h"
+
+namespace {
+void expectRect(const Rectangle<double>& r, double x, double y, double width, double height) {
+    EXPECT_DOUBLE_EQ(x, r.x);
+    EXPECT_DOUBLE_EQ(y, r.y);
+    EXPECT_DOUBLE_EQ(width, r.width);
+    EXPECT_DOUBLE_EQ(height, r.height);
+}
+}  // namespace
+
+TEST(UtilDamageRegion, testEmpty) {
+    DamageRegion region;
+    EXPECT_TRUE(region.isEmpty());
+    EXPECT_TRUE(region.getRects().empty());
+
+    region.add({5, 5, 0, 10});
+    EXPECT_TRUE(region.isEmpty());
+}
+
+TEST(UtilDamageRegion, testOverlappingRectsAreRenderedOnce) {
+    DamageRegion region;
+    region.add({0, 0, 10, 10});
+    region.add({5, 5, 10, 10});
+
+    EXPECT_DOUBLE_EQ(175, region.getArea());
+    expectRect(region.getExtents(), 0, 0, 15, 15);
+
+    auto rects = region.getRects();
+    ASSERT_EQ(1U, rects.size());
+    expectRect(rects[0], 0, 0, 15, 15);
+}
+
+TEST(UtilDamageRegion, testAdjacentRectsAreMerged) {
+    DamageRegion region;
+    region.add({0, 0, 10, 10});
+    region.add({10, 0, 10, 10});
+
+    auto rects = region.getRects();
+    ASSERT_EQ(1U, rects.size());
+    expectRect(rects[0], 0, 0, 20, 10);
+}
+
+TEST(UtilDamageRegion, testDistantRectsStaySeparate) {
+    DamageRegion region;
+    region.add({0, 0, 10, 10});
+    region.add({100, 100, 10, 10});
+
+    auto rects = region.getRects();
+    ASSERT_EQ(2U, rects.size());
+    expectRect(rects[0], 0, 0, 10, 10);
+    expectRect(rects[1], 100, 100, 10, 10);
+}
+
+TEST(UtilDamageRegion, testFragmentedRegionFallsBackToExtents) {
+    DamageRegion region;
+    for (int i = 0; i < 20; i++) { region.add({i * 20.0, i * 20.0, 10, 10}); }
+
+    auto rects = region.getRects({}, 0.3, 8);
+    ASSERT_EQ(1U, rects.size());
+    expectRect(rects[0], 0, 0, 390, 390);
+}
+
+TEST(UtilDamageRegion, testRoundingAndClip) {
+    DamageRegion region;
+    region.add({0.5, 0.5, 1, 1});
+    expectRect(region.getExtents(), 0, 0, 2, 2);
+
+    region.add({-10, -10, 30, 30});
+    auto rects = region.getRects({0, 0, 10, 10});
+    ASSERT_EQ(1U, rects.size());
+    expectRect(rects[0], 0, 0, 10, 10);
+}
+
+TEST(UtilDamageRegion, testMove) {
+    DamageRegion region;
+    region.add({0, 0, 10, 10});
+
+    DamageRegion taken = std::move(region);
+    EXPECT_TRUE(region.isEmpty());
+    EXPECT_FALSE(taken.isEmpty());
+
+    region.add({1, 1, 1, 1});
+    EXPECT_DOUBLE_EQ(1, region.getArea());
+}
@@ -0,0 +1,124 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include "util/OutputStream.h"
+#include "util/PathUtil.h"
+
+#include "filesystem.h"
+
+namespace {
+/**
+ * Reads the whole file, `error` is the zlib error at the end of the stream. The CRC-32 and the size in the gzip
+ * trailer are checked when the end of the stream is reached.
+ */
+auto readGz(const fs::path& file, int& error) -> std::string {
+    std::string result;
+    error = Z_ERRNO;
+    gzFile fp = gzopen(file.u8string().c_str(), "rb");
+    if (!fp) {
+        return result;
+    }
+
+    char buffer[4096];
+    int len = 0;
+    while ((len = gzread(fp, buffer, sizeof(buffer))) > 0) { result.append(buffer, len); }
+    gzerror(fp, &error);
+    if (error == Z_OK && (len < 0 || !gzeof(fp))) {
+        error = Z_DATA_ERROR;
+    }
+
+    int closeError = gzclose(fp);
+    if (error == Z_OK) {
+        error = closeError;
+    }
+    return result;
+}
+
+auto createData(size_t size) -> std::string {
+    std::string data;
+    for (size_t i = 0; data.size() < size; i++) {
+        data += "<stroke tool=\"pen\">" + std::to_string(i * 7 % 1000) + " " + std::to_string(i % 997) + "</stroke>\n";
+    }
+    data.resize(size);
+    return data;
+}
+
+void checkRoundTrip(size_t size, size_t threads, int level) {
+    fs::path file = Util::getTmpDirSubfolder("gz-test") / "test.gz";
+    std::string data = createData(size);
+    {
+        GzOutputStream out(file, level, threads);
+        ASSERT_TRUE(out.getLastError().empty());
+        // Unaligned writes, to cross the block boundaries
+        for (size_t pos = 0; pos < data.size(); pos += 7777) {
+            out.write(data.data() + pos, static_cast<int>(std::min<size_t>(7777, data.size() - pos)));
+        }
+        out.close();
+        EXPECT_TRUE(out.getLastError().empty());
+    }
+    int error = Z_OK;
+    EXPECT_EQ(data, readGz(file, error));
+    EXPECT_EQ(Z_OK, error);
+}
+}  // namespace
+
+TEST(UtilGzOutputStream, testEmpty) { checkRoundTrip(0, 4, Z_DEFAULT_COMPRESSION); }
+
+TEST(UtilGzOutputStream, testSingleBlock) { checkRoundTrip(1000, 4, Z_DEFAULT_COMPRESSION); }
+
+TEST(UtilGzOutputStream, testSingleThread) { checkRoundTrip(1000000, 1, Z_DEFAULT_COMPRESSION); }
+
+TEST(UtilGzOutputStream, testParallel) {
+    checkRoundTrip(3000000, 4, Z_DEFAULT_COMPRESSION);
+    checkRoundTrip(3000000, 3, 1);
+    checkRoundTrip(3000000, 2, 0);
+}
+
+TEST(UtilGzOutputStream, testTrailerIsChecked) {
+    fs::path file = Util::getTmpDirSubfolder("gz-test") / "trailer.gz";
+    std::string data = createData(1000000);
+    {
+        GzOutputStream out(file, Z_DEFAULT_COMPRESSION, 4);
+        out.write(data.data(), static_cast<int>(data.size()));
+        out.close();
+    }
+
+    // Corrupt the CRC-32 of the trailer, the data itself is still readable
+    {
+        std::fstream f(file, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekg(-8, std::ios::end);
+        char c = static_cast<char>(f.get());
+        f.seekp(-8, std::ios::end);
+        f.put(static_cast<char>(c ^ 0x01));
+    }
+
+    int error = Z_OK;
+    readGz(file, error);
+    EXPECT_NE(Z_OK, error);
+}
+
+TEST(UtilGzOutputStream, testCompressionError) {
+    fs::path file = Util::getTmpDirSubfolder("gz-test") / "invalid.gz";
+    std::string data = createData(1000);
+
+    // zlib rejects the level
+    GzOutputStream out(file, 42, 1);
+    out.write(data.data(), static_cast<int>(data.size()));
+    out.close();
+    EXPECT_FALSE(out.getLastError().empty());
+}
@@ -1,4 +1,5 @@
 #include <array>
+#include <chrono>
 #include <random>
 #include <string>
 #include <tuple>
@@ -123,6 +124,36 @@ TEST(UtilObjectIOStream, testReadImage) {
     cairo_surface_destroy(outputSurface);
 }
 
+TEST(UtilObjectIOStream, testReadImageData) {
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 40, 30);
+    std::string png;
+    cairo_surface_write_to_png_stream(
+            surface,
+            [](void* closure, const unsigned char* data, unsigned int length) {
+                static_cast<std::string*>(closure)->append(reinterpret_cast<const char*>(data), length);
+                return CAIRO_STATUS_SUCCESS;
+            },
+            &png);
+    cairo_surface_destroy(surface);
+
+    ObjectOutputStream outStream(new BinObjectEncoding);
+    outStream.writeImageData(png);
+    outStream.writeImageData(png);
+    auto outStr = outStream.getStr();
+    std::string str{outStr->str, outStr->len};
+
+    ObjectInputStream stream;
+    EXPECT_TRUE(stream.read(&str[0], (int)str.size() + 1));
+
+    // Written data is compatible with writeImage()
+    EXPECT_EQ(png, stream.readImageData());
+
+    cairo_surface_t* outputSurface = stream.readImage();
+    EXPECT_EQ(40, cairo_image_surface_get_width(outputSurface));
+    EXPECT_EQ(30, cairo_image_surface_get_height(outputSurface));
+    cairo_surface_destroy(outputSurface);
+}
+
 TEST(UtilObjectIOStream, testReadString) {
     std::vector<std::string> stringToTest{
             "", "Hello World", XML_VERSION_STR, "1337",
@@ -343,3 +374,76 @@ TEST(UtilObjectIOStream, testReadStroke) {
         FAIL();
     }
 }
+
+TEST(UtilObjectIOStream, testReadDataVector) {
+    std::vector<double> data{0., 42., -42., 1e50};
+
+    ObjectOutputStream outStream(new BinObjectEncoding);
+    outStream.writeData(data);
+    outStream.writeData(std::vector<double>{});
+    outStream.writeData(data);
+    auto outStr = outStream.getStr();
+    std::string str{outStr->str, outStr->len};
+    g_string_free(outStr, true);
+
+    ObjectInputStream stream;
+    EXPECT_TRUE(stream.read(&str[0], (int)str.size()));
+
+    std::vector<double> output{1., 2.};
+    stream.readData(output);
+    EXPECT_EQ(data, output);
+
+    stream.readData(output);
+    EXPECT_TRUE(output.empty());
+
+    // The element size is checked
+    std::vector<float> wrongType;
+    EXPECT_THROW(stream.readData(wrongType), InputStreamException);
+}
+
+TEST(UtilObjectIOStream, testTruncatedData) {
+    std::vector<Point> points(100, Point(1, 2, 3));
+    ObjectOutputStream outStream(new BinObjectEncoding);
+    outStream.writeData(points);
+    auto outStr = outStream.getStr();
+    std::string str{outStr->str, outStr->len - 1};
+    g_string_free(outStr, true);
+
+    ObjectInputStream stream;
+    EXPECT_TRUE(stream.read(&str[0], (int)str.size()));
+    EXPECT_THROW(stream.readData(points), InputStreamException);
+}
+
+TEST(UtilObjectIOStream, testLargeStroke) {
+    // Copy and paste of large selections goes through this path, it has to stay linear in the number of points
+    constexpr size_t POINT_COUNT = 1000000;
+
+    Stroke stroke;
+    stroke.setWidth(1.5);
+    for (size_t i = 0; i < POINT_COUNT; i++) {
+        stroke.addPoint(Point(static_cast<double>(i), static_cast<double>(i % 1000), 0.5));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ObjectOutputStream outStream(new BinObjectEncoding);
+    outStream.reserve(POINT_COUNT * sizeof(Point) + 1024);
+    stroke.serialize(outStream);
+    GString* outStr = outStream.getStr();
+    auto serialized = std::chrono::steady_clock::now();
+
+    ObjectInputStream stream;
+    ASSERT_TRUE(stream.read(outStr->str, (int)outStr->len));
+    Stroke in_stroke;
+    in_stroke.readSerialized(stream);
+    auto deserialized = std::chrono::steady_clock::now();
+
+    using ms = std::chrono::milliseconds;
+    RecordProperty("serializeMs", static_cast<int>(std::chrono::duration_cast<ms>(serialized - start).count()));
+    RecordProperty("deserializeMs", static_cast<int>(std::chrono::duration_cast<ms>(deserialized - serialized).count()));
+
+    EXPECT_GE(outStr->len, POINT_COUNT * sizeof(Point));
+    g_string_free(outStr, true);
+
+    ASSERT_EQ(POINT_COUNT, static_cast<size_t>(in_stroke.getPointCount()));
+    assertStrokeEquality(stroke, in_stroke);
+}
@@ -0,0 +1,104 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <utility>
+
+#include <cairo.h>
+#include <gtest/gtest.h>
+
+#include "util/RasterCache.h"
+
+namespace {
+constexpr size_t SIZE = 64 * 64 * 4;
+
+class RasterCacheTest: public ::testing::Test {
+protected:
+    void SetUp() override { surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 64, 64); }
+
+    void TearDown() override {
+        RasterBudget::getInstance().setMemoryLimit(RasterBudget::DEFAULT_MEMORY_LIMIT);
+        cairo_surface_destroy(surface);
+    }
+
+    template <typename Key>
+    static bool contains(RasterCache<Key>& cache, const Key& key) {
+        cairo_surface_t* cached = cache.get(key);
+        if (!cached) {
+            return false;
+        }
+        cairo_surface_destroy(cached);
+        return true;
+    }
+
+    cairo_surface_t* surface = nullptr;
+};
+}  // namespace
+
+TEST_F(RasterCacheTest, testSharedBudget) {
+    RasterCache<int> first;
+    RasterCache<std::pair<int, int>> second;
+
+    RasterBudget::getInstance().setMemoryLimit(2 * SIZE);
+    first.insert(1, surface);
+    second.insert({1, 1}, surface);
+    EXPECT_EQ(SIZE, first.getMemoryUsage());
+    EXPECT_EQ(SIZE, second.getMemoryUsage());
+
+    // The least recently used surface of any cache is dropped
+    EXPECT_TRUE(contains(first, 1));
+    second.insert({2, 2}, surface);
+    EXPECT_EQ(SIZE, first.getMemoryUsage());
+    EXPECT_EQ(SIZE, second.getMemoryUsage());
+    EXPECT_FALSE(contains(second, std::pair(1, 1)));
+
+    first.clear();
+    EXPECT_EQ(SIZE, second.getMemoryUsage());
+}
+
+TEST_F(RasterCacheTest, testColdInsert) {
+    RasterCache<int> cache;
+
+    RasterBudget::getInstance().setMemoryLimit(SIZE);
+    cache.insert(1, surface, true);
+    EXPECT_EQ(SIZE, cache.getMemoryUsage());
+
+    // The cold surface is dropped first, the one just inserted is kept
+    cache.insert(2, surface);
+    EXPECT_FALSE(contains(cache, 1));
+    EXPECT_TRUE(contains(cache, 2));
+}
+
+TEST_F(RasterCacheTest, testReplaceAndRemove) {
+    RasterCache<std::pair<int, int>> cache;
+
+    cache.insert({1, 0}, surface);
+    cache.insert({1, 0}, surface);
+    EXPECT_EQ(SIZE, cache.getMemoryUsage());
+
+    cache.insert({1, 1}, surface);
+    cache.insert({2, 0}, surface);
+    cache.removeRange({1, 0}, {1, 1});
+    EXPECT_EQ(SIZE, cache.getMemoryUsage());
+    EXPECT_TRUE(contains(cache, std::pair(2, 0)));
+
+    cache.remove({2, 0});
+    EXPECT_EQ(0U, cache.getMemoryUsage());
+}
+
+TEST_F(RasterCacheTest, testDestructorReleasesBudget) {
+    size_t before = RasterBudget::getInstance().getMemoryUsage();
+    {
+        RasterCache<int> cache;
+        cache.insert(1, surface);
+        EXPECT_EQ(before + SIZE, RasterBudget::getInstance().getMemoryUsage());
+    }
+    EXPECT_EQ(before, RasterBudget::getInstance().getMemoryUsage());
+}
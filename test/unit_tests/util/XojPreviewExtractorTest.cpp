@@ -11,16 +11,83 @@
 
 #include <cstdlib>
 #include <ctime>
+#include <string>
+#include <system_error>
 
+#include <glib.h>
 #include <gtest/gtest.h>
+#include <zlib.h>
 
 #include "util/XojPreviewExtractor.h"
 
 #include "config-test.h"
+#include "filesystem.h"
 
 
 using namespace std;
 
+namespace {
+/**
+ * Writes gzip compressed documents into a temporary folder, which is removed afterwards
+ */
+class XojPreviewExtractorGz: public ::testing::Test {
+protected:
+    void SetUp() override {
+        gchar* dir = g_dir_make_tmp("xournalpp-preview-test-XXXXXX", nullptr);
+        ASSERT_NE(nullptr, dir);
+        this->folder = fs::u8path(dir);
+        g_free(dir);
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        fs::remove_all(this->folder, ec);
+    }
+
+    auto writeGz(const std::string& name, const std::string& content) -> fs::path {
+        fs::path file = this->folder / name;
+        gzFile fp = gzopen(file.u8string().c_str(), "wb");
+        gzwrite(fp, content.data(), static_cast<unsigned int>(content.length()));
+        gzclose(fp);
+        return file;
+    }
+
+    /**
+     * @param previewStart Offset of the <preview> tag in the uncompressed file
+     * @param preview The raw preview data, it is base64 encoded
+     */
+    static auto createDocument(size_t previewStart, const std::string& preview) -> std::string {
+        std::string doc = "<?xml version=\"1.0\" standalone=\"no\"?>\n<xournal creator=\"test\">\n<title>";
+        doc.append(previewStart - doc.length() - std::string("</title>\n").length(), 'x');
+        doc += "</title>\n";
+
+        gchar* base64 = g_base64_encode(reinterpret_cast<const guchar*>(preview.data()), preview.length());
+        doc += "<preview>";
+        doc += base64;
+        doc += "</preview>\n";
+        g_free(base64);
+
+        doc += "<page width=\"612\" height=\"792\">\n</page>\n</xournal>\n";
+        return doc;
+    }
+
+    /**
+     * Data which does not compress well, so the compressed file is about as long as the document
+     */
+    static auto createPreview(size_t length) -> std::string {
+        std::string preview(length, 0);
+        unsigned int state = 1;
+        for (char& c: preview) {
+            state = state * 1103515245 + 12345;
+            c = static_cast<char>(state >> 16);
+        }
+        return preview;
+    }
+
+    fs::path folder;
+};
+}  // namespace
+
 
 TEST(UtilXojPreviewExtractor, testNonExistingFile) {
     XojPreviewExtractor extractor;
@@ -104,3 +171,38 @@ TEST(UtilXojPreviewExtractor, testInvalidFile) {
 
     EXPECT_EQ(PREVIEW_RESULT_ERROR_READING_PREVIEW, result);
 }
+
+TEST_F(XojPreviewExtractorGz, testPreviewAcrossChunks) {
+    // The files are read in chunks of 8192 bytes, the tag and the data of the preview are split by their boundaries
+    std::string preview = createPreview(20000);
+    fs::path file = writeGz("split.xoj", createDocument(8188, preview));
+
+    XojPreviewExtractor extractor;
+    EXPECT_EQ(PREVIEW_RESULT_IMAGE_READ, extractor.readFile(file));
+
+    gsize dataLen = 0;
+    unsigned char* imageData = extractor.getData(dataLen);
+    EXPECT_EQ(preview, string(reinterpret_cast<char*>(imageData), dataLen));
+}
+
+TEST_F(XojPreviewExtractorGz, testNoPreviewGzipped) {
+    std::string doc = "<?xml version=\"1.0\" standalone=\"no\"?>\n<xournal creator=\"test\">\n<title>";
+    doc.append(10000, 'x');
+    doc += "</title>\n<page width=\"612\" height=\"792\">\n</page>\n</xournal>\n";
+    fs::path file = writeGz("no-preview.xoj", doc);
+
+    XojPreviewExtractor extractor;
+    EXPECT_EQ(PREVIEW_RESULT_NO_PREVIEW, extractor.readFile(file));
+}
+
+TEST_F(XojPreviewExtractorGz, testTruncatedGzip) {
+    fs::path file = writeGz("truncated.xoj", createDocument(200, createPreview(30000)));
+
+    // Cut off the end of the preview
+    std::error_code ec;
+    fs::resize_file(file, fs::file_size(file) / 2, ec);
+    ASSERT_FALSE(ec);
+
+    XojPreviewExtractor extractor;
+    EXPECT_EQ(PREVIEW_RESULT_ERROR_READING_PREVIEW, extractor.readFile(file));
+}
@@ -0,0 +1,124 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "util/RasterCache.h"
+#include "view/background/BackgroundRasterCache.h"
+
+namespace {
+auto makeKey(double scale) -> BackgroundRasterCache::Key {
+    return {PageTypeFormat::Lined, "", 100, 200, Color(0xffffffU), 1, scale, scale};
+}
+}  // namespace
+
+TEST(ViewBackgroundRasterCache, testSharedRaster) {
+    BackgroundRasterCache& cache = BackgroundRasterCache::getInstance();
+    cache.clear();
+
+    int painted = 0;
+    auto paint = [&painted](cairo_t* cr) {
+        painted++;
+        cairo_paint(cr);
+    };
+
+    cairo_surface_t* first = cache.get(makeKey(1), paint);
+    cairo_surface_t* second = cache.get(makeKey(1), paint);
+    EXPECT_EQ(1, painted);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(100, cairo_image_surface_get_width(first));
+    EXPECT_EQ(200, cairo_image_surface_get_height(first));
+
+    // Another zoom level needs another raster
+    cairo_surface_t* zoomed = cache.get(makeKey(2), paint);
+    EXPECT_EQ(2, painted);
+    EXPECT_EQ(200, cairo_image_surface_get_width(zoomed));
+
+    cairo_surface_destroy(first);
+    cairo_surface_destroy(second);
+    cairo_surface_destroy(zoomed);
+    cache.clear();
+}
+
+TEST(ViewBackgroundRasterCache, testMemoryLimit) {
+    BackgroundRasterCache& cache = BackgroundRasterCache::getInstance();
+    cache.clear();
+
+    // A raster may take an eighth of the budget
+    RasterBudget& budget = RasterBudget::getInstance();
+    budget.setMemoryLimit(8 * 100 * 200 * 4);
+    EXPECT_TRUE(BackgroundRasterCache::fits(makeKey(1)));
+    EXPECT_FALSE(BackgroundRasterCache::fits(makeKey(2)));
+
+    // Room for exactly two 100x200 rasters
+    budget.setMemoryLimit(2 * 100 * 200 * 4);
+
+    int painted = 0;
+    auto paint = [&painted](cairo_t*) { painted++; };
+
+    auto key1 = makeKey(1);
+    auto key2 = makeKey(1);
+    key2.backgroundColor = Color(0x000000U);
+    auto key3 = makeKey(1);
+    key3.config = "r1=10";
+
+    cairo_surface_destroy(cache.get(key1, paint));
+    cairo_surface_destroy(cache.get(key2, paint));
+    cairo_surface_destroy(cache.get(key1, paint));
+    EXPECT_EQ(2, painted);
+
+    // key2 is the least recently used one and is dropped
+    cairo_surface_destroy(cache.get(key3, paint));
+    EXPECT_EQ(2U * 100 * 200 * 4, cache.getMemoryUsage());
+    cairo_surface_destroy(cache.get(key1, paint));
+    EXPECT_EQ(3, painted);
+    cairo_surface_destroy(cache.get(key2, paint));
+    EXPECT_EQ(4, painted);
+
+    budget.setMemoryLimit(RasterBudget::DEFAULT_MEMORY_LIMIT);
+    cache.clear();
+}
+
+TEST(ViewBackgroundRasterCache, testPaintsWithoutLock) {
+    BackgroundRasterCache& cache = BackgroundRasterCache::getInstance();
+    cache.clear();
+
+    std::atomic<bool> otherPainted = false;
+    std::atomic<int> painted = 0;
+    bool paintedMeanwhile = false;
+
+    // Only finishes once another raster was painted meanwhile, which needs the lock of the cache
+    std::thread slow([&]() {
+        cairo_surface_destroy(cache.get(makeKey(1), [&](cairo_t*) {
+            painted++;
+            auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (!otherPainted && std::chrono::steady_clock::now() < timeout) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            paintedMeanwhile = otherPainted;
+        }));
+    });
+    while (painted == 0) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+
+    cairo_surface_destroy(cache.get(makeKey(2), [&](cairo_t*) { otherPainted = true; }));
+
+    // The same raster waits for the running paint instead of painting it again
+    cairo_surface_destroy(cache.get(makeKey(1), [&](cairo_t*) { painted++; }));
+    slow.join();
+
+    EXPECT_TRUE(paintedMeanwhile);
+    EXPECT_EQ(1, painted);
+    cache.clear();
+}